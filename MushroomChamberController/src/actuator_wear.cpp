@@ -0,0 +1,192 @@
+#include "actuator_wear.h"
+#include "controller_store.h"
+#include "hal/hal.h"
+#include <Arduino.h>
+#include <atomic>
+
+// Stored layout; the CRC covers everything before it and follows the last
+// stored counter, so shorter blobs from older firmware stay readable
+struct WearBlob {
+  uint16_t version;
+  uint16_t payloadSize;
+  ActuatorWear wear[ACTUATOR_COUNT];
+  uint32_t crc;
+};
+
+// --- Counter State ---
+struct WearCounter {
+  ActuatorWear total;
+  uint32_t onRemainderMs;     // Below a whole second, carried to the next on-period
+  bool on;
+  unsigned long onSince;
+};
+
+static WearCounter counters[ACTUATOR_COUNT];
+static unsigned long lastSave = 0;
+
+// The control task switches the counters on one core while the comms task
+// reads them for uploads on the other; a torn copy is retried, as with the
+// control tick stats
+static std::atomic<uint32_t> sequence(0);
+
+static void beginWrite() {
+  sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+static void endWrite() {
+  sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// Filled by the control task while staged is clear, then owned by the writer
+static WearBlob stagedBlob;
+static std::atomic<bool> staged(false);
+
+// --- Counter Functions ---
+void wearRecordSwitch(ActuatorId actuator, bool on, unsigned long now) {
+  if (actuator >= ACTUATOR_COUNT || on == counters[actuator].on) {
+    return;
+  }
+  WearCounter& counter = counters[actuator];
+  beginWrite();
+  if (on) {
+    counter.total.cycles++;
+    counter.onSince = now;
+  } else {
+    uint32_t onMs = counter.onRemainderMs + (now - counter.onSince);
+    counter.total.onSeconds += onMs / 1000;
+    counter.onRemainderMs = onMs % 1000;
+  }
+  counter.on = on;
+  endWrite();
+}
+
+ActuatorWear getActuatorWear(ActuatorId actuator, unsigned long now) {
+  if (actuator >= ACTUATOR_COUNT) {
+    return ActuatorWear();
+  }
+  WearCounter counter;
+  uint32_t before;
+  do {
+    before = sequence.load(std::memory_order_acquire);
+    counter = counters[actuator];
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while ((before & 1) != 0 || sequence.load(std::memory_order_relaxed) != before);
+
+  ActuatorWear wear = counter.total;
+  if (counter.on) {
+    wear.onSeconds += (counter.onRemainderMs + (now - counter.onSince)) / 1000;
+  }
+  return wear;
+}
+
+const char* actuatorName(ActuatorId actuator) {
+  switch (actuator) {
+    case ACTUATOR_HUMIDIFIER: return "humidifier";
+    case ACTUATOR_EXHAUST_FAN_1: return "exhaust_fan_1";
+    case ACTUATOR_EXHAUST_FAN_2: return "exhaust_fan_2";
+    case ACTUATOR_INLET_FAN: return "inlet_fan";
+    case ACTUATOR_HEATER: return "heater";
+    case ACTUATOR_COOLER: return "cooler";
+    default: return "unknown";
+  }
+}
+
+// --- Store Functions ---
+static uint32_t blobCrc(const WearBlob& blob) {
+  return crc32((const uint8_t*)&blob, offsetof(WearBlob, crc));
+}
+
+bool loadActuatorWear() {
+  WearBlob blob;
+  size_t read = halNvsRead(ACTUATOR_WEAR_KEY, &blob, sizeof(blob));
+  if (read == 0) {
+    return false;   // New board
+  }
+
+  // Header, any number of counters up to ACTUATOR_COUNT, then the CRC
+  size_t header = offsetof(WearBlob, wear);
+  bool sizeValid = read >= header && blob.payloadSize > header &&
+                   blob.payloadSize + sizeof(uint32_t) == read &&
+                   (blob.payloadSize - header) % sizeof(ActuatorWear) == 0;
+  uint32_t crc = 0;
+  if (sizeValid) {
+    memcpy(&crc, (const uint8_t*)&blob + blob.payloadSize, sizeof(crc));
+  }
+  if (!sizeValid || blob.version != ACTUATOR_WEAR_VERSION ||
+      crc != crc32((const uint8_t*)&blob, blob.payloadSize)) {
+    // Kept, not erased: the next save overwrites it with fresh counts
+    Serial.println("⚠️  Actuator wear counters unreadable - counting from zero");
+    return false;
+  }
+
+  // Loaded at setup, before the drivers switch anything
+  size_t stored = (blob.payloadSize - header) / sizeof(ActuatorWear);
+  beginWrite();
+  for (int i = 0; i < ACTUATOR_COUNT; i++) {
+    counters[i].total = i < (int)stored ? blob.wear[i] : ActuatorWear();
+    counters[i].onRemainderMs = 0;
+  }
+  endWrite();
+  return true;
+}
+
+bool isActuatorWearSaveDue(unsigned long now) {
+  return now - lastSave >= ACTUATOR_WEAR_INTERVAL_MS;
+}
+
+bool stageActuatorWear(unsigned long now) {
+  if (staged.load(std::memory_order_acquire)) {
+    return false;
+  }
+  lastSave = now;
+
+  WearBlob& blob = stagedBlob;
+  memset(&blob, 0, sizeof(blob));
+  blob.version = ACTUATOR_WEAR_VERSION;
+  blob.payloadSize = sizeof(blob) - sizeof(blob.crc);
+  for (int i = 0; i < ACTUATOR_COUNT; i++) {
+    blob.wear[i] = getActuatorWear((ActuatorId)i, now);
+  }
+  blob.crc = blobCrc(blob);
+  staged.store(true, std::memory_order_release);
+  return true;
+}
+
+bool writeStagedActuatorWear() {
+  if (!staged.load(std::memory_order_acquire)) {
+    return true;
+  }
+  bool written = halNvsWrite(ACTUATOR_WEAR_KEY, &stagedBlob, sizeof(stagedBlob));
+  if (!written) {
+    Serial.println("❌ Actuator wear write failed");
+  }
+  staged.store(false, std::memory_order_release);
+  return written;
+}
+
+bool saveActuatorWear(unsigned long now) {
+  writeStagedActuatorWear();
+  return stageActuatorWear(now) && writeStagedActuatorWear();
+}
+
+void clearActuatorWear() {
+  staged.store(false, std::memory_order_release);
+  halNvsErase(ACTUATOR_WEAR_KEY);
+  beginWrite();
+  for (int i = 0; i < ACTUATOR_COUNT; i++) {
+    counters[i] = WearCounter();
+  }
+  endWrite();
+}
+
+void printActuatorWearStatus() {
+  unsigned long now = millis();
+  Serial.println("\n========== Actuator Wear ==========");
+  for (int i = 0; i < ACTUATOR_COUNT; i++) {
+    ActuatorWear wear = getActuatorWear((ActuatorId)i, now);
+    Serial.printf("%-14s %lu cycles, %.1f h on\n", actuatorName((ActuatorId)i),
+                  (unsigned long)wear.cycles, wear.onSeconds / 3600.0f);
+  }
+  Serial.println("===================================");
+}
@@ -0,0 +1,48 @@
+#ifndef ACTUATOR_WEAR_H
+#define ACTUATOR_WEAR_H
+
+#include <stdint.h>
+
+// Lifetime switch and on-time counters for every actuator. The drivers
+// report each on/off edge; the totals survive reboots in NVS under their
+// own key, so clearing the learned controller state never resets them.
+// New actuators are only ever appended to ActuatorId: a blob written by
+// older firmware holds a prefix of the array and the rest start at zero.
+// Like the controller checkpoint, the control task stages the counters and
+// a lower-priority task does the NVS write.
+
+#define ACTUATOR_WEAR_KEY         "wear"
+#define ACTUATOR_WEAR_VERSION     1
+#define ACTUATOR_WEAR_INTERVAL_MS 1800000UL   // Same cadence as the controller checkpoint
+
+enum ActuatorId {
+  ACTUATOR_HUMIDIFIER,
+  ACTUATOR_EXHAUST_FAN_1,     // Then the fans in FanId order
+  ACTUATOR_EXHAUST_FAN_2,
+  ACTUATOR_INLET_FAN,
+  ACTUATOR_HEATER,
+  ACTUATOR_COOLER,
+  ACTUATOR_COUNT
+};
+
+struct ActuatorWear {
+  uint32_t cycles;            // Off→on switches
+  uint32_t onSeconds;
+};
+
+// --- Counter Functions ---
+void wearRecordSwitch(ActuatorId actuator, bool on, unsigned long now);
+ActuatorWear getActuatorWear(ActuatorId actuator, unsigned long now);   // Includes a running on-period; safe from either task
+const char* actuatorName(ActuatorId actuator);
+
+// --- Store Functions ---
+bool loadActuatorWear();
+bool isActuatorWearSaveDue(unsigned long now);
+bool stageActuatorWear(unsigned long now);   // False while the last one is still pending
+bool writeStagedActuatorWear();
+bool saveActuatorWear(unsigned long now);    // Stage and write
+void clearActuatorWear();   // Counters and the stored copy; for tests and replaced hardware
+
+void printActuatorWearStatus();
+
+#endif
@@ -1,34 +1,29 @@
 #include "actuators.h"
 #include "config.h"
+#include "sensor_fusion.h"
+#include "humidity_pid.h"
+#include "relay_autotune.h"
+#include "fan_driver.h"
+#include "ventilation_modes.h"
+#include "humidifier_driver.h"
+#include "actuator_wear.h"
+#include "thermal_outputs.h"
+#include "temperature_control.h"
+#include "hal/hal.h"
 #include <Arduino.h>
 
-// --- Pin Definitions ---
-#define EXHAUST_FAN1_PIN 13
-#define EXHAUST_FAN2_PIN 12
-#define INLET_FAN_PIN 14
-#define HUMIDIFIER_PIN 15
-
 // --- Global Configuration ---
 extern GrowthPhase currentPhase;
 extern PhaseConfig activePhaseConfig;
 
-// --- Controller States ---
-enum ControllerState {
-  HUMIDIFYING,      // Building up humidity
-  STABILIZING,      // Letting system settle
-  VENTILATING,      // Fresh air exchange
-  RECOVERING        // Rebuilding after ventilation
-};
-
 // --- Adaptive Controller ---
 struct AdaptiveController {
   // Current state
   ControllerState state = STABILIZING;
   unsigned long stateStartTime = 0;
   
-  // Actuator states
-  bool humidifierOn = false;
-  bool fansOn = false;
+  // Commanded actuator states
+  float fanDuties[FAN_COUNT] = {};          // Commanded; the driver ramps towards them
   
   // Adaptive parameters (will self-tune)
   float humidityOvershoot = 3.0f;           // How much to overshoot target
@@ -43,6 +38,7 @@ struct AdaptiveController {
   float humidityAfterVentilation = 0.0f;
   float humidityBuildRate = 0.0f;           // %RH per second
   float humidityDecayRate = 0.0f;           // %RH per second
+  VentilationMode ventilationMode = VentilationMode::BALANCED;   // Of the current or last ventilation
   
   // Safety limits
   float criticalLowHumidity = 70.0f;        // Emergency humidify threshold
@@ -57,28 +53,123 @@ struct AdaptiveController {
   float filteredHumidity = 0.0f;
   float lastHumidity = 0.0f;
   bool firstReading = true;
+  unsigned long lastValidInput = 0;         // Last step with both humidity and temperature
+  
+  // PID mode
+  PidController pid;
+  float humidifierDuty = 0.0f;
+  
+  // Continuous air exchange
+  TimeProportioner exchangeWindow;
+  
+  // Temperature loop output, arbitrated against humidity
+  ThermalDemand thermal = {};
+  
+  // Phase whose autotune results are loaded, -1 to reload
+  int tunedPhase = -1;
+  bool tuningApplied = false;               // Overshoot and ventilation come from an autotune
+  float untunedOvershoot = 3.0f;            // What was learned without one, for untuned phases
+  unsigned long untunedVentilationDuration = 30000;
 } controller;
 
+static ControlMode controlMode = ControlMode::BANG_BANG;
+static VentilationStyle ventilationStyle = VentilationStyle::BURST;
+
+// Input is already decimated from 10 Hz samples, so the EMA only has to
+// take the edge off and can follow the chamber more closely
+#define HUMIDITY_FILTER_ALPHA 0.5f
+
+// A step after a longer stall is not integrated as if control had been
+// running all along
+#define CONTROL_MAX_DT_SEC 5.0f
+
+// Open-loop cycle used while the sensor has failed: enough mist and fresh
+// air to keep the substrate alive without soaking the chamber
+#define FALLBACK_CYCLE_MS     600000  // 10 min
+#define FALLBACK_HUMIDIFY_MS  90000   // 15 % humidifier duty
+#define FALLBACK_VENTILATE_MS 30000   // Same length as a normal ventilation
+
+// A ventilation is meant to drop humidity by this fraction of the target
+#define VENTILATION_EXPECTED_DROP_FRACTION 0.15f
+
+// Feed-forward ahead of scheduled ventilation (PID mode)
+#define FEED_FORWARD_MIN_BUILD_RATE 0.01f    // %RH/s assumed until the build rate is learned
+#define FEED_FORWARD_MIN_LEAD_MS    60000
+#define FEED_FORWARD_MAX_LEAD_MS    600000
+
+// Continuous exchange: the fans idle at a low speed for part of each window,
+// moving the same air per interval as the bursts would at full speed
+#define CONTINUOUS_FAN_SPEED      0.3f
+#define CONTINUOUS_WINDOW_MS      300000  // 5 min
+#define CONTINUOUS_MIN_PULSE_MS   20000   // Not worth spinning the fans up for less
+
 // --- Simple exponential filter ---
 float filterValue(float newValue, float oldValue, float alpha = 0.3f) {
   return alpha * newValue + (1.0f - alpha) * oldValue;
 }
 
+// --- Persistence ---
+LearnedParameters getLearnedParameters() {
+  // Tunings are stored on their own and laid over these again on resume
+  LearnedParameters learned;
+  learned.humidityOvershoot = controller.tuningApplied ? controller.untunedOvershoot
+                                                       : controller.humidityOvershoot;
+  learned.humidifyDuration = controller.humidifyDuration;
+  learned.ventilationDuration = controller.tuningApplied ? controller.untunedVentilationDuration
+                                                         : controller.ventilationDuration;
+  learned.humidityBuildRate = controller.humidityBuildRate;
+  learned.humidityDecayRate = controller.humidityDecayRate;
+  learned.humidityBeforeVentilation = controller.humidityBeforeVentilation;
+  learned.humidityAfterVentilation = controller.humidityAfterVentilation;
+  learned.pidIntegral = controller.pid.integral;
+  learned.humidificationCycles = controller.humidificationCycles;
+  learned.ventilationCycles = controller.ventilationCycles;
+  learned.totalHumidifyTime = controller.totalHumidifyTime;
+  return learned;
+}
+
+static void restoreLearnedParameters(const LearnedParameters& learned) {
+  controller.humidityOvershoot = learned.humidityOvershoot;
+  controller.humidifyDuration = learned.humidifyDuration;
+  controller.ventilationDuration = learned.ventilationDuration;
+  controller.humidityBuildRate = learned.humidityBuildRate;
+  controller.humidityDecayRate = learned.humidityDecayRate;
+  controller.humidityBeforeVentilation = learned.humidityBeforeVentilation;
+  controller.humidityAfterVentilation = learned.humidityAfterVentilation;
+  controller.pid.integral = learned.pidIntegral;   // Bumpless restart at the old duty
+  controller.humidificationCycles = learned.humidificationCycles;
+  controller.ventilationCycles = learned.ventilationCycles;
+  controller.totalHumidifyTime = learned.totalHumidifyTime;
+}
+
 void setupActuators() {
   Serial.println("Initializing Adaptive State Controller...");
   
-  pinMode(EXHAUST_FAN1_PIN, OUTPUT);
-  pinMode(EXHAUST_FAN2_PIN, OUTPUT);
-  pinMode(INLET_FAN_PIN, OUTPUT);
-  pinMode(HUMIDIFIER_PIN, OUTPUT);
-  
-  digitalWrite(EXHAUST_FAN1_PIN, LOW);
-  digitalWrite(EXHAUST_FAN2_PIN, LOW);
-  digitalWrite(INLET_FAN_PIN, LOW);
-  digitalWrite(HUMIDIFIER_PIN, LOW);
+  setupFanDriver();
+  setupHumidifierDriver(humidifierDefaultLimits());
+  setupThermalOutputs();
+  temperatureControlReset();
+  if (loadActuatorWear()) {
+    ActuatorWear wear = getActuatorWear(ACTUATOR_HUMIDIFIER, millis());
+    Serial.printf("💾 Humidifier wear: %lu cycles, %.1f h on\n",
+                  (unsigned long)wear.cycles, wear.onSeconds / 3600.0f);
+  }
   
+  // Start from the untuned defaults, matching the outputs just driven low
+  controller = AdaptiveController();
   controller.stateStartTime = millis();
   controller.lastVentilationTime = millis();
+  controller.lastValidInput = millis();
+  pidReset(controller.pid, pidGainsForPhase(activePhaseConfig), 0.0f);
+  timeProportionReset(controller.exchangeWindow, CONTINUOUS_WINDOW_MS, CONTINUOUS_MIN_PULSE_MS, millis(), true);
+  
+  // Resume what earlier boots learned
+  LearnedParameters learned;
+  if (loadControllerCheckpoint(learned)) {
+    restoreLearnedParameters(learned);
+    Serial.printf("💾 Restored learned parameters (%d humidify / %d ventilation cycles)\n",
+                  controller.humidificationCycles, controller.ventilationCycles);
+  }
   
   Serial.println("✅ Adaptive controller initialized");
   Serial.printf("Initial parameters:\n");
@@ -87,22 +178,59 @@ void setupActuators() {
   Serial.printf("  Ventilation interval: %lu min\n", controller.ventilationInterval / 60000);
 }
 
+// Requests only: the driver holds the output to its minimum on/off times
 void setHumidifier(bool on) {
-  if (on != controller.humidifierOn) {
-    digitalWrite(HUMIDIFIER_PIN, on ? HIGH : LOW);
-    controller.humidifierOn = on;
-    Serial.printf("Humidifier: %s\n", on ? "ON" : "OFF");
+  requestHumidifier(on, millis());
+}
+
+static void setFanDuties(const float duties[FAN_COUNT]) {
+  bool changed = false;
+  bool anyOn = false;
+  for (int i = 0; i < FAN_COUNT; i++) {
+    float duty = constrain(duties[i], 0.0f, 1.0f);
+    if (duty != controller.fanDuties[i]) {
+      setFanTarget((FanId)i, duty);
+      controller.fanDuties[i] = duty;
+      changed = true;
+    }
+    anyOn = anyOn || duty > 0.0f;
+  }
+  if (!changed) {
+    return;
+  }
+  if (anyOn) {
+    Serial.printf("Fans: exhaust %.0f%%/%.0f%%, inlet %.0f%%\n", controller.fanDuties[FAN_EXHAUST_1] * 100.0f,
+                  controller.fanDuties[FAN_EXHAUST_2] * 100.0f, controller.fanDuties[FAN_INLET] * 100.0f);
+  } else {
+    Serial.println("Fans: OFF");
   }
 }
 
-void setFans(bool on) {
-  if (on != controller.fansOn) {
-    digitalWrite(EXHAUST_FAN1_PIN, on ? HIGH : LOW);
-    digitalWrite(EXHAUST_FAN2_PIN, on ? HIGH : LOW);
-    digitalWrite(INLET_FAN_PIN, on ? HIGH : LOW);
-    controller.fansOn = on;
-    Serial.printf("Fans: %s\n", on ? "ON (all)" : "OFF");
+void setFanSpeed(float speed) {
+  float duties[FAN_COUNT];
+  for (int i = 0; i < FAN_COUNT; i++) {
+    duties[i] = speed;
   }
+  setFanDuties(duties);
+}
+
+void setFanSpeed(FanId fan, float speed) {
+  if (fan < FAN_COUNT) {
+    float duties[FAN_COUNT];
+    memcpy(duties, controller.fanDuties, sizeof(duties));
+    duties[fan] = speed;
+    setFanDuties(duties);
+  }
+}
+
+void setFans(bool on) {
+  setFanSpeed(on ? 1.0f : 0.0f);
+}
+
+static void setVentilationFans(VentilationMode mode, float speed) {
+  float duties[FAN_COUNT];
+  ventilationFanDuties(mode, speed, duties);
+  setFanDuties(duties);
 }
 
 const char* stateToString(ControllerState state) {
@@ -111,10 +239,21 @@ const char* stateToString(ControllerState state) {
     case STABILIZING: return "STABILIZING";
     case VENTILATING: return "VENTILATING";
     case RECOVERING: return "RECOVERING";
+    case SENSOR_FAULT: return "SENSOR_FAULT";
+    case REGULATING: return "REGULATING";
+    case AUTOTUNING: return "AUTOTUNING";
     default: return "UNKNOWN";
   }
 }
 
+const char* controlModeToString(ControlMode mode) {
+  return mode == ControlMode::PID ? "PID" : "BANG_BANG";
+}
+
+ControlMode stringToControlMode(const char* modeStr) {
+  return strcmp(modeStr, "PID") == 0 ? ControlMode::PID : ControlMode::BANG_BANG;
+}
+
 void changeState(ControllerState newState, float currentHumidity) {
   if (newState != controller.state) {
     Serial.printf("\n🔄 State: %s → %s\n", 
@@ -122,10 +261,11 @@ void changeState(ControllerState newState, float currentHumidity) {
                   stateToString(newState));
     
     // Record humidity at state transitions for learning
-    if (controller.state == STABILIZING && newState == VENTILATING) {
+    if ((controller.state == STABILIZING || controller.state == REGULATING) && newState == VENTILATING) {
       controller.humidityBeforeVentilation = currentHumidity;
+      controller.ventilationMode = selectVentilationMode(currentPhase, activePhaseConfig.ventilationMode);
     }
-    if (controller.state == VENTILATING && newState == RECOVERING) {
+    if (controller.state == VENTILATING && (newState == RECOVERING || newState == REGULATING)) {
       controller.humidityAfterVentilation = currentHumidity;
       controller.ventilationCycles++;
       
@@ -135,6 +275,13 @@ void changeState(ControllerState newState, float currentHumidity) {
                     controller.humidityBeforeVentilation,
                     controller.humidityAfterVentilation,
                     humidityDrop);
+      recordVentilation(currentPhase, controller.ventilationMode, humidityDrop,
+                        activePhaseConfig.targetHumidity * VENTILATION_EXPECTED_DROP_FRACTION,
+                        millis() - controller.stateStartTime);
+    }
+    
+    if (controller.state == AUTOTUNING) {
+      autotuneCancel();   // No-op once the experiment finished
     }
     
     controller.state = newState;
@@ -142,16 +289,131 @@ void changeState(ControllerState newState, float currentHumidity) {
   }
 }
 
-void updateActuators(float rawHumidity, float rawTemperature, float rawPressure) {
-  static unsigned long lastUpdate = 0;
+static void runFallbackDuty(unsigned long now) {
+  if (controller.state != SENSOR_FAULT) {
+    Serial.println("🚨 SENSOR FAILURE: ignoring readings - running fallback duty cycle");
+    changeState(SENSOR_FAULT, controller.filteredHumidity);
+  }
+
+  // Humidify at the start of each cycle, ventilate halfway through
+  unsigned long cyclePos = (now - controller.stateStartTime) % FALLBACK_CYCLE_MS;
+  setHumidifier(cyclePos < FALLBACK_HUMIDIFY_MS);
+  requestHeaterDuty(0.0f, now);   // No open-loop heating or cooling on a blind chamber
+  requestCoolerDuty(0.0f, now);
+  setFans(cyclePos >= FALLBACK_CYCLE_MS / 2 && cyclePos < FALLBACK_CYCLE_MS / 2 + FALLBACK_VENTILATE_MS);
+}
+
+// Fans between ventilations: off for bursts, otherwise a slow
+// time-proportioned trickle of the interval's air exchange, and on top
+// whatever the temperature loop won in its arbitration with humidity
+static void runBackgroundFans(unsigned long now) {
+  VentilationMode mode = selectVentilationMode(currentPhase, activePhaseConfig.ventilationMode);
+  float duties[FAN_COUNT] = {};
+  if (ventilationStyle == VentilationStyle::CONTINUOUS) {
+    float duty = (float)ventilationDurationFor(mode, controller.ventilationDuration) /
+                 controller.ventilationInterval / CONTINUOUS_FAN_SPEED;
+    ventilationFanDuties(mode, timeProportion(controller.exchangeWindow, duty, now) ? CONTINUOUS_FAN_SPEED : 0.0f,
+                         duties);
+  }
+  if (controller.thermal.ventilation > 0.0f) {
+    float thermalDuties[FAN_COUNT];
+    ventilationFanDuties(mode, controller.thermal.ventilation, thermalDuties);
+    for (int i = 0; i < FAN_COUNT; i++) {
+      duties[i] = max(duties[i], thermalDuties[i]);
+    }
+  }
+  setFanDuties(duties);
+}
+
+// Setpoint offset that pre-charges the chamber before a scheduled
+// ventilation, so it enters the flush high and leaves it low by about the
+// same margin instead of dropping out of the band
+static float ventilationFeedForward(unsigned long timeSinceVentilation) {
+  float expectedDrop = controller.humidityBeforeVentilation - controller.humidityAfterVentilation;
+  if (ventilationStyle != VentilationStyle::BURST) {
+    return 0.0f;   // No flush to get ahead of
+  }
+  if (controller.ventilationCycles == 0 || expectedDrop <= 0.0f) {
+    return 0.0f;   // Nothing learned yet
+  }
+  float offset = min(expectedDrop * 0.5f, activePhaseConfig.humidityTolerance * 0.5f);
+  
+  // Start early enough for the humidifier to build the offset at the learned
+  // rate, with a 2x margin since the PID rarely runs it at full duty
+  float buildRate = max(controller.humidityBuildRate, FEED_FORWARD_MIN_BUILD_RATE);
+  unsigned long leadMs = constrain((unsigned long)(2.0f * offset / buildRate * 1000.0f),
+                                   (unsigned long)FEED_FORWARD_MIN_LEAD_MS,
+                                   (unsigned long)FEED_FORWARD_MAX_LEAD_MS);
+  unsigned long untilVentilation = timeSinceVentilation < controller.ventilationInterval
+                                   ? controller.ventilationInterval - timeSinceVentilation : 0;
+  return untilVentilation <= leadMs ? offset : 0.0f;
+}
+
+// Loads the autotune results of the active phase, if it has been tuned,
+// or goes back to the untuned values when leaving a tuned phase
+static void applyPhaseTuning() {
+  if (controller.tunedPhase == (int)currentPhase) {
+    return;
+  }
+  controller.tunedPhase = currentPhase;
+  
+  const AutotuneResult* tuning = getPhaseTuning(currentPhase);
+  if (tuning != NULL) {
+    if (!controller.tuningApplied) {
+      controller.untunedOvershoot = controller.humidityOvershoot;
+      controller.untunedVentilationDuration = controller.ventilationDuration;
+      controller.tuningApplied = true;
+    }
+    controller.humidityOvershoot = tuning->humidityOvershoot;
+    controller.ventilationDuration = tuning->ventilationDuration;
+    Serial.printf("🎚️  Loaded phase tuning: overshoot %.1f%%, ventilation %lu sec\n",
+                  controller.humidityOvershoot, controller.ventilationDuration / 1000);
+  } else if (controller.tuningApplied) {
+    controller.humidityOvershoot = controller.untunedOvershoot;
+    controller.ventilationDuration = controller.untunedVentilationDuration;
+    controller.tuningApplied = false;
+    Serial.printf("🎚️  Phase not tuned: overshoot %.1f%%, ventilation %lu sec\n",
+                  controller.humidityOvershoot, controller.ventilationDuration / 1000);
+  }
+}
+
+void updateActuators(float rawHumidity, float rawTemperature, float rawPressure, float dtSec) {
   static unsigned long lastStatusLog = 0;
   unsigned long now = millis();
   
-  // Rate limit to once per second
-  if (now - lastUpdate < 1000) {
+  bool stalled = dtSec > CONTROL_MAX_DT_SEC;
+  dtSec = constrain(dtSec, 0.0f, CONTROL_MAX_DT_SEC);
+  updateFanDriver(now);
+  updateHumidifierDriver(now);
+  updateThermalOutputs(now);
+  
+  // Staged here, written to NVS by the comms task (writeStagedCheckpoints)
+  if (isControllerCheckpointDue(now)) {
+    stageControllerCheckpoint(getLearnedParameters(), now);
+  }
+  if (isActuatorWearSaveDue(now)) {
+    stageActuatorWear(now);
+  }
+  
+  // --- SENSOR FAULT HANDLING (before anything trusts the readings) ---
+  // A gap that outlasts the sensor timeout is a fault too, even when no
+  // health update ever said so (sensor missing from boot, no readings)
+  bool inputMissing = isnan(rawHumidity) || isnan(rawTemperature);
+  if (!inputMissing) {
+    controller.lastValidInput = now;
+  }
+  if (getFusedHealth() == SensorHealth::FAILED || now - controller.lastValidInput >= SENSOR_STALE_MS) {
+    runFallbackDuty(now);
     return;
   }
-  lastUpdate = now;
+  if (inputMissing) {
+    return; // Brief gap: hold the actuators until the next valid reading
+  }
+  if (controller.state == SENSOR_FAULT) {
+    Serial.printf("✅ Sensor recovered (%.1f%%) - resuming control\n", rawHumidity);
+    controller.firstReading = true;
+    changeState(STABILIZING, rawHumidity);
+  }
   
   // Filter humidity for stability
   if (controller.firstReading) {
@@ -159,14 +421,17 @@ void updateActuators(float rawHumidity, float rawTemperature, float rawPressure)
     controller.lastHumidity = rawHumidity;
     controller.firstReading = false;
   } else {
-    controller.filteredHumidity = filterValue(rawHumidity, controller.filteredHumidity, 0.2f);
+    controller.filteredHumidity = filterValue(rawHumidity, controller.filteredHumidity, HUMIDITY_FILTER_ALPHA);
   }
   
   float humidity = controller.filteredHumidity;
   float temperature = rawTemperature;
+  applyPhaseTuning();
   
   unsigned long timeInState = now - controller.stateStartTime;
   unsigned long timeSinceVentilation = now - controller.lastVentilationTime;
+  bool ventilationDue = ventilationStyle == VentilationStyle::BURST &&
+                        timeSinceVentilation > controller.ventilationInterval;
   
   float targetHumidity = activePhaseConfig.targetHumidity;
   float humidityError = targetHumidity - humidity;
@@ -174,13 +439,32 @@ void updateActuators(float rawHumidity, float rawTemperature, float rawPressure)
   // Calculate humidity change rate for learning
   float humidityDelta = humidity - controller.lastHumidity;
   controller.lastHumidity = humidity;
+  if (isHumidifierOutputOn() && !stalled && dtSec > 0.0f) {
+    controller.humidityBuildRate = filterValue(humidityDelta / dtSec, controller.humidityBuildRate, 0.05f);
+  }
+  
+  // --- TEMPERATURE LOOP ---
+  // Heater and cooler follow its demand directly; its fan request is only
+  // applied between ventilations, by runBackgroundFans()
+  controller.thermal = temperatureControlUpdate(activePhaseConfig, temperature, humidity,
+                                                hasHeater(), hasCooler(), controller.state != AUTOTUNING,
+                                                now, dtSec);
+  requestHeaterDuty(controller.thermal.heating, now);
+  requestCoolerDuty(controller.thermal.cooling, now);
   
   // --- EMERGENCY OVERRIDES (highest priority) ---
   
-  // Critical low humidity - force humidifier on
-  if (humidity < controller.criticalLowHumidity) {
+  // Critical low humidity - force humidifier on. Never inside the target
+  // band: low-humidity phases (e.g. 70 % incubation) would trip it constantly.
+  // The autotune relay already humidifies whenever it is below target.
+  float criticalLowHumidity = min(controller.criticalLowHumidity,
+                                  targetHumidity - activePhaseConfig.humidityTolerance);
+  if (humidity < criticalLowHumidity && controller.state != AUTOTUNING) {
     if (controller.state != HUMIDIFYING) {
       Serial.printf("🚨 EMERGENCY: Critical low humidity (%.1f%%) - forcing humidification\n", humidity);
+      if (controller.state == VENTILATING) {
+        controller.lastVentilationTime = now;   // Aborted, not retried until the next interval
+      }
       changeState(HUMIDIFYING, humidity);
     }
     setHumidifier(true);
@@ -194,18 +478,30 @@ void updateActuators(float rawHumidity, float rawTemperature, float rawPressure)
       Serial.printf("🚨 EMERGENCY: High temperature (%.1f°C) - forcing ventilation\n", temperature);
       changeState(VENTILATING, humidity);
     }
+    controller.ventilationMode = VentilationMode::BALANCED;   // All the air there is
     setHumidifier(false);
     setFans(true);
     return;
   }
   
+  // --- MODE HANDOVER ---
+  
+  if (controlMode == ControlMode::PID &&
+      (controller.state == HUMIDIFYING || controller.state == STABILIZING || controller.state == RECOVERING)) {
+    controller.pid.primed = false;   // No derivative kick from the old state's history
+    changeState(REGULATING, humidity);
+  } else if (controlMode == ControlMode::BANG_BANG && controller.state == REGULATING) {
+    setHumidifier(false);
+    changeState(STABILIZING, humidity);
+  }
+  
   // --- STATE MACHINE ---
   
   switch (controller.state) {
     
     case HUMIDIFYING: {
       setHumidifier(true);
-      setFans(false);
+      runBackgroundFans(now);
       
       // Check if we've reached target + overshoot
       if (humidity >= targetHumidity + controller.humidityOvershoot) {
@@ -234,11 +530,14 @@ void updateActuators(float rawHumidity, float rawTemperature, float rawPressure)
     
     case STABILIZING: {
       setHumidifier(false);
-      setFans(false);
+      runBackgroundFans(now);
       
-      // Monitor humidity drift during stabilization
-      if (timeInState > 10000 && abs(humidityDelta) > 0.05f) {
-        float driftRate = humidityDelta / 1.0f; // per second
+      // Monitor humidity drift during stabilization; a stalled step's delta
+      // spans an unknown time, and fans the temperature loop is running
+      // speed up the decay, so neither teaches the resting rate
+      float driftRate = !stalled && dtSec > 0.0f ? humidityDelta / dtSec : 0.0f;   // per second
+      bool thermalFans = controller.thermal.ventilation > 0.0f;
+      if (timeInState > 10000 && !thermalFans && abs(driftRate) > 0.05f) {
         controller.humidityDecayRate = filterValue(abs(driftRate), controller.humidityDecayRate, 0.1f);
       }
       
@@ -253,7 +552,7 @@ void updateActuators(float rawHumidity, float rawTemperature, float rawPressure)
         controller.stateStartTime = now; // Reset timer
       }
       // Time for periodic ventilation?
-      else if (timeSinceVentilation > controller.ventilationInterval) {
+      else if (ventilationDue) {
         Serial.println("🌬️  Scheduled ventilation starting");
         changeState(VENTILATING, humidity);
       }
@@ -262,35 +561,45 @@ void updateActuators(float rawHumidity, float rawTemperature, float rawPressure)
     
     case VENTILATING: {
       setHumidifier(false);
-      setFans(true);
+      setVentilationFans(controller.ventilationMode, 1.0f);
       
-      // Stop ventilation after duration
-      if (timeInState > controller.ventilationDuration) {
+      // Stop ventilation once the mode has moved the BALANCED volume
+      if (timeInState > ventilationDurationFor(controller.ventilationMode, controller.ventilationDuration)) {
         Serial.printf("✅ Ventilation complete (%.1f sec)\n", timeInState / 1000.0f);
         controller.lastVentilationTime = now;
         
-        // Adaptive ventilation duration based on humidity drop
-        float expectedDrop = targetHumidity * 0.15f; // Expect ~15% relative drop
-        float actualDrop = controller.humidityBeforeVentilation - humidity;
+        // Adaptive ventilation duration based on humidity drop. The duration
+        // is the BALANCED one, so other modes' drops are first converted to
+        // what BALANCED would have done with the same rated volume.
+        // CIRCULATION is not meant to exchange air, so it teaches nothing
+        bool exchange = controller.ventilationMode != VentilationMode::CIRCULATION;
+        float expectedDrop = targetHumidity * VENTILATION_EXPECTED_DROP_FRACTION;
+        float actualDrop = balancedEquivalentDrop(currentPhase, controller.ventilationMode,
+                                                  controller.humidityBeforeVentilation - humidity);
         
-        if (actualDrop > expectedDrop * 1.5f) {
+        if (exchange && actualDrop > expectedDrop * 1.5f) {
           // Dropped too much - reduce duration next time
           controller.ventilationDuration = max(15000UL, (unsigned long)(controller.ventilationDuration * 0.9f));
           Serial.printf("📊 Ventilation too strong - reducing to %lu sec\n", controller.ventilationDuration / 1000);
-        } else if (actualDrop < expectedDrop * 0.5f) {
+        } else if (exchange && actualDrop < expectedDrop * 0.5f) {
           // Didn't drop enough - increase duration
           controller.ventilationDuration = min(60000UL, (unsigned long)(controller.ventilationDuration * 1.1f));
           Serial.printf("📊 Ventilation too weak - increasing to %lu sec\n", controller.ventilationDuration / 1000);
         }
         
-        changeState(RECOVERING, humidity);
+        if (controlMode == ControlMode::PID) {
+          controller.pid.primed = false;
+          changeState(REGULATING, humidity);   // The PID does the recovery
+        } else {
+          changeState(RECOVERING, humidity);
+        }
       }
       break;
     }
     
     case RECOVERING: {
       setHumidifier(true);
-      setFans(false);
+      runBackgroundFans(now);
       
       // Recover until we're back near target
       if (humidity >= targetHumidity - 1.0f) {
@@ -304,19 +613,77 @@ void updateActuators(float rawHumidity, float rawTemperature, float rawPressure)
       }
       break;
     }
+    
+    case REGULATING: {
+      runBackgroundFans(now);
+      
+      // Gains follow the phase tolerance; the integral carries over phase
+      // changes and is left untouched while ventilating, when the PID does not run
+      const AutotuneResult* tuning = getPhaseTuning(currentPhase);
+      controller.pid.gains = tuning != NULL ? tuning->pidGains : pidGainsForPhase(activePhaseConfig);
+      float setpoint = targetHumidity + ventilationFeedForward(timeSinceVentilation);
+      controller.humidifierDuty = pidUpdate(controller.pid, setpoint, humidity, dtSec);
+      requestHumidifierDuty(controller.humidifierDuty,
+                            tuning != NULL ? tuning->outputWindowMs : HUMIDITY_PID_WINDOW_MS, now);
+      
+      if (ventilationDue) {
+        Serial.println("🌬️  Scheduled ventilation starting");
+        changeState(VENTILATING, humidity);
+      }
+      break;
+    }
+    
+    case AUTOTUNING: {
+      AutotuneOutput output = autotuneUpdate(humidity, now);
+      setHumidifier(output.humidifier);
+      setFans(output.fans);
+      
+      AutotuneStage stage = getAutotuneStage();
+      if (stage == AutotuneStage::DONE || stage == AutotuneStage::FAILED) {
+        if (stage == AutotuneStage::DONE) {
+          controller.tunedPhase = -1;   // Load the new results
+          controller.lastVentilationTime = now;   // The fan pulse counts as one
+          printAutotuneStatus();
+          requestControllerCheckpoint();   // Hours of work, save at the next step
+        }
+        changeState(STABILIZING, humidity);
+      }
+      break;
+    }
+    
+    case SENSOR_FAULT:
+      break; // Left above as soon as a valid reading arrives
   }
   
   // --- PERIODIC STATUS LOG (every 30 seconds) ---
   if (now - lastStatusLog > 30000) {
     Serial.println("\n========== Controller Status ==========");
     Serial.printf("State: %s (%.0f sec)\n", stateToString(controller.state), timeInState / 1000.0f);
-    Serial.printf("Environment: H=%.1f%% (target %.1f%%), T=%.1f°C, P=%.0f hPa\n",
-                 humidity, targetHumidity, temperature, rawPressure);
-    Serial.printf("Actuators: Humidifier=%s, Fans=%s\n",
-                 controller.humidifierOn ? "ON " : "OFF",
-                 controller.fansOn ? "ON" : "OFF");
-    Serial.printf("Next ventilation in: %.1f min\n",
-                 (controller.ventilationInterval - timeSinceVentilation) / 60000.0f);
+    Serial.printf("Environment: H=%.1f%% (target %.1f%%), T=%.1f°C (target %.1f°C), P=%.0f hPa\n",
+                 humidity, targetHumidity, temperature, activePhaseConfig.targetTemperature, rawPressure);
+    Serial.printf("Actuators: Humidifier=%s, Fans=%.0f%%/%.0f%%/%.0f%% (%s)\n",
+                 isHumidifierOutputOn() ? "ON " : "OFF",
+                 getFanDuty(FAN_EXHAUST_1) * 100.0f, getFanDuty(FAN_EXHAUST_2) * 100.0f,
+                 getFanDuty(FAN_INLET) * 100.0f, ventilationModeToString(controller.ventilationMode));
+    if (controlMode == ControlMode::PID) {
+      Serial.printf("PID: duty=%.0f%% (I=%.0f%%), build rate %.3f%%/s\n",
+                   controller.humidifierDuty * 100.0f, controller.pid.integral * 100.0f,
+                   controller.humidityBuildRate);
+    }
+    if (ventilationStyle == VentilationStyle::BURST) {
+      Serial.printf("Next ventilation in: %.1f min\n",
+                   (controller.ventilationInterval - timeSinceVentilation) / 60000.0f);
+    } else {
+      Serial.printf("Continuous exchange: %.0f%% speed, %.0f%% of the time\n",
+                   CONTINUOUS_FAN_SPEED * 100.0f, controller.exchangeWindow.windowDuty * 100.0f);
+    }
+    TemperatureControlStatus thermalStatus = getTemperatureControlStatus();
+    Serial.printf("Temperature: demand %+.0f%%, heater %s, cooler %s, fans %.0f%% (score %.2f vs %.2f)\n",
+                 thermalStatus.demand * 100.0f,
+                 hasHeater() ? (isHeaterOn() ? "ON" : "OFF") : "none",
+                 hasCooler() ? (isCoolerOn() ? "ON" : "OFF") : "none",
+                 controller.thermal.ventilation * 100.0f,
+                 thermalStatus.temperatureScore, thermalStatus.humidityScore);
     Serial.printf("Cycles: Humidify=%d, Ventilate=%d\n",
                  controller.humidificationCycles, controller.ventilationCycles);
     Serial.println("======================================\n");
@@ -324,15 +691,77 @@ void updateActuators(float rawHumidity, float rawTemperature, float rawPressure)
   }
 }
 
+void writeStagedCheckpoints() {
+  writeStagedControllerCheckpoint();
+  writeStagedActuatorWear();
+}
+
 // --- Status Functions ---
-bool isHumidifierOn() { return controller.humidifierOn; }
-bool areFansOn() { return controller.fansOn; }
-float getCurrentFanSpeed() { return controller.fansOn ? 1.0f : 0.0f; }
+bool isHumidifierOn() { return isHumidifierOutputOn(); }
+bool areFansOn() { return getCurrentFanSpeed() > 0.0f; }
 bool isVentilating() { return controller.state == VENTILATING; }
 
+float getCurrentFanSpeed() {
+  float total = 0.0f;
+  for (int i = 0; i < FAN_COUNT; i++) {
+    total += getFanDuty((FanId)i);
+  }
+  return total / FAN_COUNT;
+}
+
+ControllerState getControllerState() { return controller.state; }
+ControlMode getControlMode() { return controlMode; }
+float getHumidifierDuty() { return controller.humidifierDuty; }
+
+void startAutotune() {
+  autotuneStart(activePhaseConfig, currentPhase,
+                activePhaseConfig.targetHumidity * VENTILATION_EXPECTED_DROP_FRACTION, millis());
+  changeState(AUTOTUNING, controller.filteredHumidity);
+}
+
+void cancelAutotune() {
+  if (controller.state == AUTOTUNING) {
+    changeState(STABILIZING, controller.filteredHumidity);
+  }
+}
+
+const char* ventilationStyleToString(VentilationStyle style) {
+  return style == VentilationStyle::CONTINUOUS ? "CONTINUOUS" : "BURST";
+}
+
+VentilationStyle stringToVentilationStyle(const char* styleStr) {
+  return strcmp(styleStr, "CONTINUOUS") == 0 ? VentilationStyle::CONTINUOUS : VentilationStyle::BURST;
+}
+
+void setVentilationStyle(VentilationStyle style) {
+  if (style != ventilationStyle) {
+    Serial.printf("🌬️  Ventilation style: %s → %s\n",
+                  ventilationStyleToString(ventilationStyle), ventilationStyleToString(style));
+    ventilationStyle = style;
+  }
+}
+
+VentilationStyle getVentilationStyle() { return ventilationStyle; }
+
+void setControlMode(ControlMode mode) {
+  if (mode != controlMode) {
+    Serial.printf("🎛️  Control mode: %s → %s\n", controlModeToString(controlMode), controlModeToString(mode));
+    controlMode = mode;
+  }
+}
+
+uint8_t getActuatorFlags() {
+  uint8_t flags = 0;
+  if (isHumidifierOutputOn()) flags |= ACTUATOR_FLAG_HUMIDIFIER;
+  if (areFansOn()) flags |= ACTUATOR_FLAG_FANS;
+  if (controller.state == VENTILATING) flags |= ACTUATOR_FLAG_VENTILATING;
+  if (isHeaterOn()) flags |= ACTUATOR_FLAG_HEATER;
+  if (isCoolerOn()) flags |= ACTUATOR_FLAG_COOLER;
+  return flags;
+}
+
 // --- Manual Control Functions ---
 void turnFansOn() { setFans(true); }
 void turnFansOff() { setFans(false); }
 void turnOnHumidifier() { setHumidifier(true); }
-void turnOffHumidifier() { setHumidifier(false); }
-void setFanSpeed(float speed) { setFans(speed > 0.5f); }
\ No newline at end of file
+void turnOffHumidifier() { setHumidifier(false); }
\ No newline at end of file
@@ -1,23 +1,77 @@
 #ifndef ACTUATORS_H
 #define ACTUATORS_H
 
+#include <stdint.h>
 #include "mushroom_types.h"
+#include "controller_store.h"
+#include "fan_driver.h"
+
+// --- Actuator State Flags (sent with telemetry) ---
+#define ACTUATOR_FLAG_HUMIDIFIER  0x01
+#define ACTUATOR_FLAG_FANS        0x02
+#define ACTUATOR_FLAG_VENTILATING 0x04
+#define ACTUATOR_FLAG_HEATER      0x08
+#define ACTUATOR_FLAG_COOLER      0x10
+
+// --- Controller States ---
+enum ControllerState {
+  HUMIDIFYING,      // Building up humidity
+  STABILIZING,      // Letting system settle
+  VENTILATING,      // Fresh air exchange
+  RECOVERING,       // Rebuilding after ventilation
+  SENSOR_FAULT,     // Sensor failed, running the open-loop fallback duty cycle
+  REGULATING,       // PID mode: humidifier duty follows the humidity error
+  AUTOTUNING        // Relay experiment measuring the chamber (relay_autotune.h)
+};
+
+// --- Control Modes ---
+enum class ControlMode {
+  BANG_BANG,        // HUMIDIFYING/STABILIZING/RECOVERING cycling with a fixed overshoot
+  PID               // REGULATING with a time-proportioned humidifier and ventilation feed-forward
+};
+
+// --- Ventilation Styles ---
+enum class VentilationStyle {
+  BURST,            // Full-speed VENTILATING states every ventilationInterval
+  CONTINUOUS        // Low-speed time-proportioned exchange alongside humidity control
+};
 
 // --- Setup Function ---
 void setupActuators();
 
 // --- Main Control Function ---
-void updateActuators(float humidity, float temperature, float pressure);
+// One control step; dtSec is the real time since the previous one
+void updateActuators(float humidity, float temperature, float pressure, float dtSec);
+// Writes what the last steps staged for NVS; call from a task below control
+void writeStagedCheckpoints();
+
+// --- Configuration Functions ---
+void setControlMode(ControlMode mode);
+void setVentilationStyle(VentilationStyle style);
+void startAutotune();     // Tunes the current phase; results apply whenever it is active
+void cancelAutotune();
 
 // --- Individual Control Functions ---
-void setFanSpeed(float speed);        // 0.0 to 1.0
+void setFanSpeed(float speed);        // All fans, 0.0 to 1.0
+void setFanSpeed(FanId fan, float speed);
 void setHumidifier(bool on);
 
 // --- Status Query Functions ---
 bool isHumidifierOn();
 bool areFansOn();
-float getCurrentFanSpeed();
+float getCurrentFanSpeed();           // Average duty on the fan pins, 0.0 to 1.0
 bool isVentilating();
+uint8_t getActuatorFlags();
+ControllerState getControllerState();
+const char* stateToString(ControllerState state);
+ControlMode getControlMode();
+const char* controlModeToString(ControlMode mode);
+ControlMode stringToControlMode(const char* modeStr);   // BANG_BANG unless "PID"
+VentilationStyle getVentilationStyle();
+const char* ventilationStyleToString(VentilationStyle style);
+VentilationStyle stringToVentilationStyle(const char* styleStr);   // BURST unless "CONTINUOUS"
+float getHumidifierDuty();            // PID output, 0.0 to 1.0
+LearnedParameters getLearnedParameters();
 
 // --- Legacy Functions (for backward compatibility) ---
 void turnFansOn();
@@ -0,0 +1,233 @@
+#include "bme280_burst.h"
+#include "hal/hal.h"
+#include <Arduino.h>
+#include <math.h>
+
+#define BME280_STATUS_MEASURING  0x08
+#define BME280_STATUS_IM_UPDATE  0x01
+#define BME280_SKIPPED_20BIT     0x80000
+#define BME280_SKIPPED_16BIT     0x8000
+
+// --- Device State ---
+static uint8_t deviceAddress = BME280_ADDR_PRIMARY;
+static Bme280Calibration calibration;
+static Bme280Settings activeSettings = bme280DefaultSettings();
+static unsigned long transactionCount = 0;
+
+Bme280Settings bme280DefaultSettings() {
+  // Same profile as test_bme280: humidity unfiltered, pressure heavily smoothed
+  Bme280Settings settings;
+  settings.mode = Bme280Mode::NORMAL;
+  settings.temperatureOversampling = Bme280Oversampling::X2;
+  settings.pressureOversampling = Bme280Oversampling::X16;
+  settings.humidityOversampling = Bme280Oversampling::X1;
+  settings.filter = Bme280Filter::X16;
+  settings.standby = Bme280Standby::MS_500;
+  return settings;
+}
+
+// --- Conversion Functions ---
+static uint16_t le16(const uint8_t* bytes) {
+  return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+void bme280ParseCalibration(const uint8_t* tp, const uint8_t* h, Bme280Calibration& cal) {
+  cal.T1 = le16(tp + 0);
+  cal.T2 = (int16_t)le16(tp + 2);
+  cal.T3 = (int16_t)le16(tp + 4);
+  cal.P1 = le16(tp + 6);
+  cal.P2 = (int16_t)le16(tp + 8);
+  cal.P3 = (int16_t)le16(tp + 10);
+  cal.P4 = (int16_t)le16(tp + 12);
+  cal.P5 = (int16_t)le16(tp + 14);
+  cal.P6 = (int16_t)le16(tp + 16);
+  cal.P7 = (int16_t)le16(tp + 18);
+  cal.P8 = (int16_t)le16(tp + 20);
+  cal.P9 = (int16_t)le16(tp + 22);
+  cal.H1 = tp[25];
+
+  // H4 and H5 share the nibbles of 0xE5
+  cal.H2 = (int16_t)le16(h + 0);
+  cal.H3 = h[2];
+  cal.H4 = (int16_t)(((int8_t)h[3] << 4) | (h[4] & 0x0F));
+  cal.H5 = (int16_t)(((int8_t)h[5] << 4) | (h[4] >> 4));
+  cal.H6 = (int8_t)h[6];
+}
+
+// Integer compensation from the Bosch datasheet (section 4.2.3)
+static int32_t compensateTemperature(const Bme280Calibration& cal, int32_t adc, int32_t& tFine) {
+  int32_t var1 = ((((adc >> 3) - ((int32_t)cal.T1 << 1))) * (int32_t)cal.T2) >> 11;
+  int32_t var2 = (((((adc >> 4) - (int32_t)cal.T1) * ((adc >> 4) - (int32_t)cal.T1)) >> 12) *
+                  (int32_t)cal.T3) >> 14;
+  tFine = var1 + var2;
+  return (tFine * 5 + 128) >> 8;   // 0.01 °C
+}
+
+static uint32_t compensatePressure(const Bme280Calibration& cal, int32_t adc, int32_t tFine) {
+  int64_t var1 = (int64_t)tFine - 128000;
+  int64_t var2 = var1 * var1 * (int64_t)cal.P6;
+  var2 = var2 + ((var1 * (int64_t)cal.P5) << 17);
+  var2 = var2 + (((int64_t)cal.P4) << 35);
+  var1 = ((var1 * var1 * (int64_t)cal.P3) >> 8) + ((var1 * (int64_t)cal.P2) << 12);
+  var1 = ((((int64_t)1) << 47) + var1) * (int64_t)cal.P1 >> 33;
+  if (var1 == 0) {
+    return 0;   // Avoid division by zero on blank calibration
+  }
+
+  int64_t p = 1048576 - adc;
+  p = (((p << 31) - var2) * 3125) / var1;
+  var1 = ((int64_t)cal.P9 * (p >> 13) * (p >> 13)) >> 25;
+  var2 = ((int64_t)cal.P8 * p) >> 19;
+  p = ((p + var1 + var2) >> 8) + (((int64_t)cal.P7) << 4);
+  return (uint32_t)p;   // Pa in Q24.8
+}
+
+static uint32_t compensateHumidity(const Bme280Calibration& cal, int32_t adc, int32_t tFine) {
+  int32_t v = tFine - 76800;
+  v = (((((adc << 14) - (((int32_t)cal.H4) << 20) - (((int32_t)cal.H5) * v)) + 16384) >> 15) *
+       (((((((v * (int32_t)cal.H6) >> 10) * (((v * (int32_t)cal.H3) >> 11) + 32768)) >> 10) + 2097152) *
+         (int32_t)cal.H2 + 8192) >> 14));
+  v = v - (((((v >> 15) * (v >> 15)) >> 7) * (int32_t)cal.H1) >> 4);
+  v = v < 0 ? 0 : v;
+  v = v > 419430400 ? 419430400 : v;
+  return (uint32_t)(v >> 12);   // %RH in Q22.10
+}
+
+Bme280Sample bme280Compensate(const Bme280Calibration& cal, const uint8_t* data) {
+  int32_t adcP = ((int32_t)data[0] << 12) | ((int32_t)data[1] << 4) | (data[2] >> 4);
+  int32_t adcT = ((int32_t)data[3] << 12) | ((int32_t)data[4] << 4) | (data[5] >> 4);
+  int32_t adcH = ((int32_t)data[6] << 8) | data[7];
+
+  Bme280Sample sample = { NAN, NAN, NAN };
+  if (adcT == BME280_SKIPPED_20BIT) {
+    return sample;   // Pressure and humidity both need t_fine
+  }
+
+  // All three values derive from the same temperature conversion
+  int32_t tFine;
+  sample.temperature = compensateTemperature(cal, adcT, tFine) / 100.0f;
+  if (adcP != BME280_SKIPPED_20BIT) {
+    sample.pressure = compensatePressure(cal, adcP, tFine) / 25600.0f;
+  }
+  if (adcH != BME280_SKIPPED_16BIT) {
+    sample.humidity = compensateHumidity(cal, adcH, tFine) / 1024.0f;
+  }
+  return sample;
+}
+
+static unsigned long oversamplingCount(Bme280Oversampling oversampling) {
+  return oversampling == Bme280Oversampling::SKIP ? 0 : 1UL << ((uint8_t)oversampling - 1);
+}
+
+unsigned long bme280MeasurementTimeUs(const Bme280Settings& settings) {
+  // Maximum timings from datasheet appendix 9.1
+  unsigned long t = oversamplingCount(settings.temperatureOversampling);
+  unsigned long p = oversamplingCount(settings.pressureOversampling);
+  unsigned long h = oversamplingCount(settings.humidityOversampling);
+
+  unsigned long us = 1250 + 2300 * t;
+  if (p > 0) us += 2300 * p + 575;
+  if (h > 0) us += 2300 * h + 575;
+  return us;
+}
+
+// --- I2C Helpers ---
+static bool writeRegister(uint8_t reg, uint8_t value) {
+  transactionCount++;
+  return halI2cWrite(deviceAddress, reg, value);
+}
+
+// Register pointer write and repeated-start read form one transaction
+static bool readRegisters(uint8_t reg, uint8_t* buffer, size_t length) {
+  transactionCount++;
+  return halI2cRead(deviceAddress, reg, buffer, length);
+}
+
+static bool waitWhileStatus(uint8_t mask, unsigned long timeoutUs) {
+  unsigned long start = micros();
+  uint8_t status;
+  do {
+    if (!readRegisters(BME280_REG_STATUS, &status, 1)) {
+      return false;
+    }
+    if ((status & mask) == 0) {
+      return true;
+    }
+    delayMicroseconds(500);
+  } while (micros() - start < timeoutUs);
+  return false;
+}
+
+// --- Device Functions ---
+bool bme280Begin(uint8_t address, const Bme280Settings& settings) {
+  deviceAddress = address;
+  halI2cBegin();
+
+  uint8_t chipId = 0;
+  if (!readRegisters(BME280_REG_CHIP_ID, &chipId, 1) || chipId != BME280_CHIP_ID) {
+    return false;
+  }
+
+  if (!writeRegister(BME280_REG_RESET, BME280_RESET_CMD)) {
+    return false;
+  }
+  delay(2);
+  if (!waitWhileStatus(BME280_STATUS_IM_UPDATE, 10000)) {
+    return false;
+  }
+
+  uint8_t tpBlock[BME280_CALIB_TP_SIZE];
+  uint8_t hBlock[BME280_CALIB_H_SIZE];
+  if (!readRegisters(BME280_REG_CALIB_TP, tpBlock, sizeof(tpBlock)) ||
+      !readRegisters(BME280_REG_CALIB_H, hBlock, sizeof(hBlock))) {
+    return false;
+  }
+  bme280ParseCalibration(tpBlock, hBlock, calibration);
+
+  return bme280Configure(settings);
+}
+
+bool bme280Configure(const Bme280Settings& settings) {
+  uint8_t config = ((uint8_t)settings.standby << 5) | ((uint8_t)settings.filter << 2);
+  uint8_t ctrlMeas = ((uint8_t)settings.temperatureOversampling << 5) |
+                     ((uint8_t)settings.pressureOversampling << 2);
+
+  // config is only writable in sleep mode; ctrl_hum latches on the ctrl_meas write
+  bool ok = writeRegister(BME280_REG_CTRL_MEAS, ctrlMeas) &&
+            writeRegister(BME280_REG_CONFIG, config) &&
+            writeRegister(BME280_REG_CTRL_HUM, (uint8_t)settings.humidityOversampling) &&
+            writeRegister(BME280_REG_CTRL_MEAS, ctrlMeas | (uint8_t)settings.mode);
+  if (ok) {
+    activeSettings = settings;
+  }
+  return ok;
+}
+
+bool bme280ReadSample(Bme280Sample& sample) {
+  if (activeSettings.mode == Bme280Mode::FORCED) {
+    uint8_t ctrlMeas = ((uint8_t)activeSettings.temperatureOversampling << 5) |
+                       ((uint8_t)activeSettings.pressureOversampling << 2) |
+                       (uint8_t)Bme280Mode::FORCED;
+    if (!writeRegister(BME280_REG_CTRL_MEAS, ctrlMeas)) {
+      return false;
+    }
+
+    // Sleep through the conversion rather than polling the bus for it
+    unsigned long conversionUs = bme280MeasurementTimeUs(activeSettings);
+    delay((conversionUs + 999) / 1000);
+    if (!waitWhileStatus(BME280_STATUS_MEASURING, conversionUs)) {
+      return false;
+    }
+  }
+
+  uint8_t data[BME280_DATA_SIZE];
+  if (!readRegisters(BME280_REG_DATA, data, sizeof(data))) {
+    return false;
+  }
+  sample = bme280Compensate(calibration, data);
+  return true;
+}
+
+unsigned long bme280TransactionCount() {
+  return transactionCount;
+}
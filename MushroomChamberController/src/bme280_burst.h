@@ -0,0 +1,108 @@
+#ifndef BME280_BURST_H
+#define BME280_BURST_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Register-level BME280 access: one 8-byte burst read per sample instead of
+// the separate (and internally repeated) transactions of Adafruit_BME280
+
+// --- I2C Addresses ---
+#define BME280_ADDR_PRIMARY   0x76
+#define BME280_ADDR_SECONDARY 0x77
+
+// --- Registers ---
+#define BME280_REG_CALIB_TP   0x88   // 26 bytes: T1..P9, reserved, H1
+#define BME280_REG_CHIP_ID    0xD0
+#define BME280_REG_RESET      0xE0
+#define BME280_REG_CALIB_H    0xE1   // 7 bytes: H2..H6
+#define BME280_REG_CTRL_HUM   0xF2
+#define BME280_REG_STATUS     0xF3
+#define BME280_REG_CTRL_MEAS  0xF4
+#define BME280_REG_CONFIG     0xF5
+#define BME280_REG_DATA       0xF7   // 8 bytes: press[3], temp[3], hum[2]
+
+#define BME280_CHIP_ID        0x60
+#define BME280_RESET_CMD      0xB6
+#define BME280_CALIB_TP_SIZE  26
+#define BME280_CALIB_H_SIZE   7
+#define BME280_DATA_SIZE      8
+
+enum class Bme280Mode : uint8_t {
+  SLEEP = 0,
+  FORCED = 1,    // One conversion per read, sensor sleeps in between
+  NORMAL = 3     // Continuous conversions, reads return the latest result
+};
+
+enum class Bme280Oversampling : uint8_t {
+  SKIP = 0,      // Measurement disabled, reported as NaN
+  X1 = 1,
+  X2 = 2,
+  X4 = 3,
+  X8 = 4,
+  X16 = 5
+};
+
+enum class Bme280Filter : uint8_t {
+  OFF = 0,
+  X2 = 1,
+  X4 = 2,
+  X8 = 3,
+  X16 = 4
+};
+
+enum class Bme280Standby : uint8_t {
+  MS_0_5 = 0,
+  MS_62_5 = 1,
+  MS_125 = 2,
+  MS_250 = 3,
+  MS_500 = 4,
+  MS_1000 = 5,
+  MS_10 = 6,
+  MS_20 = 7
+};
+
+struct Bme280Settings {
+  Bme280Mode mode;
+  Bme280Oversampling temperatureOversampling;
+  Bme280Oversampling pressureOversampling;
+  Bme280Oversampling humidityOversampling;
+  Bme280Filter filter;
+  Bme280Standby standby;    // Normal mode only
+};
+
+// Factory trimming values from the sensor NVM
+struct Bme280Calibration {
+  uint16_t T1;
+  int16_t T2, T3;
+  uint16_t P1;
+  int16_t P2, P3, P4, P5, P6, P7, P8, P9;
+  uint8_t H1;
+  int16_t H2;
+  uint8_t H3;
+  int16_t H4, H5;
+  int8_t H6;
+};
+
+// Compensated values from one burst; NaN for skipped measurements
+struct Bme280Sample {
+  float temperature;   // °C
+  float humidity;      // %RH
+  float pressure;      // hPa
+};
+
+// --- Default Settings ---
+Bme280Settings bme280DefaultSettings();
+
+// --- Conversion Functions (no I2C) ---
+void bme280ParseCalibration(const uint8_t* tpBlock, const uint8_t* hBlock, Bme280Calibration& calibration);
+Bme280Sample bme280Compensate(const Bme280Calibration& calibration, const uint8_t* data);
+unsigned long bme280MeasurementTimeUs(const Bme280Settings& settings);   // Worst-case conversion time
+
+// --- Device Functions ---
+bool bme280Begin(uint8_t address, const Bme280Settings& settings);
+bool bme280Configure(const Bme280Settings& settings);
+bool bme280ReadSample(Bme280Sample& sample);
+unsigned long bme280TransactionCount();   // I2C transactions since boot
+
+#endif
@@ -1,10 +1,13 @@
 #include "config.h"
-#include <WiFi.h>
-#include <time.h>
+#include "hal/hal.h"
+#include <Arduino.h>
 #include <FastLED.h>
 
-extern MushroomConfig currentConfig;
-extern GrowthPhase currentPhase;
+// Global configuration and current phase
+MushroomConfig currentConfig;
+GrowthPhase currentPhase = INCUBATION; // Change as needed: INCUBATION, PRIMORDIA_FORMATION, FRUITING
+GrowthPhase oldPhase = currentPhase; // Store the previous phase for comparison
+PhaseConfig activePhaseConfig;
 
 PhaseConfig getActivePhaseConfig() {
   switch (currentPhase) {
@@ -27,9 +30,9 @@ MushroomConfig getMushroomConfig(MushroomType type) {
       // Fruiting: 7-18°C (45-65°F), 65-85% RH, 8-12h BLUE/COOL WHITE light (6500K)
       return {
         "Shiitake",
-        { 25.0, 2.0, 70.0, 5.0, 1013.0, 8.0, 0, 0, CRGB::Black },           // Incubation: DARK
-        { 15.0, 2.0, 92.0, 5.0, 1013.0, 8.0, 6, 10, CRGB(100, 150, 255) },  // Primordia: Cool blue-white
-        { 13.0, 3.0, 75.0, 10.0, 1013.0, 8.0, 8, 12, CRGB(100, 150, 255) }  // Fruiting: Cool blue-white
+        { 25.0, 2.0, 70.0, 5.0, 1013.0, 8.0, 0, 0, CRGB::Black, VentilationMode::BALANCED },           // Incubation: DARK
+        { 15.0, 2.0, 92.0, 5.0, 1013.0, 8.0, 6, 10, CRGB(100, 150, 255), VentilationMode::BALANCED },  // Primordia: Cool blue-white
+        { 13.0, 3.0, 75.0, 10.0, 1013.0, 8.0, 8, 12, CRGB(100, 150, 255), VentilationMode::BALANCED }  // Fruiting: Cool blue-white
       };
 
     case OYSTER:
@@ -38,9 +41,9 @@ MushroomConfig getMushroomConfig(MushroomType type) {
       // Fruiting: 15-21°C (60-70°F), 85-90% RH, 12h BLUE/COOL WHITE (6500K)
       return {
         "Oyster",
-        { 24.0, 2.0, 70.0, 5.0, 1013.0, 8.0, 0, 0, CRGB::Black },           // Incubation: DARK
-        { 13.0, 2.0, 93.0, 5.0, 1013.0, 8.0, 8, 12, CRGB(100, 150, 255) },  // Primordia: Cool blue-white
-        { 18.0, 3.0, 88.0, 5.0, 1013.0, 8.0, 8, 12, CRGB(100, 150, 255) }   // Fruiting: Cool blue-white
+        { 24.0, 2.0, 70.0, 5.0, 1013.0, 8.0, 0, 0, CRGB::Black, VentilationMode::BALANCED },           // Incubation: DARK
+        { 13.0, 2.0, 93.0, 5.0, 1013.0, 8.0, 8, 12, CRGB(100, 150, 255), VentilationMode::BALANCED },  // Primordia: Cool blue-white
+        { 18.0, 3.0, 88.0, 5.0, 1013.0, 8.0, 8, 12, CRGB(100, 150, 255), VentilationMode::BALANCED }   // Fruiting: Cool blue-white
       };
 
     case KING_OYSTER:
@@ -49,9 +52,9 @@ MushroomConfig getMushroomConfig(MushroomType type) {
       // Fruiting: 15-18°C (59-65°F), 85-88% RH, 10-16h BLUE/COOL WHITE (needs more light)
       return {
         "King Oyster",
-        { 25.0, 2.0, 92.0, 5.0, 1013.0, 8.0, 0, 0, CRGB::Black },           // Incubation: DARK
-        { 15.0, 1.0, 97.0, 5.0, 1013.0, 8.0, 8, 12, CRGB(100, 150, 255) },  // Primordia: Cool blue-white
-        { 16.5, 1.5, 86.0, 3.0, 1013.0, 8.0, 10, 16, CRGB(100, 150, 255) }  // Fruiting: Cool blue-white
+        { 25.0, 2.0, 92.0, 5.0, 1013.0, 8.0, 0, 0, CRGB::Black, VentilationMode::BALANCED },           // Incubation: DARK
+        { 15.0, 1.0, 97.0, 5.0, 1013.0, 8.0, 8, 12, CRGB(100, 150, 255), VentilationMode::BALANCED },  // Primordia: Cool blue-white
+        { 16.5, 1.5, 86.0, 3.0, 1013.0, 8.0, 10, 16, CRGB(100, 150, 255), VentilationMode::BALANCED }  // Fruiting: Cool blue-white
       };
 
     case SHIMEJI:
@@ -60,9 +63,9 @@ MushroomConfig getMushroomConfig(MushroomType type) {
       // Fruiting: 13-18°C (55-65°F), 85-95% RH, 8-12h BLUE/COOL WHITE
       return {
         "Shimeji (Beech)",
-        { 25.0, 2.0, 72.0, 5.0, 1013.0, 8.0, 0, 0, CRGB::Black },           // Incubation: DARK
-        { 15.5, 1.0, 87.0, 5.0, 1013.0, 8.0, 8, 12, CRGB(100, 150, 255) },  // Primordia: Cool blue-white
-        { 15.5, 2.5, 90.0, 5.0, 1013.0, 8.0, 8, 12, CRGB(100, 150, 255) }   // Fruiting: Cool blue-white
+        { 25.0, 2.0, 72.0, 5.0, 1013.0, 8.0, 0, 0, CRGB::Black, VentilationMode::BALANCED },           // Incubation: DARK
+        { 15.5, 1.0, 87.0, 5.0, 1013.0, 8.0, 8, 12, CRGB(100, 150, 255), VentilationMode::BALANCED },  // Primordia: Cool blue-white
+        { 15.5, 2.5, 90.0, 5.0, 1013.0, 8.0, 8, 12, CRGB(100, 150, 255), VentilationMode::BALANCED }   // Fruiting: Cool blue-white
       };
 
     case LIONS_MANE:
@@ -71,9 +74,9 @@ MushroomConfig getMushroomConfig(MushroomType type) {
       // Fruiting: 15-20°C (59-68°F), 85-95% RH, INDIRECT BLUE/COOL WHITE (sensitive to direct)
       return {
         "Lion's Mane",
-        { 25.0, 2.0, 92.0, 5.0, 1013.0, 8.0, 0, 0, CRGB::Black },           // Incubation: DARK
-        { 16.5, 1.5, 90.0, 5.0, 1013.0, 8.0, 6, 8, CRGB(120, 170, 255) },   // Primordia: Soft blue-white
-        { 17.5, 2.5, 88.0, 5.0, 1013.0, 8.0, 8, 12, CRGB(120, 170, 255) }   // Fruiting: Soft blue-white
+        { 25.0, 2.0, 92.0, 5.0, 1013.0, 8.0, 0, 0, CRGB::Black, VentilationMode::BALANCED },           // Incubation: DARK
+        { 16.5, 1.5, 90.0, 5.0, 1013.0, 8.0, 6, 8, CRGB(120, 170, 255), VentilationMode::BALANCED },   // Primordia: Soft blue-white
+        { 17.5, 2.5, 88.0, 5.0, 1013.0, 8.0, 8, 12, CRGB(120, 170, 255), VentilationMode::BALANCED }   // Fruiting: Soft blue-white
       };
     
     case MAITAKE:
@@ -82,54 +85,47 @@ MushroomConfig getMushroomConfig(MushroomType type) {
       // Fruiting: 12-18°C (55-65°F), 85-95% RH, 12h BLUE/COOL WHITE cycle
       return {
         "Maitake (Hen of Woods)",
-        { 25.0, 3.0, 75.0, 5.0, 1013.0, 8.0, 0, 0, CRGB::Black },           // Incubation: DARK
-        { 13.0, 3.0, 90.0, 5.0, 1013.0, 8.0, 12, 12, CRGB(100, 150, 255) }, // Primordia: Cool blue-white
-        { 15.0, 3.0, 88.0, 5.0, 1013.0, 8.0, 12, 12, CRGB(100, 150, 255) }  // Fruiting: Cool blue-white
+        { 25.0, 3.0, 75.0, 5.0, 1013.0, 8.0, 0, 0, CRGB::Black, VentilationMode::BALANCED },           // Incubation: DARK
+        { 13.0, 3.0, 90.0, 5.0, 1013.0, 8.0, 12, 12, CRGB(100, 150, 255), VentilationMode::BALANCED }, // Primordia: Cool blue-white
+        { 15.0, 3.0, 88.0, 5.0, 1013.0, 8.0, 12, 12, CRGB(100, 150, 255), VentilationMode::BALANCED }  // Fruiting: Cool blue-white
       };
     default:
       // Fallback to general mushroom cultivation parameters
       return {
         "Generic Mushroom",
-        { 22.0, 2.0, 70.0, 5.0, 1013.0, 8.0, 0, 0, CRGB::Black },
-        { 15.0, 2.0, 90.0, 5.0, 1013.0, 8.0, 8, 12, CRGB::White },
-        { 18.0, 2.0, 88.0, 5.0, 1013.0, 8.0, 8, 12, CRGB::White }
+        { 22.0, 2.0, 70.0, 5.0, 1013.0, 8.0, 0, 0, CRGB::Black, VentilationMode::BALANCED },
+        { 15.0, 2.0, 90.0, 5.0, 1013.0, 8.0, 8, 12, CRGB::White, VentilationMode::BALANCED },
+        { 18.0, 2.0, 88.0, 5.0, 1013.0, 8.0, 8, 12, CRGB::White, VentilationMode::BALANCED }
       };
   }
 }
 
 static bool timeIsSynced = false;
+static bool timeSyncStarted = false;
 
+// Never waits: the first call with WiFi up starts SNTP, which keeps
+// retrying in the background, and every call checks whether it has landed
 void setupTime() {
-  if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("⚠️  WiFi not connected - skipping time sync");
+  if (timeIsSynced) {
     return;
   }
-  
-  Serial.println("Syncing time with NTP...");
-  
-  // Try multiple NTP servers (GMT+1 for Sweden/Europe)
-  const char* ntpServers[] = {
-    "pool.ntp.org",
-    "time.cloudflare.com",
-    "se.pool.ntp.org"
-  };
-  
-  for (int i = 0; i < 3 && !timeIsSynced; i++) {
-    configTime(3600, 0, ntpServers[i]);
-    
-    struct tm timeinfo;
-    for (int attempt = 0; attempt < 10; attempt++) {
-      if (getLocalTime(&timeinfo) && timeinfo.tm_year + 1900 >= 2020) {
-        timeIsSynced = true;
-        Serial.printf("✅ Time synced: %02d:%02d:%02d\n", 
-                     timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
-        return;
-      }
-      delay(500);
+  if (!timeSyncStarted) {
+    if (!halNetworkConnected()) {
+      Serial.println("⚠️  WiFi not connected - skipping time sync");
+      return;
     }
+    Serial.println("Syncing time with NTP...");
+    // Multiple NTP servers (GMT+1 for Sweden/Europe)
+    halStartClockSync(3600, "pool.ntp.org", "time.cloudflare.com", "se.pool.ntp.org");
+    timeSyncStarted = true;
   }
   
-  Serial.println("❌ Time sync failed - lights may not work");
+  struct tm timeinfo;
+  if (halClockSynced() && halLocalTime(timeinfo)) {
+    timeIsSynced = true;
+    Serial.printf("✅ Time synced: %02d:%02d:%02d\n", 
+                 timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
+  }
 }
 
 bool isTimeSynced() {
@@ -146,9 +142,7 @@ void setManualTime(int year, int month, int day, int hour, int minute, int secon
   timeinfo.tm_sec = second;
   timeinfo.tm_isdst = 0;
   
-  time_t t = mktime(&timeinfo);
-  struct timeval now = { .tv_sec = t };
-  settimeofday(&now, NULL);
+  halSetLocalTime(timeinfo);
   
   timeIsSynced = true;
   Serial.printf("⚙️ Time set manually: %02d:%02d:%02d\n", hour, minute, second);
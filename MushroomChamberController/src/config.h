@@ -3,7 +3,10 @@
 
 #include "mushroom_types.h"
 
+extern MushroomConfig currentConfig;
 extern GrowthPhase currentPhase;
+extern GrowthPhase oldPhase;
+extern PhaseConfig activePhaseConfig;
 
 // Function to get config based on type
 MushroomConfig getMushroomConfig(MushroomType type);
@@ -0,0 +1,147 @@
+#include "control_tick.h"
+#include <Arduino.h>
+#include <atomic>
+
+// One statistics window of lateness values
+struct LatenessWindow {
+  uint16_t counts[CONTROL_TICK_BUCKETS];
+  uint32_t ticks;
+  uint32_t maxUs;
+};
+
+// --- Tick State ---
+static uint32_t periodUs = 1000000;
+static int64_t nextDeadline = 0;
+static int64_t lastStep = 0;
+static uint32_t ticks = 0;
+static uint32_t missed = 0;
+static LatenessWindow window = {};
+static ControlTickStats lastWindowStats = {};
+static bool windowClosed = false;
+
+// The control task writes the state above on one core while the comms
+// task reads the stats on the other. A sequence counter, odd while a
+// write is under way, lets the reader retry a torn copy without ever
+// holding up the control step.
+static std::atomic<uint32_t> sequence(0);
+
+static void beginWrite() {
+  sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+static void endWrite() {
+  sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// --- Lateness Histogram ---
+// Four buckets per octave: exact below 4 µs, then 25 % wide
+static int latenessBucket(uint32_t us) {
+  if (us < 4) {
+    return us;
+  }
+  int msb = 31 - __builtin_clz(us);
+  int bucket = 4 * (msb - 1) + ((us >> (msb - 2)) & 3);
+  return min(bucket, CONTROL_TICK_BUCKETS - 1);
+}
+
+static uint32_t bucketUpperEdge(int bucket) {
+  if (bucket < 4) {
+    return bucket;
+  }
+  int msb = bucket / 4 + 1;
+  return ((uint32_t)(5 + bucket % 4) << (msb - 2)) - 1;
+}
+
+static ControlTickStats windowStats(const LatenessWindow& source) {
+  ControlTickStats stats = {};
+  stats.windowTicks = source.ticks;
+  stats.maxLatenessUs = source.maxUs;
+
+  // Smallest bucket edge with at least 99 % of the steps at or below it
+  uint32_t rank = (source.ticks * 99 + 99) / 100;
+  uint32_t seen = 0;
+  for (int i = 0; i < CONTROL_TICK_BUCKETS && source.ticks > 0; i++) {
+    seen += source.counts[i];
+    if (seen >= rank) {
+      stats.p99LatenessUs = i == CONTROL_TICK_BUCKETS - 1 ? source.maxUs : min(bucketUpperEdge(i), source.maxUs);
+      break;
+    }
+  }
+  return stats;
+}
+
+// --- Tick Functions ---
+void controlTickStart(uint32_t period, int64_t nowUs) {
+  beginWrite();
+  periodUs = max(period, (uint32_t)1);
+  nextDeadline = nowUs + periodUs;
+  lastStep = nowUs;
+  ticks = 0;
+  missed = 0;
+  window = LatenessWindow();
+  lastWindowStats = ControlTickStats();
+  windowClosed = false;
+  endWrite();
+}
+
+ControlTick controlTickBegin(int64_t nowUs) {
+  ControlTick tick;
+  int64_t late = max(nowUs - nextDeadline, (int64_t)0);
+  tick.latenessUs = (uint32_t)min(late, (int64_t)UINT32_MAX);
+  tick.missed = (uint32_t)(late / periodUs);
+  tick.dtSec = (nowUs - lastStep) / 1000000.0f;
+
+  beginWrite();
+  nextDeadline += (int64_t)(tick.missed + 1) * periodUs;
+  lastStep = nowUs;
+  ticks++;
+  missed += tick.missed;
+
+  window.counts[latenessBucket(tick.latenessUs)]++;
+  window.maxUs = max(window.maxUs, tick.latenessUs);
+  if (++window.ticks >= CONTROL_TICK_WINDOW) {
+    lastWindowStats = windowStats(window);
+    windowClosed = true;
+    window = LatenessWindow();
+  }
+  endWrite();
+  return tick;
+}
+
+// --- Status Functions ---
+ControlTickStats getControlTickStats() {
+  LatenessWindow current;
+  ControlTickStats stats;
+  bool closed;
+  uint32_t before;
+  do {
+    before = sequence.load(std::memory_order_acquire);
+    current = window;
+    stats = lastWindowStats;
+    closed = windowClosed;
+    stats.periodUs = periodUs;
+    stats.ticks = ticks;
+    stats.missed = missed;
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while ((before & 1) != 0 || sequence.load(std::memory_order_relaxed) != before);
+
+  if (!closed) {
+    ControlTickStats partial = windowStats(current);
+    partial.periodUs = stats.periodUs;
+    partial.ticks = stats.ticks;
+    partial.missed = stats.missed;
+    stats = partial;
+  }
+  return stats;
+}
+
+void printControlTickStatus() {
+  ControlTickStats stats = getControlTickStats();
+  Serial.println("=== Control Tick ===");
+  Serial.printf("Period: %lu ms, %lu steps, %lu missed\n",
+                (unsigned long)(stats.periodUs / 1000), (unsigned long)stats.ticks, (unsigned long)stats.missed);
+  Serial.printf("Lateness over %lu steps: max %.1f ms, p99 %.1f ms\n", (unsigned long)stats.windowTicks,
+                stats.maxLatenessUs / 1000.0f, stats.p99LatenessUs / 1000.0f);
+  Serial.println("====================");
+}
@@ -0,0 +1,43 @@
+#ifndef CONTROL_TICK_H
+#define CONTROL_TICK_H
+
+#include <stdint.h>
+
+// Bookkeeping for the fixed-period control step. A hardware timer
+// (esp_timer in tasks.cpp) releases the control task once per period; each
+// step reports when it actually started and gets back the real time since
+// the previous step as its dt. How far behind its deadline a step started
+// is the jitter the stats below describe.
+//
+// Deadlines stay on the timer's grid, so one late step does not push the
+// next ones back. A step that overran whole periods counts them as missed
+// and catches up once with the full dt instead of running back to back.
+
+// --- Jitter Window ---
+#define CONTROL_TICK_WINDOW   600   // Steps per statistics window, 10 min at 1 Hz
+#define CONTROL_TICK_BUCKETS  96    // Quarter-octave lateness buckets, the last open-ended from ~29 s
+
+struct ControlTick {
+  float dtSec;             // Since the previous step
+  uint32_t latenessUs;     // Behind the oldest deadline this step serves
+  uint32_t missed;         // Whole periods that passed without a step
+};
+
+struct ControlTickStats {
+  uint32_t periodUs;
+  uint32_t ticks;          // Steps since start
+  uint32_t missed;         // Periods without a step since start
+  uint32_t windowTicks;    // Steps the lateness figures cover: the last full window,
+  uint32_t maxLatenessUs;  // or the one being filled until the first closes
+  uint32_t p99LatenessUs;  // Upper edge of its bucket, so within 25 % above the true value
+};
+
+// --- Tick Functions ---
+void controlTickStart(uint32_t periodUs, int64_t nowUs);   // Right before the timer is armed
+ControlTick controlTickBegin(int64_t nowUs);               // First thing in every step
+
+// --- Status Functions ---
+ControlTickStats getControlTickStats();
+void printControlTickStatus();
+
+#endif
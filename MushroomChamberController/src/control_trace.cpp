@@ -0,0 +1,273 @@
+#include "control_trace.h"
+#include "config.h"
+#include "actuators.h"
+#include "sensor_fusion.h"
+#include "controller_store.h"
+#include <Arduino.h>
+#ifdef ARDUINO
+#include <LittleFS.h>
+#endif
+
+#define TRACE_NAN_U16 0xFFFF
+
+// Version in the name, so a layout change never misreads old files
+#define TRACE_LOG_PATH "/trace1.bin"
+#define TRACE_OLD_PATH "/trace1.old"
+
+static TraceWriter traceWriter = NULL;
+static uint8_t chunk[TRACE_CHUNK_RECORDS * TRACE_RECORD_SIZE];
+static size_t chunkRecords = 0;
+static unsigned long recordCount = 0;
+static unsigned long chunksWritten = 0;
+
+// --- Encoding Functions ---
+static void putU16(uint8_t* out, uint16_t value) {
+  out[0] = value & 0xFF;
+  out[1] = value >> 8;
+}
+
+static uint16_t getU16(const uint8_t* in) {
+  return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint16_t encodeUnsigned(float value, float scale) {
+  if (isnan(value)) {
+    return TRACE_NAN_U16;
+  }
+  return (uint16_t)constrain(lroundf(value * scale), 0L, (long)TRACE_NAN_U16 - 1);
+}
+
+static float decodeUnsigned(uint16_t raw, float scale) {
+  return raw == TRACE_NAN_U16 ? NAN : raw / scale;
+}
+
+static void putU32(uint8_t* out, uint32_t value) {
+  putU16(out, value & 0xFFFF);
+  putU16(out + 2, value >> 16);
+}
+
+static uint32_t getU32(const uint8_t* in) {
+  return (uint32_t)getU16(in) | ((uint32_t)getU16(in + 2) << 16);
+}
+
+static void putFloat(uint8_t* out, float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  putU32(out, bits);
+}
+
+static float getFloat(const uint8_t* in) {
+  uint32_t bits = getU32(in);
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+void traceEncode(const TraceRecord& record, uint8_t* out) {
+  putU32(out, record.timestampMs);
+  putFloat(out + 4, record.temperature);
+  putFloat(out + 8, record.humidity);
+  putU16(out + 12, encodeUnsigned(record.pressure, 10.0f));
+  putU16(out + 14, encodeUnsigned(record.targetHumidity, 100.0f));
+  out[16] = ((uint8_t)record.phase << 6) | (((uint8_t)record.health & 0x03) << 4) | (record.state & 0x0F);
+  out[17] = record.actuatorFlags;
+}
+
+void traceDecode(const uint8_t* in, TraceRecord& record) {
+  record.timestampMs = getU32(in);
+  record.temperature = getFloat(in + 4);
+  record.humidity = getFloat(in + 8);
+  record.pressure = decodeUnsigned(getU16(in + 12), 10.0f);
+  record.targetHumidity = decodeUnsigned(getU16(in + 14), 100.0f);
+  record.phase = (GrowthPhase)(in[16] >> 6);
+  record.health = (SensorHealth)((in[16] >> 4) & 0x03);
+  record.state = in[16] & 0x0F;
+  record.actuatorFlags = in[17];
+}
+
+size_t traceFormatLine(const uint8_t* record, char* out, size_t size) {
+  static const char hex[] = "0123456789abcdef";
+  size_t prefixLength = strlen(TRACE_LINE_PREFIX);
+  size_t length = prefixLength + TRACE_RECORD_SIZE * 2;
+  if (size <= length) {
+    return 0;
+  }
+  memcpy(out, TRACE_LINE_PREFIX, prefixLength);
+  for (size_t i = 0; i < TRACE_RECORD_SIZE; i++) {
+    out[prefixLength + i * 2] = hex[record[i] >> 4];
+    out[prefixLength + i * 2 + 1] = hex[record[i] & 0x0F];
+  }
+  out[length] = '\0';
+  return length;
+}
+
+static int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+bool traceParseLine(const char* line, uint8_t* record) {
+  // Tolerates whatever the serial monitor put in front (timestamps, log tags)
+  const char* start = strstr(line, TRACE_LINE_PREFIX);
+  if (start == NULL) {
+    return false;
+  }
+  start += strlen(TRACE_LINE_PREFIX);
+  for (size_t i = 0; i < TRACE_RECORD_SIZE; i++) {
+    int high = hexValue(start[i * 2]);
+    int low = high < 0 ? -1 : hexValue(start[i * 2 + 1]);
+    if (low < 0) {
+      return false;
+    }
+    record[i] = (uint8_t)((high << 4) | low);
+  }
+  return true;
+}
+
+// --- Recording Functions ---
+static void appendEncoded(const uint8_t* record) {
+  memcpy(chunk + chunkRecords * TRACE_RECORD_SIZE, record, TRACE_RECORD_SIZE);
+  chunkRecords++;
+  recordCount++;
+  if (chunkRecords == TRACE_CHUNK_RECORDS) {
+    traceFlush();
+  }
+}
+
+static void appendRecord(const TraceRecord& record) {
+  uint8_t encoded[TRACE_RECORD_SIZE];
+  traceEncode(record, encoded);
+  appendEncoded(encoded);
+}
+
+// The checkpoint setupActuators() restores right after the boot marker,
+// so a replay resumes from the same learned state
+static void appendCheckpoint() {
+  uint8_t blob[CONTROLLER_STORE_MAX_BYTES];
+  size_t length = readStoredControllerCheckpoint(blob, sizeof(blob));
+  for (size_t offset = 0; offset < length; offset += TRACE_CHECKPOINT_BYTES) {
+    uint8_t record[TRACE_RECORD_SIZE] = {};
+    size_t used = min(length - offset, (size_t)TRACE_CHECKPOINT_BYTES);
+    memcpy(record, blob + offset, used);
+    record[16] = TRACE_STATE_CHECKPOINT;
+    record[17] = (uint8_t)used;
+    appendEncoded(record);
+  }
+}
+
+void traceSetup(TraceWriter writer) {
+  traceWriter = writer;
+  chunkRecords = 0;
+  if (writer == NULL) {
+    return;
+  }
+
+  TraceRecord boot = {};
+  boot.timestampMs = millis();
+  boot.temperature = NAN;
+  boot.humidity = NAN;
+  boot.pressure = NAN;
+  boot.targetHumidity = activePhaseConfig.targetHumidity;
+  boot.phase = currentPhase;
+  boot.health = getFusedHealth();
+  boot.state = TRACE_STATE_BOOT;
+  appendRecord(boot);
+  appendCheckpoint();
+}
+
+void traceRecord(float humidity, float temperature, float pressure) {
+  if (traceWriter == NULL) {
+    return;
+  }
+
+  TraceRecord record;
+  record.timestampMs = millis();
+  record.temperature = temperature;
+  record.humidity = humidity;
+  record.pressure = pressure;
+  record.targetHumidity = activePhaseConfig.targetHumidity;
+  record.phase = currentPhase;
+  record.health = getFusedHealth();
+  record.state = (uint8_t)getControllerState();
+  record.actuatorFlags = getActuatorFlags() |
+                         (getControlMode() == ControlMode::PID ? TRACE_FLAG_PID_MODE : 0);
+  appendRecord(record);
+}
+
+void traceFlush() {
+  if (traceWriter != NULL && chunkRecords > 0) {
+    traceWriter(chunk, chunkRecords * TRACE_RECORD_SIZE);
+    chunksWritten++;
+  }
+  chunkRecords = 0;
+}
+
+// --- Writers ---
+void traceSerialWriter(const uint8_t* data, size_t length) {
+  char line[64];
+  for (size_t offset = 0; offset + TRACE_RECORD_SIZE <= length; offset += TRACE_RECORD_SIZE) {
+    if (traceFormatLine(data + offset, line, sizeof(line)) > 0) {
+      Serial.println(line);
+    }
+  }
+}
+
+#ifdef ARDUINO
+void traceFlashWriter(const uint8_t* data, size_t length) {
+  // LittleFS is mounted by setupSpool()
+  File log = LittleFS.open(TRACE_LOG_PATH, FILE_APPEND);
+  if (!log) {
+    return;
+  }
+  size_t size = log.size();
+  if (size + length > TRACE_FLASH_MAX_BYTES) {
+    // Rotate: the current file becomes the old one, the previous old one is dropped
+    log.close();
+    LittleFS.remove(TRACE_OLD_PATH);
+    LittleFS.rename(TRACE_LOG_PATH, TRACE_OLD_PATH);
+    log = LittleFS.open(TRACE_LOG_PATH, FILE_APPEND);
+    if (!log) {
+      return;
+    }
+  }
+  log.write(data, length);
+  log.close();
+}
+
+static void dumpFile(const char* path) {
+  File log = LittleFS.open(path, FILE_READ);
+  if (!log) {
+    return;
+  }
+  uint8_t record[TRACE_RECORD_SIZE];
+  while (log.read(record, sizeof(record)) == sizeof(record)) {
+    traceSerialWriter(record, sizeof(record));
+  }
+  log.close();
+}
+
+void traceDumpFlash() {
+  traceFlush();
+  dumpFile(TRACE_OLD_PATH);
+  dumpFile(TRACE_LOG_PATH);
+}
+#endif
+
+// --- Status Functions ---
+TraceStats getTraceStats() {
+  TraceStats stats;
+  stats.records = recordCount;
+  stats.chunksWritten = chunksWritten;
+  stats.buffered = chunkRecords;
+  return stats;
+}
+
+void printTraceStatus() {
+  Serial.println("\n========== Control Trace ==========");
+  Serial.printf("Recording: %s\n", traceWriter != NULL ? "ON" : "OFF");
+  Serial.printf("Records: %lu (%u buffered), chunks written: %lu\n",
+                recordCount, (unsigned)chunkRecords, chunksWritten);
+  Serial.println("===================================");
+}
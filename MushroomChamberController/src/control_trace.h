@@ -0,0 +1,79 @@
+#ifndef CONTROL_TRACE_H
+#define CONTROL_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "mushroom_types.h"
+#include "sensors.h"
+
+// Compact log of every controller decision: the inputs handed to
+// updateActuators(), the target it was steering to and what it decided.
+// Traces are replayed on the host (sim/trace_replay) to diff a new
+// controller build against production behavior.
+
+// --- Record Layout (little-endian, 18 bytes) ---
+//  0  uint32  millis()
+//  4  float   temperature, °C    (bit-exact, so replays hit the same thresholds)
+//  8  float   humidity, %RH
+// 12  uint16  pressure, 0.1 hPa  (only logged by the controller)
+// 14  uint16  target humidity, 0.01 %RH
+// 16  uint8   phase << 6 | health << 4 | controller state
+// 17  uint8   ACTUATOR_FLAG_* | TRACE_FLAG_PID_MODE
+// The boot marker is followed by checkpoint records carrying the
+// controller checkpoint (controller_store.h) the boot resumes from:
+//  0  16 bytes of the stored blob, in order
+// 16  uint8   TRACE_STATE_CHECKPOINT
+// 17  uint8   bytes used, 1-16
+#define TRACE_RECORD_SIZE     18
+#define TRACE_STATE_BOOT      0x0F   // Marker written at boot; the controller starts from the checkpoint
+#define TRACE_STATE_CHECKPOINT 0x0E  // Part of the checkpoint after a boot marker
+#define TRACE_CHECKPOINT_BYTES 16    // Blob bytes per checkpoint record
+#define TRACE_CHUNK_RECORDS   32     // Records buffered per write to the sink
+#define TRACE_FLASH_MAX_BYTES 300000 // Per file; one older file is kept (~9 h at 1 Hz in total)
+#define TRACE_LINE_PREFIX     "TRACE:"
+#define TRACE_FLAG_PID_MODE   0x80   // Controller was in ControlMode::PID
+
+struct TraceRecord {
+  uint32_t timestampMs;
+  float temperature;       // Controller inputs, NaN when missing
+  float humidity;
+  float pressure;
+  float targetHumidity;
+  GrowthPhase phase;
+  SensorHealth health;     // Fused health seen by the controller
+  uint8_t state;           // ControllerState after the decision, or TRACE_STATE_BOOT
+  uint8_t actuatorFlags;   // Including TRACE_FLAG_PID_MODE
+};
+
+struct TraceStats {
+  unsigned long records;
+  unsigned long chunksWritten;
+  size_t buffered;         // Records waiting for the next chunk
+};
+
+// Receives whole records, TRACE_RECORD_SIZE bytes each
+typedef void (*TraceWriter)(const uint8_t* data, size_t length);
+
+// --- Encoding Functions ---
+void traceEncode(const TraceRecord& record, uint8_t* out);
+void traceDecode(const uint8_t* in, TraceRecord& record);
+size_t traceFormatLine(const uint8_t* record, char* out, size_t size);   // "TRACE:<36 hex digits>"
+bool traceParseLine(const char* line, uint8_t* record);
+
+// --- Recording Functions ---
+void traceSetup(TraceWriter writer);   // NULL disables recording; writes a boot marker and the checkpoint
+void traceRecord(float humidity, float temperature, float pressure);   // Right after updateActuators()
+void traceFlush();
+
+// --- Writers ---
+void traceSerialWriter(const uint8_t* data, size_t length);   // One TRACE: line per record
+#ifdef ARDUINO
+void traceFlashWriter(const uint8_t* data, size_t length);    // Appends to LittleFS
+void traceDumpFlash();                                        // Prints the flash log as TRACE: lines
+#endif
+
+// --- Status Functions ---
+TraceStats getTraceStats();
+void printTraceStatus();
+
+#endif
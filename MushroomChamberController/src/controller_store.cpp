@@ -0,0 +1,173 @@
+#include "controller_store.h"
+#include "relay_autotune.h"
+#include "ventilation_modes.h"
+#include "hal/hal.h"
+#include <Arduino.h>
+#include <atomic>
+
+#define PHASE_COUNT 3
+
+// Stored layout; the CRC covers everything before it
+struct ControllerBlob {
+  uint16_t version;
+  uint16_t payloadSize;
+  LearnedParameters learned;
+  AutotuneResult tunings[PHASE_COUNT];
+  VentilationModeStats ventilation[PHASE_COUNT];
+  uint32_t crc;
+};
+
+static_assert(sizeof(ControllerBlob) <= CONTROLLER_STORE_MAX_BYTES, "Raise CONTROLLER_STORE_MAX_BYTES");
+
+static ControllerBlob lastWritten;
+static bool haveLastWritten = false;
+static unsigned long lastCheckpoint = 0;
+static bool checkpointRequested = false;
+
+// Filled by the control task while staged is clear, then owned by the
+// writer until it clears the flag again
+static ControllerBlob stagedBlob;
+static std::atomic<bool> staged(false);
+static ControllerStoreStats stats = {};
+
+// --- Utility Functions ---
+uint32_t crc32(const uint8_t* data, size_t length) {
+  // Bitwise CRC-32 (IEEE); a few hundred bytes every 30 min does not need a table
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+static uint32_t blobCrc(const ControllerBlob& blob) {
+  return crc32((const uint8_t*)&blob, offsetof(ControllerBlob, crc));
+}
+
+// --- Store Functions ---
+bool loadControllerCheckpoint(LearnedParameters& learned) {
+  ControllerBlob blob;
+  size_t read = halNvsRead(CONTROLLER_STORE_KEY, &blob, sizeof(blob));
+  if (read == 0) {
+    return false;   // Factory fresh
+  }
+
+  const char* problem = NULL;
+  if (read != sizeof(blob) || blob.payloadSize != sizeof(blob) - sizeof(blob.crc)) {
+    problem = "size";
+  } else if (blob.version != CONTROLLER_STORE_VERSION) {
+    problem = "version";
+  } else if (blob.crc != blobCrc(blob)) {
+    problem = "CRC";
+  }
+  if (problem != NULL) {
+    Serial.printf("⚠️  Discarded controller checkpoint (bad %s) - starting untuned\n", problem);
+    stats.rejected++;
+    halNvsErase(CONTROLLER_STORE_KEY);
+    return false;
+  }
+
+  learned = blob.learned;
+  for (int i = 0; i < PHASE_COUNT; i++) {
+    if (blob.tunings[i].valid) {
+      setPhaseTuning((GrowthPhase)i, blob.tunings[i]);
+    }
+    setVentilationModeStats((GrowthPhase)i, blob.ventilation[i]);
+  }
+  lastWritten = blob;
+  haveLastWritten = true;
+  stats.loads++;
+  return true;
+}
+
+bool isControllerCheckpointDue(unsigned long now) {
+  return checkpointRequested || now - lastCheckpoint >= CONTROLLER_STORE_INTERVAL_MS;
+}
+
+void requestControllerCheckpoint() {
+  checkpointRequested = true;
+}
+
+bool stageControllerCheckpoint(const LearnedParameters& learned, unsigned long now) {
+  if (staged.load(std::memory_order_acquire)) {
+    return false;   // The last one is still being written; stays due
+  }
+  lastCheckpoint = now;
+  checkpointRequested = false;
+
+  ControllerBlob& blob = stagedBlob;
+  memset(&blob, 0, sizeof(blob));   // Deterministic padding for the CRC and the comparison
+  blob.version = CONTROLLER_STORE_VERSION;
+  blob.payloadSize = sizeof(blob) - sizeof(blob.crc);
+  blob.learned = learned;
+  for (int i = 0; i < PHASE_COUNT; i++) {
+    const AutotuneResult* tuning = getPhaseTuning((GrowthPhase)i);
+    if (tuning != NULL) {
+      blob.tunings[i] = *tuning;
+    }
+    blob.ventilation[i] = getVentilationModeStats((GrowthPhase)i);
+  }
+  blob.crc = blobCrc(blob);
+
+  if (haveLastWritten && memcmp(&blob, &lastWritten, sizeof(blob)) == 0) {
+    stats.unchangedSkips++;
+    return true;
+  }
+  staged.store(true, std::memory_order_release);
+  return true;
+}
+
+bool writeStagedControllerCheckpoint() {
+  if (!staged.load(std::memory_order_acquire)) {
+    return true;
+  }
+  bool written = halNvsWrite(CONTROLLER_STORE_KEY, &stagedBlob, sizeof(stagedBlob));
+  if (written) {
+    lastWritten = stagedBlob;
+    haveLastWritten = true;
+    stats.writes++;
+  } else {
+    Serial.println("❌ Controller checkpoint write failed");
+  }
+  staged.store(false, std::memory_order_release);
+  return written;
+}
+
+bool saveControllerCheckpoint(const LearnedParameters& learned, unsigned long now) {
+  writeStagedControllerCheckpoint();
+  return stageControllerCheckpoint(learned, now) && writeStagedControllerCheckpoint();
+}
+
+void clearControllerCheckpoint() {
+  halNvsErase(CONTROLLER_STORE_KEY);
+  haveLastWritten = false;
+  checkpointRequested = false;
+  staged.store(false, std::memory_order_release);
+}
+
+// --- Raw Blob ---
+size_t readStoredControllerCheckpoint(uint8_t* data, size_t maxLength) {
+  return halNvsRead(CONTROLLER_STORE_KEY, data, maxLength);
+}
+
+bool writeStoredControllerCheckpoint(const uint8_t* data, size_t length) {
+  haveLastWritten = false;
+  return halNvsWrite(CONTROLLER_STORE_KEY, data, length);
+}
+
+// --- Status Functions ---
+ControllerStoreStats getControllerStoreStats() {
+  return stats;
+}
+
+void printControllerStoreStatus() {
+  Serial.println("\n========== Controller Store ==========");
+  Serial.printf("Loads: %lu, writes: %lu, unchanged: %lu, rejected: %lu\n",
+                stats.loads, stats.writes, stats.unchangedSkips, stats.rejected);
+  Serial.printf("Checkpoint interval: %lu min (%u bytes)\n",
+                CONTROLLER_STORE_INTERVAL_MS / 60000, (unsigned)sizeof(ControllerBlob));
+  Serial.println("======================================");
+}
@@ -0,0 +1,62 @@
+#ifndef CONTROLLER_STORE_H
+#define CONTROLLER_STORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Checkpoints what the AdaptiveController has learned, plus the per-phase
+// autotune results and ventilation mode scores, to NVS so a reboot resumes
+// at the tuned steady state. The blob carries a layout version and a CRC32; anything that fails
+// either check is discarded and the controller starts from its defaults.
+// The control task only stages a checkpoint; the NVS write, which can
+// stall for a flash erase, is left to a lower-priority task.
+
+#define CONTROLLER_STORE_KEY         "controller"
+#define CONTROLLER_STORE_VERSION     1          // Bump whenever LearnedParameters, AutotuneResult or VentilationModeStats change
+#define CONTROLLER_STORE_INTERVAL_MS 1800000UL  // At most one write per 30 min (48/day)
+#define CONTROLLER_STORE_MAX_BYTES   512        // Room for a copy of the stored blob
+
+struct LearnedParameters {
+  float humidityOvershoot;
+  uint32_t humidifyDuration;       // ms
+  uint32_t ventilationDuration;    // ms
+  float humidityBuildRate;         // %RH/s
+  float humidityDecayRate;         // %RH/s
+  float humidityBeforeVentilation; // Last ventilation, feeds the PID feed-forward
+  float humidityAfterVentilation;
+  float pidIntegral;               // Steady-state humidifier duty
+
+  // Cycle statistics
+  int32_t humidificationCycles;
+  int32_t ventilationCycles;
+  uint32_t totalHumidifyTime;      // ms
+};
+
+struct ControllerStoreStats {
+  unsigned long loads;
+  unsigned long writes;
+  unsigned long unchangedSkips;    // Due checkpoints with nothing new to write
+  unsigned long rejected;          // Blobs dropped for a bad version, size or CRC
+};
+
+// --- Store Functions ---
+bool loadControllerCheckpoint(LearnedParameters& learned);   // Also restores the phase tunings and mode scores
+bool isControllerCheckpointDue(unsigned long now);
+void requestControllerCheckpoint();   // Due at the next check, regardless of the interval
+bool stageControllerCheckpoint(const LearnedParameters& learned, unsigned long now);   // False while one is pending
+bool writeStagedControllerCheckpoint();   // Skips unchanged data; true if nothing failed
+bool saveControllerCheckpoint(const LearnedParameters& learned, unsigned long now);   // Stage and write
+void clearControllerCheckpoint();
+
+// --- Raw Blob (the control trace records the one each boot starts from) ---
+size_t readStoredControllerCheckpoint(uint8_t* data, size_t maxLength);   // Bytes as stored, 0 if none
+bool writeStoredControllerCheckpoint(const uint8_t* data, size_t length); // Checked at the next load
+
+// --- Utility Functions ---
+uint32_t crc32(const uint8_t* data, size_t length);
+
+// --- Status Functions ---
+ControllerStoreStats getControllerStoreStats();
+void printControllerStoreStatus();
+
+#endif
@@ -0,0 +1,84 @@
+#include "fan_driver.h"
+#include "actuator_wear.h"
+#include "hal/hal.h"
+#include <Arduino.h>
+
+// --- Pin Definitions ---
+#define EXHAUST_FAN1_PIN 13
+#define EXHAUST_FAN2_PIN 12
+#define INLET_FAN_PIN 14
+
+static const uint8_t fanPins[FAN_COUNT] = { EXHAUST_FAN1_PIN, EXHAUST_FAN2_PIN, INLET_FAN_PIN };
+
+// --- Driver State ---
+struct FanChannel {
+  float target = 0.0f;
+  float duty = 0.0f;
+};
+
+static FanChannel fans[FAN_COUNT];
+static unsigned long lastRampUpdate = 0;
+
+static void writeDuty(FanId fan, float duty) {
+  if ((duty > 0.0f) != (fans[fan].duty > 0.0f)) {
+    wearRecordSwitch((ActuatorId)(ACTUATOR_EXHAUST_FAN_1 + fan), duty > 0.0f, millis());
+  }
+  fans[fan].duty = duty;
+  halPwmWrite(fanPins[fan], duty);
+}
+
+void setupFanDriver() {
+  for (int i = 0; i < FAN_COUNT; i++) {
+    if (!halPwmSetup(fanPins[i], FAN_PWM_FREQUENCY_HZ)) {
+      Serial.printf("❌ No PWM channel for %s fan (pin %d)\n", fanName((FanId)i), fanPins[i]);
+    }
+    fans[i] = FanChannel();
+    wearRecordSwitch((ActuatorId)(ACTUATOR_EXHAUST_FAN_1 + i), false, millis());
+  }
+  lastRampUpdate = millis();
+}
+
+void setFanTarget(FanId fan, float duty) {
+  if (fan >= FAN_COUNT) {
+    return;
+  }
+  duty = constrain(duty, 0.0f, 1.0f);
+  if (duty > 0.0f) {
+    duty = max(duty, FAN_MIN_RUNNING_DUTY);
+  }
+  fans[fan].target = duty;
+
+  if (duty < fans[fan].duty) {
+    writeDuty(fan, duty);   // Slowing down needs no ramp
+  } else if (fans[fan].duty == 0.0f && duty > 0.0f) {
+    writeDuty(fan, FAN_MIN_RUNNING_DUTY);   // Start at the stall limit, then ramp
+  }
+}
+
+void updateFanDriver(unsigned long now) {
+  float step = FAN_RAMP_PER_SEC * (now - lastRampUpdate) / 1000.0f;
+  lastRampUpdate = now;
+  for (int i = 0; i < FAN_COUNT; i++) {
+    if (fans[i].duty < fans[i].target) {
+      writeDuty((FanId)i, min(fans[i].duty + step, fans[i].target));
+    }
+  }
+}
+
+// --- Status Functions ---
+float getFanTarget(FanId fan) {
+  return fan < FAN_COUNT ? fans[fan].target : 0.0f;
+}
+
+float getFanDuty(FanId fan) {
+  return fan < FAN_COUNT ? fans[fan].duty : 0.0f;
+}
+
+const char* fanName(FanId fan) {
+  switch (fan) {
+    case FAN_EXHAUST_1: return "exhaust 1";
+    case FAN_EXHAUST_2: return "exhaust 2";
+    case FAN_INLET: return "inlet";
+    default: return "unknown";
+  }
+}
@@ -0,0 +1,33 @@
+#ifndef FAN_DRIVER_H
+#define FAN_DRIVER_H
+
+#include <stdint.h>
+
+// LEDC PWM driver for the chamber's three 4-wire fans. Each fan has its own
+// duty; rising targets start at the minimum running duty and ramp up so
+// the fans do not kick the supply or the air at full speed, falling
+// targets apply at once.
+
+// --- Driver Parameters ---
+#define FAN_PWM_FREQUENCY_HZ 25000    // Intel 4-wire fan spec, above hearing
+#define FAN_MIN_RUNNING_DUTY 0.2f     // Below this the fans stall; nonzero targets are raised to it
+#define FAN_RAMP_PER_SEC     0.25f    // Full speed about 3 s after a start
+
+enum FanId {
+  FAN_EXHAUST_1,
+  FAN_EXHAUST_2,
+  FAN_INLET,
+  FAN_COUNT
+};
+
+// --- Driver Functions ---
+void setupFanDriver();
+void setFanTarget(FanId fan, float duty);   // 0.0 to 1.0
+void updateFanDriver(unsigned long now);    // Advances the soft-start ramps
+
+// --- Status Functions ---
+float getFanTarget(FanId fan);
+float getFanDuty(FanId fan);                // Duty currently on the pin
+const char* fanName(FanId fan);
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include <FastLED.h>
+
+// Thin hardware layer: the only place the portable modules touch pins,
+// buses, the LED strip, the wall clock or the radio. hal_esp32.cpp backs it
+// with the Arduino/ESP-IDF APIs; hal_native.cpp backs it with an emulated
+// board so the controller, lighting, sensor and telemetry code builds and
+// runs on the host ([env:native]).
+
+// --- Digital Outputs ---
+void halOutputSetup(uint8_t pin);                // Output, driven low
+void halOutputWrite(uint8_t pin, bool high);
+
+// --- PWM Outputs (LEDC on the ESP32) ---
+bool halPwmSetup(uint8_t pin, uint32_t frequencyHz);    // false when out of channels
+void halPwmWrite(uint8_t pin, float duty);               // 0.0 to 1.0
+
+// --- LED Strip (WS2812B on LED_PIN) ---
+void halLedStripSetup(CRGB* leds, uint16_t count);
+void halLedStripShow();
+
+// --- I2C Bus ---
+bool halI2cBegin();
+bool halI2cWrite(uint8_t address, uint8_t reg, uint8_t value);
+bool halI2cRead(uint8_t address, uint8_t reg, uint8_t* buffer, size_t length);  // Repeated-start read
+void halI2cRecoverBus(uint8_t sdaPin, uint8_t sclPin);   // Clocks out a stuck slave, then STOP
+
+// --- DHT22 ---
+void halDhtSetup(uint8_t pin);
+bool halDhtRead(float& temperature, float& humidity);    // false on timeout or checksum error
+
+// --- Wall Clock ---
+time_t halWallClock();                                   // Unix time, 0-based until set
+bool halLocalTime(struct tm& timeinfo);
+void halSetLocalTime(const struct tm& timeinfo);
+// SNTP runs in the background once started; halClockSynced() only checks
+void halStartClockSync(long utcOffsetSec, const char* ntpServer1, const char* ntpServer2, const char* ntpServer3);
+bool halClockSynced();
+
+// --- Network ---
+bool halNetworkConnected();
+int halWifiRssi();
+const char* halDeviceId();                               // MAC address, "AA:BB:CC:DD:EE:FF"
+
+// --- Non-Volatile Storage ---
+// Small blobs by key; every write costs flash wear, so callers throttle
+size_t halNvsRead(const char* key, void* data, size_t length);    // Bytes read, 0 if missing
+bool halNvsWrite(const char* key, const void* data, size_t length);
+void halNvsErase(const char* key);
+
+#ifndef ARDUINO
+// --- Host Emulation Hooks ---
+// Virtual time: millis()/delay() and the wall clock only move when told to
+void halNativeSetMillis(unsigned long ms);
+void halNativeAdvanceMillis(unsigned long ms);
+bool halNativeOutput(uint8_t pin);                      // Also true for a PWM duty above zero
+float halNativePwm(uint8_t pin);
+CRGB halNativeShownLed(uint16_t index);                  // Color at the last halLedStripShow()
+unsigned long halNativeLedShows();
+
+// Register-level I2C device; return false to NAK
+typedef bool (*HalNativeI2cHandler)(uint8_t address, uint8_t reg, uint8_t* data, size_t length, bool write);
+void halNativeSetI2cHandler(HalNativeI2cHandler handler);
+void halNativeSetDhtReading(float temperature, float humidity);   // NaN = sensor absent
+void halNativeSetNetwork(bool connected, int rssi);
+void halNativeClearNvs();                                // Factory-fresh storage
+unsigned long halNativeNvsWrites();
+#endif
+
+#endif
@@ -0,0 +1,207 @@
+#ifdef ARDUINO
+
+#include "hal.h"
+#include "../led.h"
+#include <Arduino.h>
+#include <Wire.h>
+#include <WiFi.h>
+#include <DHT.h>
+#include <Preferences.h>
+#include <sys/time.h>
+
+// --- Digital Outputs ---
+void halOutputSetup(uint8_t pin) {
+  pinMode(pin, OUTPUT);
+  digitalWrite(pin, LOW);
+}
+
+void halOutputWrite(uint8_t pin, bool high) {
+  digitalWrite(pin, high ? HIGH : LOW);
+}
+
+// --- PWM Outputs ---
+// Arduino-ESP32 2.x LEDC API: one channel per pin, handed out in order
+#define PWM_RESOLUTION_BITS 10
+#define PWM_MAX_CHANNELS    16
+
+static uint8_t pwmChannels[SOC_GPIO_PIN_COUNT];   // Channel + 1, zero while unassigned
+static uint8_t pwmChannelsUsed = 0;
+
+bool halPwmSetup(uint8_t pin, uint32_t frequencyHz) {
+  if (pin >= SOC_GPIO_PIN_COUNT) {
+    return false;
+  }
+  if (pwmChannels[pin] == 0) {
+    if (pwmChannelsUsed >= PWM_MAX_CHANNELS) {
+      return false;
+    }
+    pwmChannels[pin] = ++pwmChannelsUsed;
+  }
+  uint8_t channel = pwmChannels[pin] - 1;
+  ledcSetup(channel, frequencyHz, PWM_RESOLUTION_BITS);
+  ledcAttachPin(pin, channel);
+  ledcWrite(channel, 0);
+  return true;
+}
+
+void halPwmWrite(uint8_t pin, float duty) {
+  if (pin < SOC_GPIO_PIN_COUNT && pwmChannels[pin] != 0) {
+    uint32_t maxDuty = (1UL << PWM_RESOLUTION_BITS) - 1;
+    ledcWrite(pwmChannels[pin] - 1, (uint32_t)(constrain(duty, 0.0f, 1.0f) * maxDuty + 0.5f));
+  }
+}
+
+// --- LED Strip ---
+void halLedStripSetup(CRGB* leds, uint16_t count) {
+  FastLED.addLeds<WS2812B, LED_PIN, GRB>(leds, count);
+}
+
+void halLedStripShow() {
+  FastLED.show();
+}
+
+// --- I2C Bus ---
+bool halI2cBegin() {
+  return Wire.begin();
+}
+
+bool halI2cWrite(uint8_t address, uint8_t reg, uint8_t value) {
+  Wire.beginTransmission(address);
+  Wire.write(reg);
+  Wire.write(value);
+  return Wire.endTransmission() == 0;
+}
+
+bool halI2cRead(uint8_t address, uint8_t reg, uint8_t* buffer, size_t length) {
+  Wire.beginTransmission(address);
+  Wire.write(reg);
+  if (Wire.endTransmission(false) != 0) {
+    return false;
+  }
+  if (Wire.requestFrom(address, (uint8_t)length) != length) {
+    return false;
+  }
+  return Wire.readBytes(buffer, length) == length;
+}
+
+// A slave stuck mid-byte holds SDA low; clocking SCL until it lets go and
+// issuing a STOP frees the bus without a power cycle
+void halI2cRecoverBus(uint8_t sdaPin, uint8_t sclPin) {
+  Wire.end();
+
+  pinMode(sdaPin, INPUT_PULLUP);
+  pinMode(sclPin, OUTPUT_OPEN_DRAIN);
+  for (int i = 0; i < 9 && digitalRead(sdaPin) == LOW; i++) {
+    digitalWrite(sclPin, LOW);
+    delayMicroseconds(5);
+    digitalWrite(sclPin, HIGH);
+    delayMicroseconds(5);
+  }
+
+  pinMode(sdaPin, OUTPUT_OPEN_DRAIN);
+  digitalWrite(sdaPin, LOW);
+  delayMicroseconds(5);
+  digitalWrite(sclPin, HIGH);
+  delayMicroseconds(5);
+  digitalWrite(sdaPin, HIGH);
+  delayMicroseconds(5);
+}
+
+// --- DHT22 ---
+static DHT* dht = NULL;
+
+void halDhtSetup(uint8_t pin) {
+  if (dht == NULL) {
+    dht = new DHT(pin, DHT22);   // Once at boot
+  }
+  dht->begin();
+}
+
+bool halDhtRead(float& temperature, float& humidity) {
+  if (dht == NULL) {
+    return false;
+  }
+  // readHumidity() runs the conversion, readTemperature() reuses its frame
+  humidity = dht->readHumidity();
+  temperature = dht->readTemperature();
+  return !isnan(humidity) && !isnan(temperature);
+}
+
+// --- Wall Clock ---
+time_t halWallClock() {
+  return time(NULL);
+}
+
+bool halLocalTime(struct tm& timeinfo) {
+  time_t now = time(NULL);
+  localtime_r(&now, &timeinfo);
+  return timeinfo.tm_year + 1900 >= 2020;
+}
+
+void halSetLocalTime(const struct tm& timeinfo) {
+  struct tm local = timeinfo;
+  struct timeval now = { .tv_sec = mktime(&local) };
+  settimeofday(&now, NULL);
+}
+
+void halStartClockSync(long utcOffsetSec, const char* ntpServer1, const char* ntpServer2, const char* ntpServer3) {
+  configTime(utcOffsetSec, 0, ntpServer1, ntpServer2, ntpServer3);
+}
+
+bool halClockSynced() {
+  struct tm timeinfo;
+  return getLocalTime(&timeinfo, 0) && timeinfo.tm_year + 1900 >= 2020;
+}
+
+// --- Network ---
+bool halNetworkConnected() {
+  return WiFi.status() == WL_CONNECTED;
+}
+
+int halWifiRssi() {
+  return WiFi.RSSI();
+}
+
+const char* halDeviceId() {
+  // Factory MAC from eFuse: valid before the WiFi driver is started
+  static char deviceId[18] = "";
+  if (deviceId[0] == '\0') {
+    uint64_t mac = ESP.getEfuseMac();
+    const uint8_t* bytes = (const uint8_t*)&mac;
+    snprintf(deviceId, sizeof(deviceId), "%02X:%02X:%02X:%02X:%02X:%02X",
+             bytes[0], bytes[1], bytes[2], bytes[3], bytes[4], bytes[5]);
+  }
+  return deviceId;
+}
+
+// --- Non-Volatile Storage ---
+#define NVS_NAMESPACE "chamber"
+
+static Preferences preferences;
+static bool preferencesOpen = false;
+
+static bool openPreferences() {
+  if (!preferencesOpen) {
+    preferencesOpen = preferences.begin(NVS_NAMESPACE, false);
+  }
+  return preferencesOpen;
+}
+
+size_t halNvsRead(const char* key, void* data, size_t length) {
+  if (!openPreferences() || !preferences.isKey(key)) {
+    return 0;
+  }
+  return preferences.getBytes(key, data, length);
+}
+
+bool halNvsWrite(const char* key, const void* data, size_t length) {
+  return openPreferences() && preferences.putBytes(key, data, length) == length;
+}
+
+void halNvsErase(const char* key) {
+  if (openPreferences()) {
+    preferences.remove(key);
+  }
+}
+
+#endif
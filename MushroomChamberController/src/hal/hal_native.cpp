@@ -0,0 +1,235 @@
+#ifndef ARDUINO
+
+#include "hal.h"
+#include <Arduino.h>
+#include <stdarg.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// --- Emulated Board State ---
+#define NATIVE_PIN_COUNT 40
+#define NATIVE_LED_MAX   256
+
+static uint64_t virtualMicros = 0;
+static time_t wallClockBase = 0;             // Wall clock at millis() == wallClockSetAt
+static unsigned long wallClockSetAt = 0;
+static bool outputs[NATIVE_PIN_COUNT];
+static float pwmDuty[NATIVE_PIN_COUNT];
+static CRGB* ledStrip = NULL;
+static uint16_t ledCount = 0;
+static CRGB shownLeds[NATIVE_LED_MAX];
+static unsigned long ledShows = 0;
+static HalNativeI2cHandler i2cHandler = NULL;
+static float dhtTemperature = NAN;
+static float dhtHumidity = NAN;
+static bool networkConnected = false;
+static int networkRssi = 0;
+static std::map<std::string, std::vector<uint8_t>> nvs;
+static unsigned long nvsWrites = 0;
+
+HardwareSerial Serial;
+
+size_t HardwareSerial::printf(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  int written = enabled ? vprintf(format, args) : vsnprintf(NULL, 0, format, args);
+  va_end(args);
+  return written > 0 ? written : 0;
+}
+
+// Suites written for the board run unchanged: setup() runs them once
+__attribute__((weak)) void setup() {}
+
+__attribute__((weak)) int main() {
+  setup();
+  return 0;
+}
+
+// --- Time ---
+unsigned long millis() {
+  return (unsigned long)(virtualMicros / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)virtualMicros;
+}
+
+void delay(unsigned long ms) {
+  virtualMicros += ms * 1000ULL;
+}
+
+void delayMicroseconds(unsigned int us) {
+  virtualMicros += us;
+}
+
+void halNativeSetMillis(unsigned long ms) {
+  virtualMicros = ms * 1000ULL;
+}
+
+void halNativeAdvanceMillis(unsigned long ms) {
+  virtualMicros += ms * 1000ULL;
+}
+
+// --- Digital Outputs ---
+void halOutputSetup(uint8_t pin) {
+  halOutputWrite(pin, false);
+}
+
+void halOutputWrite(uint8_t pin, bool high) {
+  if (pin < NATIVE_PIN_COUNT) {
+    outputs[pin] = high;
+  }
+}
+
+// --- PWM Outputs ---
+bool halPwmSetup(uint8_t pin, uint32_t) {
+  halPwmWrite(pin, 0.0f);
+  return pin < NATIVE_PIN_COUNT;
+}
+
+void halPwmWrite(uint8_t pin, float duty) {
+  if (pin < NATIVE_PIN_COUNT) {
+    pwmDuty[pin] = constrain(duty, 0.0f, 1.0f);
+    outputs[pin] = pwmDuty[pin] > 0.0f;
+  }
+}
+
+float halNativePwm(uint8_t pin) {
+  return pin < NATIVE_PIN_COUNT ? pwmDuty[pin] : 0.0f;
+}
+
+bool halNativeOutput(uint8_t pin) {
+  return pin < NATIVE_PIN_COUNT && outputs[pin];
+}
+
+// --- LED Strip ---
+void halLedStripSetup(CRGB* leds, uint16_t count) {
+  ledStrip = leds;
+  ledCount = min(count, (uint16_t)NATIVE_LED_MAX);
+}
+
+void halLedStripShow() {
+  for (uint16_t i = 0; i < ledCount; i++) {
+    shownLeds[i] = ledStrip[i];
+  }
+  ledShows++;
+}
+
+CRGB halNativeShownLed(uint16_t index) {
+  return index < ledCount ? shownLeds[index] : CRGB();
+}
+
+unsigned long halNativeLedShows() {
+  return ledShows;
+}
+
+// --- I2C Bus ---
+bool halI2cBegin() {
+  return true;
+}
+
+bool halI2cWrite(uint8_t address, uint8_t reg, uint8_t value) {
+  return i2cHandler != NULL && i2cHandler(address, reg, &value, 1, true);
+}
+
+bool halI2cRead(uint8_t address, uint8_t reg, uint8_t* buffer, size_t length) {
+  return i2cHandler != NULL && i2cHandler(address, reg, buffer, length, false);
+}
+
+void halI2cRecoverBus(uint8_t, uint8_t) {
+}
+
+void halNativeSetI2cHandler(HalNativeI2cHandler handler) {
+  i2cHandler = handler;
+}
+
+// --- DHT22 ---
+void halDhtSetup(uint8_t) {
+}
+
+bool halDhtRead(float& temperature, float& humidity) {
+  temperature = dhtTemperature;
+  humidity = dhtHumidity;
+  return !isnan(temperature) && !isnan(humidity);
+}
+
+void halNativeSetDhtReading(float temperature, float humidity) {
+  dhtTemperature = temperature;
+  dhtHumidity = humidity;
+}
+
+// --- Wall Clock ---
+// Runs off virtual time in UTC, so lighting schedules are independent of the host zone
+time_t halWallClock() {
+  return wallClockBase + (time_t)((millis() - wallClockSetAt) / 1000);
+}
+
+bool halLocalTime(struct tm& timeinfo) {
+  time_t now = halWallClock();
+  gmtime_r(&now, &timeinfo);
+  return timeinfo.tm_year + 1900 >= 2020;
+}
+
+void halSetLocalTime(const struct tm& timeinfo) {
+  struct tm local = timeinfo;
+  wallClockBase = timegm(&local);
+  wallClockSetAt = millis();
+}
+
+void halStartClockSync(long, const char*, const char*, const char*) {
+}
+
+bool halClockSynced() {
+  return false;   // No NTP on the host; tests set the clock with setManualTime()
+}
+
+// --- Network ---
+bool halNetworkConnected() {
+  return networkConnected;
+}
+
+int halWifiRssi() {
+  return networkRssi;
+}
+
+const char* halDeviceId() {
+  return "00:00:00:00:00:00";
+}
+
+void halNativeSetNetwork(bool connected, int rssi) {
+  networkConnected = connected;
+  networkRssi = rssi;
+}
+
+// --- Non-Volatile Storage ---
+size_t halNvsRead(const char* key, void* data, size_t length) {
+  auto entry = nvs.find(key);
+  if (entry == nvs.end()) {
+    return 0;
+  }
+  size_t copied = min(length, entry->second.size());
+  memcpy(data, entry->second.data(), copied);
+  return copied;
+}
+
+bool halNvsWrite(const char* key, const void* data, size_t length) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  nvs[key].assign(bytes, bytes + length);
+  nvsWrites++;
+  return true;
+}
+
+void halNvsErase(const char* key) {
+  nvs.erase(key);
+}
+
+void halNativeClearNvs() {
+  nvs.clear();
+}
+
+unsigned long halNativeNvsWrites() {
+  return nvsWrites;
+}
+
+#endif
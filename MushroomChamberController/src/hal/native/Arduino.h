@@ -0,0 +1,101 @@
+#ifndef HAL_NATIVE_ARDUINO_H
+#define HAL_NATIVE_ARDUINO_H
+
+// The part of the Arduino core the portable modules use, for host builds.
+// Only found through -Isrc/hal/native in [env:native]; time is virtual and
+// driven by the hooks in hal/hal.h.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <cmath>
+#include <algorithm>
+#include <string>
+
+using std::min;
+using std::max;
+using std::abs;
+
+#define PI 3.1415926535897932384626433832795
+
+#define constrain(value, low, high) ((value) < (low) ? (low) : ((value) > (high) ? (high) : (value)))
+
+// --- Time ---
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// --- String ---
+class String {
+ public:
+  String() {}
+  String(const char* text) : value(text ? text : "") {}
+  String(const std::string& text) : value(text) {}
+  String(int number) : value(std::to_string(number)) {}
+  String(long number) : value(std::to_string(number)) {}
+  String(unsigned int number) : value(std::to_string(number)) {}
+  String(unsigned long number) : value(std::to_string(number)) {}
+
+  const char* c_str() const { return value.c_str(); }
+  unsigned int length() const { return value.length(); }
+  bool isEmpty() const { return value.empty(); }
+  int indexOf(const char* text) const {
+    size_t pos = value.find(text);
+    return pos == std::string::npos ? -1 : (int)pos;
+  }
+  int indexOf(char c) const {
+    size_t pos = value.find(c);
+    return pos == std::string::npos ? -1 : (int)pos;
+  }
+  bool startsWith(const char* prefix) const { return value.compare(0, strlen(prefix), prefix) == 0; }
+
+  String& operator+=(const String& other) { value += other.value; return *this; }
+  String& operator+=(const char* other) { value += other; return *this; }
+  String& operator+=(char c) { value += c; return *this; }
+  friend String operator+(String left, const String& right) { return left += right; }
+  friend String operator+(String left, const char* right) { return left += right; }
+  bool operator==(const String& other) const { return value == other.value; }
+  bool operator==(const char* other) const { return value == other; }
+  bool operator!=(const String& other) const { return value != other.value; }
+  bool operator!=(const char* other) const { return value != other; }
+
+ private:
+  std::string value;
+};
+
+// --- Serial (stdout) ---
+class HardwareSerial {
+ public:
+  void begin(unsigned long baud) {}
+  void flush() { fflush(stdout); }
+  void setOutputEnabled(bool on) { enabled = on; }   // Host only: silences long simulations
+  bool outputEnabled() const { return enabled; }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+  size_t print(const char* text) { return !enabled || fputs(text, stdout) >= 0 ? strlen(text) : 0; }
+  size_t print(const String& text) { return print(text.c_str()); }
+  size_t print(char c) { return !enabled || putchar(c) != EOF ? 1 : 0; }
+  size_t print(int number) { return printf("%d", number); }
+  size_t print(long number) { return printf("%ld", number); }
+  size_t print(unsigned int number) { return printf("%u", number); }
+  size_t print(unsigned long number) { return printf("%lu", number); }
+  size_t print(double number, int digits = 2) { return printf("%.*f", digits, number); }
+
+  template <typename T>
+  size_t println(const T& value) { return print(value) + println(); }
+  size_t println(double number, int digits) { return print(number, digits) + println(); }
+  size_t println() { return print("\n"); }
+
+  operator bool() const { return true; }
+
+ private:
+  bool enabled = true;
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef HAL_NATIVE_FASTLED_H
+#define HAL_NATIVE_FASTLED_H
+
+#include <stdint.h>
+
+// CRGB only; the strip itself is driven through halLedStripSetup()/Show()
+struct CRGB {
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+
+  enum HTMLColorCode : uint32_t {
+    Black = 0x000000,
+    White = 0xFFFFFF,
+    Red = 0xFF0000,
+    Green = 0x008000,
+    Blue = 0x0000FF,
+    Purple = 0x800080,
+    Yellow = 0xFFFF00,
+    Cyan = 0x00FFFF
+  };
+
+  CRGB() : r(0), g(0), b(0) {}
+  CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+  CRGB(uint32_t colorCode) : r((colorCode >> 16) & 0xFF), g((colorCode >> 8) & 0xFF), b(colorCode & 0xFF) {}
+  CRGB(HTMLColorCode colorCode) : CRGB((uint32_t)colorCode) {}
+
+  bool operator==(const CRGB& other) const { return r == other.r && g == other.g && b == other.b; }
+  bool operator!=(const CRGB& other) const { return !(*this == other); }
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef HAL_NATIVE_LITTLEFS_H
+#define HAL_NATIVE_LITTLEFS_H
+
+// The part of the LittleFS API the flash logs use, for host builds. Files
+// live in memory for the life of the test binary; format() wipes them, as
+// a factory-fresh partition would be.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+class File {
+ public:
+  File() {}
+  File(std::vector<uint8_t>* data, bool writable, size_t position)
+    : data(data), writable(writable), position(position) {}
+
+  explicit operator bool() const { return data != NULL; }
+
+  size_t write(const uint8_t* bytes, size_t length) {
+    if (data == NULL || !writable) {
+      return 0;
+    }
+    if (data->size() < position + length) {
+      data->resize(position + length);
+    }
+    memcpy(data->data() + position, bytes, length);
+    position += length;
+    return length;
+  }
+  size_t read(uint8_t* bytes, size_t length) {
+    if (data == NULL || position >= data->size()) {
+      return 0;
+    }
+    length = std::min(length, data->size() - position);
+    memcpy(bytes, data->data() + position, length);
+    position += length;
+    return length;
+  }
+  bool seek(uint32_t offset) {
+    if (data == NULL || offset > data->size()) {
+      return false;
+    }
+    position = offset;
+    return true;
+  }
+  size_t size() const { return data != NULL ? data->size() : 0; }
+  void close() { data = NULL; }
+
+ private:
+  std::vector<uint8_t>* data = NULL;
+  bool writable = false;
+  size_t position = 0;
+};
+
+class LittleFSFS {
+ public:
+  bool begin(bool formatOnFail = false) { return true; }
+  bool format() {
+    files.clear();
+    return true;
+  }
+  bool exists(const char* path) { return files.count(path) > 0; }
+  bool remove(const char* path) { return files.erase(path) > 0; }
+  bool rename(const char* from, const char* to) {
+    auto file = files.find(from);
+    if (file == files.end()) {
+      return false;
+    }
+    files[to] = file->second;
+    files.erase(from);
+    return true;
+  }
+  File open(const char* path, const char* mode) {
+    if (strcmp(mode, FILE_READ) == 0) {
+      auto file = files.find(path);
+      return file == files.end() ? File() : File(&file->second, false, 0);
+    }
+    std::vector<uint8_t>& data = files[path];
+    if (strcmp(mode, FILE_WRITE) == 0) {
+      data.clear();
+    }
+    return File(&data, true, data.size());
+  }
+
+ private:
+  std::map<std::string, std::vector<uint8_t>> files;
+};
+
+inline LittleFSFS LittleFS;
+
+#endif
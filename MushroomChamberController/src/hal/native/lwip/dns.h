@@ -0,0 +1,41 @@
+#ifndef HAL_NATIVE_LWIP_DNS_H
+#define HAL_NATIVE_LWIP_DNS_H
+
+// Host stand-in for lwIP's asynchronous DNS: the system resolver answers
+// at once, so the found callback is never used
+#include <stdint.h>
+#include <string.h>
+#include <netdb.h>
+#include <netinet/in.h>
+
+typedef int8_t err_t;
+#define ERR_OK         0
+#define ERR_INPROGRESS -5
+#define ERR_ARG        -16
+
+typedef struct { uint32_t addr; } ip4_addr_t;   // Network byte order
+typedef ip4_addr_t ip_addr_t;                   // IPv4 only
+#define IP_IS_V4(ipaddr)         1
+#define ip_2_ip4(ipaddr)         (ipaddr)
+#define ip4_addr_get_u32(ip4)    ((ip4)->addr)
+
+typedef void (*dns_found_callback)(const char* name, const ip_addr_t* ipaddr, void* callbackArg);
+
+static inline err_t dns_gethostbyname(const char* hostname, ip_addr_t* addr,
+                                      dns_found_callback found, void* callbackArg) {
+  (void)found;
+  (void)callbackArg;
+  struct addrinfo hints;
+  struct addrinfo* result = NULL;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(hostname, NULL, &hints, &result) != 0 || result == NULL) {
+    return ERR_ARG;
+  }
+  addr->addr = ((struct sockaddr_in*)result->ai_addr)->sin_addr.s_addr;
+  freeaddrinfo(result);
+  return ERR_OK;
+}
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef HAL_NATIVE_LWIP_SOCKETS_H
+#define HAL_NATIVE_LWIP_SOCKETS_H
+
+// lwIP speaks the BSD socket API, so host builds use the system's
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#endif
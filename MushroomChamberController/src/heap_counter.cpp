@@ -0,0 +1,55 @@
+#include "heap_counter.h"
+#include <stddef.h>
+
+#ifdef HEAP_ALLOC_COUNTER
+
+// Incremented from any task; a lost update only makes a test fail loudly
+static volatile uint32_t allocCount = 0;
+
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+  allocCount++;
+  return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+  allocCount++;
+  return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+  allocCount++;
+  return __real_realloc(ptr, size);
+}
+}
+
+void resetHeapAllocCount() {
+  allocCount = 0;
+}
+
+uint32_t getHeapAllocCount() {
+  return allocCount;
+}
+
+bool heapAllocCounterEnabled() {
+  return true;
+}
+
+#else
+
+void resetHeapAllocCount() {
+}
+
+uint32_t getHeapAllocCount() {
+  return 0;
+}
+
+bool heapAllocCounterEnabled() {
+  return false;
+}
+
+#endif
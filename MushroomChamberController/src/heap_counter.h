@@ -0,0 +1,15 @@
+#ifndef HEAP_COUNTER_H
+#define HEAP_COUNTER_H
+
+#include <stdint.h>
+
+// Counts malloc/calloc/realloc calls when built with -DHEAP_ALLOC_COUNTER and
+// the matching -Wl,--wrap flags (see esp32_telemetry_alloc_test in platformio.ini).
+// In normal builds the counter is compiled out and always reads 0.
+
+// --- Counter Functions ---
+void resetHeapAllocCount();
+uint32_t getHeapAllocCount();
+bool heapAllocCounterEnabled();
+
+#endif
@@ -0,0 +1,671 @@
+#include "http_async.h"
+#include <Arduino.h>
+#include <lwip/sockets.h>
+#include <lwip/dns.h>
+#include <strings.h>
+
+// --- Server Address ---
+static char serverHost[64] = "";
+static char basePath[64] = "";
+static uint16_t serverPort = 80;
+static struct sockaddr_in serverAddr;
+static bool serverResolved = false;
+static bool serverIsName = false;               // Looked up by DNS, so it can move
+
+// Host names are looked up with lwIP's asynchronous DNS. The answer comes
+// back on the lwIP thread; the generation tells a stale one (from before
+// the last httpAsyncSetup()) apart.
+static volatile bool lookupPending = false;
+static volatile bool lookupAnswered = false;
+static volatile uint32_t lookupAddress = 0;    // Network byte order, 0 = not found
+static volatile uintptr_t lookupGeneration = 0;
+
+static unsigned long requestTimeout = 5000;     // 5 seconds
+static unsigned long keepAliveIdleTime = 25000; // Close idle connection before the server does
+
+// --- Keep-Alive Connections ---
+// Regular requests are pipelined over the shared connection. Long-poll
+// requests get their own so a held request never blocks the others.
+struct Connection {
+  HttpConnectionState state = HttpConnectionState::CLOSED;
+  int sock = -1;
+  char rx[HTTP_ASYNC_RX_SIZE];
+  size_t rxLength = 0;
+  unsigned long requestsSent = 0;     // Requests written on this connection
+  unsigned long lastActivity = 0;
+  bool closeAfterResponse = false;    // Server asked for Connection: close
+
+  // Requests in the order they were written; responses arrive in the same order
+  HttpEndpoint pipeline[ENDPOINT_COUNT];
+  int pipelineLength = 0;
+};
+
+#define SHARED_CONNECTION    0
+#define LONG_POLL_CONNECTION 1
+#define CONNECTION_COUNT     2
+
+static Connection connections[CONNECTION_COUNT];
+static HttpConnectionStats stats = {};
+
+static Connection& connectionFor(HttpEndpoint endpoint) {
+  return connections[endpoint == ENDPOINT_PHASE_WATCH ? LONG_POLL_CONNECTION : SHARED_CONNECTION];
+}
+
+// --- Request Slots ---
+struct AsyncSlot {
+  HttpRequestState state = HttpRequestState::IDLE;
+
+  char request[HTTP_ASYNC_REQUEST_SIZE];
+  size_t requestLength = 0;
+  size_t requestSent = 0;
+
+  char response[HTTP_ASYNC_RESPONSE_SIZE];
+  long contentLength = -1;      // -1 until known
+  int statusCode = -1;
+  bool retried = false;         // Already replayed once on a fresh connection
+
+  unsigned long startTime = 0;
+  unsigned long timeout = 0;    // 0 = requestTimeout
+  const char* error = "";
+
+  HttpResponseCallback callback = NULL;
+  void* context = NULL;
+};
+
+static AsyncSlot slots[ENDPOINT_COUNT];
+
+bool httpAsyncSetup(const char* serverUrl) {
+  for (int i = 0; i < ENDPOINT_COUNT; i++) {
+    httpAsyncCancel((HttpEndpoint)i);
+  }
+
+  serverResolved = false;
+  serverIsName = false;
+  lookupGeneration++;
+  lookupPending = false;
+  lookupAnswered = false;
+  serverHost[0] = '\0';
+  basePath[0] = '\0';
+  serverPort = 80;
+
+  const char* p = serverUrl;
+  if (strncmp(p, "http://", 7) == 0) {
+    p += 7;
+  }
+
+  // host[:port][/base]
+  size_t hostLength = strcspn(p, ":/");
+  if (hostLength == 0 || hostLength >= sizeof(serverHost)) {
+    return false;
+  }
+  memcpy(serverHost, p, hostLength);
+  serverHost[hostLength] = '\0';
+  p += hostLength;
+
+  if (*p == ':') {
+    serverPort = (uint16_t)strtoul(p + 1, (char**)&p, 10);
+  }
+  if (*p == '/') {
+    strncpy(basePath, p, sizeof(basePath) - 1);
+    basePath[sizeof(basePath) - 1] = '\0';
+    size_t length = strlen(basePath);
+    if (length > 0 && basePath[length - 1] == '/') {
+      basePath[length - 1] = '\0';
+    }
+  }
+
+  memset(&serverAddr, 0, sizeof(serverAddr));
+  serverAddr.sin_family = AF_INET;
+  serverAddr.sin_port = htons(serverPort);
+
+  // Literal IPs resolve here; host names are looked up on first use
+  if (inet_aton(serverHost, &serverAddr.sin_addr)) {
+    serverResolved = true;
+  } else {
+    serverIsName = true;
+  }
+  return true;
+}
+
+static void onDnsFound(const char*, const ip_addr_t* ipaddr, void* callbackArg) {
+  if ((uintptr_t)callbackArg != lookupGeneration) {
+    return;
+  }
+  lookupAddress = (ipaddr != NULL && IP_IS_V4(ipaddr)) ? ip4_addr_get_u32(ip_2_ip4(ipaddr)) : 0;
+  lookupAnswered = true;
+}
+
+// Never waits: starts a lookup and returns false until its answer is in.
+// While lookupPending is set the caller keeps its requests queued.
+static bool resolveServer() {
+  if (serverResolved) {
+    return true;
+  }
+  if (serverHost[0] == '\0') {
+    return false;
+  }
+
+  if (lookupAnswered) {
+    lookupAnswered = false;
+    lookupPending = false;
+    serverAddr.sin_addr.s_addr = lookupAddress;
+    serverResolved = lookupAddress != 0;
+    return serverResolved;
+  }
+  if (lookupPending) {
+    return false;
+  }
+
+  ip_addr_t address;
+  err_t result = dns_gethostbyname(serverHost, &address, onDnsFound, (void*)lookupGeneration);
+  if (result == ERR_OK) {   // Cached, or answered at once
+    serverAddr.sin_addr.s_addr = ip4_addr_get_u32(ip_2_ip4(&address));
+    serverResolved = true;
+    return true;
+  }
+  lookupPending = result == ERR_INPROGRESS;
+  return false;
+}
+
+// A server that stopped answering may have moved; look its name up again
+static void forgetServerAddress() {
+  if (serverIsName) {
+    serverResolved = false;
+  }
+}
+
+// --- Pipeline Bookkeeping ---
+
+static void removeFromPipeline(HttpEndpoint endpoint) {
+  Connection& connection = connectionFor(endpoint);
+  for (int i = 0; i < connection.pipelineLength; i++) {
+    if (connection.pipeline[i] == endpoint) {
+      for (int j = i; j < connection.pipelineLength - 1; j++) {
+        connection.pipeline[j] = connection.pipeline[j + 1];
+      }
+      connection.pipelineLength--;
+      return;
+    }
+  }
+}
+
+static void finishSlot(HttpEndpoint endpoint, bool success, const char* error) {
+  AsyncSlot& slot = slots[endpoint];
+  removeFromPipeline(endpoint);
+
+  slot.state = success ? HttpRequestState::COMPLETE : HttpRequestState::FAILED;
+  slot.error = error;
+  if (!success) {
+    stats.failedRequests++;
+  }
+
+  if (slot.callback != NULL) {
+    if (success) {
+      slot.callback(endpoint, true, slot.statusCode, slot.response, slot.context);
+    } else {
+      slot.callback(endpoint, false, -1, error, slot.context);
+    }
+  }
+}
+
+// --- Connection Management ---
+
+static void closeConnection(Connection& connection) {
+  if (connection.sock >= 0) {
+    close(connection.sock);
+    connection.sock = -1;
+  }
+  connection.state = HttpConnectionState::CLOSED;
+  connection.rxLength = 0;
+  connection.requestsSent = 0;
+  connection.closeAfterResponse = false;
+}
+
+// Connection lost or unusable. Requests that never saw a byte of their
+// response are replayed once on a fresh connection; the rest fail.
+static void dropConnection(Connection& connection, const char* error) {
+  bool hadPending = connection.pipelineLength > 0;
+  closeConnection(connection);
+
+  int i = 0;
+  while (i < connection.pipelineLength) {
+    HttpEndpoint endpoint = connection.pipeline[i];
+    AsyncSlot& slot = slots[endpoint];
+    bool untouched = slot.state != HttpRequestState::READING_BODY;
+
+    if (untouched && !slot.retried && slot.requestSent > 0) {
+      slot.retried = true;
+      slot.requestSent = 0;
+      slot.state = HttpRequestState::QUEUED;
+      i++;
+    } else if (slot.requestSent == 0) {
+      // Never written, just wait for the next connection
+      i++;
+    } else {
+      finishSlot(endpoint, false, error);   // Removes it from the pipeline
+    }
+  }
+
+  if (hadPending) {
+    stats.reconnects++;
+  }
+}
+
+static bool openConnection(Connection& connection) {
+  if (!resolveServer()) {
+    return false;
+  }
+
+  connection.sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (connection.sock < 0) {
+    return false;
+  }
+  fcntl(connection.sock, F_SETFL, fcntl(connection.sock, F_GETFL, 0) | O_NONBLOCK);
+
+  int noDelay = 1;
+  setsockopt(connection.sock, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+  connection.rxLength = 0;
+  connection.requestsSent = 0;
+  connection.closeAfterResponse = false;
+  connection.lastActivity = millis();
+  stats.freshConnects++;
+
+  int result = connect(connection.sock, (struct sockaddr*)&serverAddr, sizeof(serverAddr));
+  if (result == 0) {
+    connection.state = HttpConnectionState::OPEN;
+  } else if (errno == EINPROGRESS) {
+    connection.state = HttpConnectionState::CONNECTING;
+  } else {
+    closeConnection(connection);
+    forgetServerAddress();
+    return false;
+  }
+  return true;
+}
+
+static void pollConnecting(Connection& connection) {
+  fd_set writeSet;
+  FD_ZERO(&writeSet);
+  FD_SET(connection.sock, &writeSet);
+  struct timeval zero = { 0, 0 };
+
+  if (select(connection.sock + 1, NULL, &writeSet, NULL, &zero) > 0) {
+    int socketError = 0;
+    socklen_t length = sizeof(socketError);
+    getsockopt(connection.sock, SOL_SOCKET, SO_ERROR, &socketError, &length);
+    if (socketError != 0) {
+      // Server unreachable; fail everything instead of hammering it
+      closeConnection(connection);
+      forgetServerAddress();
+      while (connection.pipelineLength > 0) {
+        finishSlot(connection.pipeline[0], false, "Connection failed");
+      }
+      return;
+    }
+    connection.state = HttpConnectionState::OPEN;
+  }
+}
+
+// --- Request Functions ---
+
+bool httpAsyncStart(HttpEndpoint endpoint, const char* method, const char* path,
+                    const char* contentType, const char* body, size_t bodyLength,
+                    HttpResponseCallback callback, void* context) {
+  if (endpoint >= ENDPOINT_COUNT || isHttpAsyncBusy(endpoint)) {
+    return false;
+  }
+  if (serverHost[0] == '\0') {
+    return false;
+  }
+
+  AsyncSlot& slot = slots[endpoint];
+
+  // Build the whole request up front so sending is a plain byte copy
+  int headerLength;
+  if (body != NULL) {
+    headerLength = snprintf(slot.request, sizeof(slot.request),
+                            "%s %s%s HTTP/1.1\r\n"
+                            "Host: %s:%u\r\n"
+                            "User-Agent: ESP32-Sensor\r\n"
+                            "Connection: keep-alive\r\n"
+                            "Content-Type: %s\r\n"
+                            "Content-Length: %u\r\n"
+                            "\r\n",
+                            method, basePath, path, serverHost, serverPort,
+                            contentType, (unsigned)bodyLength);
+  } else {
+    headerLength = snprintf(slot.request, sizeof(slot.request),
+                            "%s %s%s HTTP/1.1\r\n"
+                            "Host: %s:%u\r\n"
+                            "User-Agent: ESP32-Sensor\r\n"
+                            "Connection: keep-alive\r\n"
+                            "\r\n",
+                            method, basePath, path, serverHost, serverPort);
+    bodyLength = 0;
+  }
+
+  if (headerLength < 0 || (size_t)headerLength + bodyLength > sizeof(slot.request)) {
+    slot.state = HttpRequestState::FAILED;
+    slot.error = "Request too large";
+    return false;
+  }
+  if (bodyLength > 0) {
+    memcpy(slot.request + headerLength, body, bodyLength);
+  }
+
+  slot.requestLength = headerLength + bodyLength;
+  slot.requestSent = 0;
+  slot.response[0] = '\0';
+  slot.contentLength = -1;
+  slot.statusCode = -1;
+  slot.retried = false;
+  slot.error = "";
+  slot.startTime = millis();
+  slot.callback = callback;
+  slot.context = context;
+  slot.state = HttpRequestState::QUEUED;
+
+  Connection& connection = connectionFor(endpoint);
+  connection.pipeline[connection.pipelineLength++] = endpoint;
+  stats.totalRequests++;
+  return true;
+}
+
+// Write queued requests back to back; the server answers them in order
+static void sendPending(Connection& connection) {
+  for (int i = 0; i < connection.pipelineLength; i++) {
+    AsyncSlot& slot = slots[connection.pipeline[i]];
+
+    if (slot.state == HttpRequestState::QUEUED) {
+      if (connection.requestsSent > 0) {
+        stats.reusedRequests++;
+      }
+      connection.requestsSent++;
+      slot.state = HttpRequestState::SENDING;
+    }
+
+    if (slot.state != HttpRequestState::SENDING) {
+      continue;
+    }
+
+    int sent = send(connection.sock, slot.request + slot.requestSent,
+                    slot.requestLength - slot.requestSent, 0);
+    if (sent > 0) {
+      slot.requestSent += sent;
+      connection.lastActivity = millis();
+    } else if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+      dropConnection(connection, "Send failed");
+      return;
+    }
+
+    if (slot.requestSent < slot.requestLength) {
+      return;   // Socket buffer full, keep byte order and retry next poll
+    }
+    slot.state = HttpRequestState::AWAITING_RESPONSE;
+  }
+}
+
+// Case-insensitive lookup of a header value inside the header block
+static const char* findHeader(const char* headers, const char* name) {
+  size_t nameLength = strlen(name);
+  const char* line = headers;
+  while (line != NULL && *line != '\0') {
+    if (strncasecmp(line, name, nameLength) == 0 && line[nameLength] == ':') {
+      const char* value = line + nameLength + 1;
+      while (*value == ' ') {
+        value++;
+      }
+      return value;
+    }
+    line = strstr(line, "\r\n");
+    if (line != NULL) {
+      line += 2;
+    }
+  }
+  return NULL;
+}
+
+static void completeHead(Connection& connection, size_t bodyLength, size_t consumed) {
+  HttpEndpoint endpoint = connection.pipeline[0];
+  AsyncSlot& slot = slots[endpoint];
+
+  const char* bodyStart = connection.rx + (consumed - bodyLength);
+  size_t copyLength = min(bodyLength, sizeof(slot.response) - 1);
+  memcpy(slot.response, bodyStart, copyLength);
+  slot.response[copyLength] = '\0';
+
+  // Keep any pipelined bytes that already belong to the next response
+  memmove(connection.rx, connection.rx + consumed, connection.rxLength - consumed);
+  connection.rxLength -= consumed;
+
+  finishSlot(endpoint, true, "");
+}
+
+// Parse as many complete responses from the receive buffer as possible
+static void consumeResponses(Connection& connection) {
+  while (connection.pipelineLength > 0) {
+    AsyncSlot& slot = slots[connection.pipeline[0]];
+    if (slot.state != HttpRequestState::AWAITING_RESPONSE &&
+        slot.state != HttpRequestState::READING_BODY) {
+      return;
+    }
+
+    connection.rx[connection.rxLength] = '\0';
+    char* end = strstr(connection.rx, "\r\n\r\n");
+    if (end == NULL) {
+      return;
+    }
+    size_t headerLength = end + 4 - connection.rx;
+
+    if (slot.state == HttpRequestState::AWAITING_RESPONSE) {
+      slot.state = HttpRequestState::READING_BODY;
+
+      // Temporarily terminate the header block so lookups stay inside it
+      char saved = end[2];
+      end[2] = '\0';
+
+      int status;
+      if (sscanf(connection.rx, "HTTP/1.%*d %d", &status) == 1) {
+        slot.statusCode = status;
+      }
+      const char* length = findHeader(connection.rx, "Content-Length");
+      if (length != NULL) {
+        slot.contentLength = strtol(length, NULL, 10);
+      }
+      const char* connectionHeader = findHeader(connection.rx, "Connection");
+      if (connectionHeader != NULL && strncasecmp(connectionHeader, "close", 5) == 0) {
+        connection.closeAfterResponse = true;
+      }
+
+      end[2] = saved;
+
+      // These never carry a body, whatever the headers say
+      if (slot.statusCode == 204 || slot.statusCode == 304 || (slot.statusCode >= 100 && slot.statusCode < 200)) {
+        slot.contentLength = 0;
+      }
+    }
+
+    // Without Content-Length the body runs until the server closes
+    if (slot.contentLength < 0) {
+      connection.closeAfterResponse = true;
+      return;
+    }
+
+    size_t total = headerLength + slot.contentLength;
+    if (connection.rxLength < total) {
+      return;
+    }
+    completeHead(connection, slot.contentLength, total);
+  }
+}
+
+static void receivePending(Connection& connection) {
+  size_t space = sizeof(connection.rx) - 1 - connection.rxLength;
+  if (space == 0) {
+    dropConnection(connection, "Response too large");
+    return;
+  }
+
+  int received = recv(connection.sock, connection.rx + connection.rxLength, space, 0);
+  if (received > 0) {
+    connection.rxLength += received;
+    connection.lastActivity = millis();
+    consumeResponses(connection);
+  } else if (received == 0) {
+    // Server closed; that ends a body sent without Content-Length
+    if (connection.pipelineLength > 0) {
+      AsyncSlot& head = slots[connection.pipeline[0]];
+      if (head.state == HttpRequestState::READING_BODY && head.contentLength < 0) {
+        char* end = strstr(connection.rx, "\r\n\r\n");
+        size_t headerLength = end + 4 - connection.rx;
+        completeHead(connection, connection.rxLength - headerLength, connection.rxLength);
+      }
+    }
+    dropConnection(connection, "Connection closed early");
+  } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+    dropConnection(connection, "Receive failed");
+  }
+}
+
+// Reads the clock at every check: receiving and completion callbacks move
+// startTime and lastActivity forward during a poll, and a time taken
+// before them would make the difference wrap. The signed compare covers
+// stamps taken on the other core a moment after the clock was read.
+static bool hasElapsed(unsigned long since, unsigned long interval) {
+  return (long)(millis() - since) > (long)interval;
+}
+
+static void pollConnection(Connection& connection) {
+  // Requests that overran their deadline leave the byte stream in an
+  // unknown state, so the connection is reset along with them
+  for (int i = 0; i < connection.pipelineLength; i++) {
+    HttpEndpoint endpoint = connection.pipeline[i];
+    AsyncSlot& slot = slots[endpoint];
+    unsigned long timeout = slot.timeout > 0 ? slot.timeout : requestTimeout;
+    if (hasElapsed(slot.startTime, timeout)) {
+      finishSlot(endpoint, false, "Request timed out");
+      dropConnection(connection, "Request timed out");
+      break;
+    }
+  }
+
+  if (connection.pipelineLength > 0 && connection.state == HttpConnectionState::CLOSED) {
+    if (!resolveServer() && lookupPending) {
+      return;   // Requests stay queued for the answer, bounded by their timeouts
+    }
+    if (!openConnection(connection)) {
+      while (connection.pipelineLength > 0) {
+        finishSlot(connection.pipeline[0], false, "Could not connect to server");
+      }
+      return;
+    }
+  }
+
+  if (connection.state == HttpConnectionState::CONNECTING) {
+    pollConnecting(connection);
+  }
+
+  if (connection.state == HttpConnectionState::OPEN) {
+    sendPending(connection);
+  }
+  if (connection.state == HttpConnectionState::OPEN) {
+    receivePending(connection);
+  }
+
+  if (connection.state == HttpConnectionState::OPEN && connection.pipelineLength == 0) {
+    if (connection.closeAfterResponse || hasElapsed(connection.lastActivity, keepAliveIdleTime)) {
+      closeConnection(connection);
+    }
+  }
+}
+
+void httpAsyncPoll() {
+  for (int i = 0; i < CONNECTION_COUNT; i++) {
+    pollConnection(connections[i]);
+  }
+}
+
+void httpAsyncCancel(HttpEndpoint endpoint) {
+  AsyncSlot& slot = slots[endpoint];
+  bool written = slot.requestSent > 0 && isHttpAsyncBusy(endpoint);
+
+  removeFromPipeline(endpoint);
+  slot.state = HttpRequestState::IDLE;
+  slot.callback = NULL;
+
+  // A half-written or unanswered request would desync the pipeline
+  if (written) {
+    dropConnection(connectionFor(endpoint), "Request cancelled");
+  }
+}
+
+// --- Configuration Functions ---
+
+void setHttpAsyncTimeout(unsigned long timeoutMs) {
+  requestTimeout = timeoutMs;
+}
+
+void setHttpKeepAliveIdleTime(unsigned long idleMs) {
+  keepAliveIdleTime = idleMs;
+}
+
+void setHttpEndpointTimeout(HttpEndpoint endpoint, unsigned long timeoutMs) {
+  slots[endpoint].timeout = timeoutMs;
+}
+
+// --- Status Query Functions ---
+
+HttpRequestState getHttpAsyncState(HttpEndpoint endpoint) {
+  return slots[endpoint].state;
+}
+
+bool isHttpAsyncBusy(HttpEndpoint endpoint) {
+  HttpRequestState state = slots[endpoint].state;
+  return state == HttpRequestState::QUEUED ||
+         state == HttpRequestState::SENDING ||
+         state == HttpRequestState::AWAITING_RESPONSE ||
+         state == HttpRequestState::READING_BODY;
+}
+
+int getHttpAsyncStatusCode(HttpEndpoint endpoint) {
+  return slots[endpoint].statusCode;
+}
+
+const char* getHttpAsyncBody(HttpEndpoint endpoint) {
+  const AsyncSlot& slot = slots[endpoint];
+  if (slot.state != HttpRequestState::COMPLETE) {
+    return "";
+  }
+  return slot.response;
+}
+
+HttpConnectionState getHttpConnectionState() {
+  return connections[SHARED_CONNECTION].state;
+}
+
+HttpConnectionStats getHttpConnectionStats() {
+  return stats;
+}
+
+void printHttpConnectionStats() {
+  Serial.println("=== HTTP Connection ===");
+  Serial.printf("Requests: %lu (failed %lu)\n", stats.totalRequests, stats.failedRequests);
+  Serial.printf("Fresh connects: %lu\n", stats.freshConnects);
+  Serial.printf("Reused connection: %lu requests\n", stats.reusedRequests);
+  Serial.printf("Reconnects after failure: %lu\n", stats.reconnects);
+  Serial.println("=======================");
+}
+
+const char* httpRequestStateToString(HttpRequestState state) {
+  switch (state) {
+    case HttpRequestState::IDLE: return "IDLE";
+    case HttpRequestState::QUEUED: return "QUEUED";
+    case HttpRequestState::SENDING: return "SENDING";
+    case HttpRequestState::AWAITING_RESPONSE: return "AWAITING_RESPONSE";
+    case HttpRequestState::READING_BODY: return "READING_BODY";
+    case HttpRequestState::COMPLETE: return "COMPLETE";
+    case HttpRequestState::FAILED: return "FAILED";
+    default: return "UNKNOWN";
+  }
+}
@@ -0,0 +1,80 @@
+#ifndef HTTP_ASYNC_H
+#define HTTP_ASYNC_H
+
+#include <stddef.h>
+
+// Buffer sizes per endpoint slot
+#define HTTP_ASYNC_REQUEST_SIZE  3072
+#define HTTP_ASYNC_RESPONSE_SIZE 512
+
+// Receive buffer of the shared connection, large enough for pipelined responses
+#define HTTP_ASYNC_RX_SIZE 1024
+
+// Each endpoint owns one slot, so at most one request per endpoint is in flight.
+// Slots share one keep-alive connection and are pipelined over it; the
+// long-poll phase watch has a connection of its own.
+enum HttpEndpoint {
+  ENDPOINT_SENSOR_DATA,
+  ENDPOINT_PHASE,
+  ENDPOINT_SYNC,
+  ENDPOINT_PHASE_WATCH,
+  ENDPOINT_COUNT
+};
+
+// Request lifecycle; every step is advanced by httpAsyncPoll() without blocking
+enum class HttpRequestState {
+  IDLE,
+  QUEUED,             // Waiting for the shared connection
+  SENDING,
+  AWAITING_RESPONSE,
+  READING_BODY,
+  COMPLETE,
+  FAILED
+};
+
+enum class HttpConnectionState {
+  CLOSED,
+  CONNECTING,
+  OPEN
+};
+
+// Counters to confirm how many round trips the keep-alive connection saves
+struct HttpConnectionStats {
+  unsigned long totalRequests;
+  unsigned long failedRequests;
+  unsigned long freshConnects;    // TCP handshakes performed
+  unsigned long reusedRequests;   // Requests sent on an already used connection
+  unsigned long reconnects;       // Connections lost with requests still pending
+};
+
+// Called from httpAsyncPoll() once a request completes or fails.
+// statusCode is -1 and body is the error message when success is false.
+typedef void (*HttpResponseCallback)(HttpEndpoint endpoint, bool success, int statusCode,
+                                     const char* body, void* context);
+
+// --- Setup Function ---
+bool httpAsyncSetup(const char* serverUrl);
+
+// --- Request Functions ---
+bool httpAsyncStart(HttpEndpoint endpoint, const char* method, const char* path,
+                    const char* contentType, const char* body, size_t bodyLength,
+                    HttpResponseCallback callback, void* context);
+void httpAsyncPoll();
+void httpAsyncCancel(HttpEndpoint endpoint);
+
+// --- Configuration Functions ---
+void setHttpAsyncTimeout(unsigned long timeoutMs);
+void setHttpKeepAliveIdleTime(unsigned long idleMs);
+void setHttpEndpointTimeout(HttpEndpoint endpoint, unsigned long timeoutMs);  // 0 = default
+
+// --- Status Query Functions ---
+HttpRequestState getHttpAsyncState(HttpEndpoint endpoint);
+bool isHttpAsyncBusy(HttpEndpoint endpoint);
+int getHttpAsyncStatusCode(HttpEndpoint endpoint);
+const char* getHttpAsyncBody(HttpEndpoint endpoint);
+HttpConnectionState getHttpConnectionState();
+HttpConnectionStats getHttpConnectionStats();
+void printHttpConnectionStats();
+const char* httpRequestStateToString(HttpRequestState state);
+
+#endif
@@ -0,0 +1,47 @@
+#include "humidifier_driver.h"
+#include "humidity_pid.h"
+#include <Arduino.h>
+
+// --- Pin Definitions ---
+#define HUMIDIFIER_PIN 15
+
+// --- Driver State ---
+static SwitchedOutput humidifier;
+
+SwitchLimits humidifierDefaultLimits() {
+  SwitchLimits limits;
+  limits.minOnMs = HUMIDIFIER_MIN_ON_MS;
+  limits.minOffMs = HUMIDIFIER_MIN_OFF_MS;
+  limits.maxStartsPerHour = HUMIDIFIER_MAX_STARTS_PER_HOUR;
+  limits.startBurst = HUMIDIFIER_START_BURST;
+  return limits;
+}
+
+void setupHumidifierDriver(const SwitchLimits& limits) {
+  switchedOutputSetup(humidifier, "Humidifier", HUMIDIFIER_PIN, ACTUATOR_HUMIDIFIER, limits, HUMIDITY_PID_WINDOW_MS);
+}
+
+void requestHumidifier(bool on, unsigned long now) {
+  switchedOutputRequest(humidifier, on, now);
+}
+
+void requestHumidifierDuty(float duty, unsigned long windowMs, unsigned long now) {
+  switchedOutputRequestDuty(humidifier, duty, windowMs, now);
+}
+
+void updateHumidifierDriver(unsigned long now) {
+  switchedOutputUpdate(humidifier, now);
+}
+
+// --- Status Functions ---
+bool isHumidifierOutputOn() {
+  return humidifier.outputOn;
+}
+
+bool isHumidifierRequestHeld() {
+  return humidifier.requestedOn != humidifier.outputOn;
+}
+
+SwitchStats getHumidifierDriverStats() {
+  return humidifier.stats;
+}
@@ -0,0 +1,27 @@
+#ifndef HUMIDIFIER_DRIVER_H
+#define HUMIDIFIER_DRIVER_H
+
+#include "switched_output.h"
+
+// Output stage between the controller and HUMIDIFIER_PIN, guarding the
+// ultrasonic disc and its MOSFET. Behaves as described in switched_output.h.
+
+// --- Default Limits ---
+#define HUMIDIFIER_MIN_ON_MS           4000
+#define HUMIDIFIER_MIN_OFF_MS          4000
+#define HUMIDIFIER_MAX_STARTS_PER_HOUR 120
+#define HUMIDIFIER_START_BURST         6       // Starts allowed back to back before the rate applies
+
+// --- Driver Functions ---
+SwitchLimits humidifierDefaultLimits();
+void setupHumidifierDriver(const SwitchLimits& limits);
+void requestHumidifier(bool on, unsigned long now);
+void requestHumidifierDuty(float duty, unsigned long windowMs, unsigned long now);   // See switchedOutputRequestDuty()
+void updateHumidifierDriver(unsigned long now);   // Retries a held request
+
+// --- Status Functions ---
+bool isHumidifierOutputOn();
+bool isHumidifierRequestHeld();
+SwitchStats getHumidifierDriverStats();
+
+#endif
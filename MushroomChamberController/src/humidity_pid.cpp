@@ -0,0 +1,86 @@
+#include "humidity_pid.h"
+#include <Arduino.h>
+
+// --- PID Functions ---
+PidGains pidGainsForPhase(const PhaseConfig& phaseConfig) {
+  float tolerance = max(phaseConfig.humidityTolerance, 0.5f);
+  PidGains gains;
+  gains.kp = 1.0f / (HUMIDITY_PID_FULL_SCALE_TOLERANCES * tolerance);
+  gains.ki = gains.kp / HUMIDITY_PID_INTEGRAL_TIME_S;
+  gains.kd = gains.kp * HUMIDITY_PID_DERIVATIVE_TIME_S;
+  return gains;
+}
+
+void pidReset(PidController& pid, const PidGains& gains, float initialOutput) {
+  pid.gains = gains;
+  pid.integral = constrain(initialOutput, 0.0f, 1.0f);   // Bumpless start
+  pid.lastMeasurement = NAN;
+  pid.primed = false;
+  pid.output = pid.integral;
+}
+
+float pidUpdate(PidController& pid, float setpoint, float measurement, float dtSec) {
+  float error = setpoint - measurement;
+
+  // Derivative on the measurement so setpoint steps (feed-forward, phase
+  // changes) do not kick the output
+  float derivative = 0.0f;
+  if (pid.primed && dtSec > 0.0f) {
+    derivative = -(measurement - pid.lastMeasurement) / dtSec;
+  }
+  pid.lastMeasurement = measurement;
+  pid.primed = true;
+
+  float proportional = pid.gains.kp * error;
+  float unclamped = proportional + pid.integral + pid.gains.kd * derivative;
+
+  // Anti-windup: only integrate when the output is not pinned against the
+  // limit the error is pushing toward, and keep the integral itself in range
+  bool saturatedHigh = unclamped >= 1.0f && error > 0.0f;
+  bool saturatedLow = unclamped <= 0.0f && error < 0.0f;
+  if (!saturatedHigh && !saturatedLow) {
+    pid.integral = constrain(pid.integral + pid.gains.ki * error * dtSec, 0.0f, 1.0f);
+  }
+
+  pid.output = constrain(proportional + pid.integral + pid.gains.kd * derivative, 0.0f, 1.0f);
+  return pid.output;
+}
+
+// --- Time-Proportioned Output ---
+void timeProportionReset(TimeProportioner& proportioner, unsigned long windowMs,
+                         unsigned long minPulseMs, unsigned long now, bool carryRemainder) {
+  proportioner.windowMs = windowMs;
+  proportioner.minPulseMs = minPulseMs;
+  proportioner.windowStart = now;
+  proportioner.windowDuty = 0.0f;
+  proportioner.onMs = 0;
+  proportioner.carryRemainder = carryRemainder;
+  proportioner.carry = 0.0f;
+}
+
+bool timeProportion(TimeProportioner& proportioner, float duty, unsigned long now) {
+  unsigned long elapsed = now - proportioner.windowStart;
+  if (elapsed >= proportioner.windowMs) {
+    // Latch the duty once per window so the relay switches at most twice
+    proportioner.windowStart = now;
+    proportioner.windowDuty = constrain(duty, 0.0f, 1.0f);
+    elapsed = 0;
+
+    float wanted = proportioner.windowDuty;
+    if (proportioner.carryRemainder) {
+      wanted = constrain(wanted + proportioner.carry, 0.0f, 1.0f);
+    }
+    unsigned long onMs = (unsigned long)(wanted * proportioner.windowMs);
+    if (onMs < proportioner.minPulseMs) {
+      onMs = 0;
+    } else if (onMs > proportioner.windowMs - proportioner.minPulseMs) {
+      onMs = proportioner.windowMs;
+    }
+    proportioner.onMs = onMs;
+    if (proportioner.carryRemainder) {
+      proportioner.carry = wanted - (float)onMs / proportioner.windowMs;
+    }
+  }
+
+  return elapsed < proportioner.onMs;
+}
@@ -0,0 +1,55 @@
+#ifndef HUMIDITY_PID_H
+#define HUMIDITY_PID_H
+
+#include "mushroom_types.h"
+
+// PID on filtered humidity for the AdaptiveController's REGULATING state.
+// The output is a humidifier duty (0..1) that a time-proportioning window
+// turns into on/off switching for the relay.
+
+// --- Tuning ---
+// Gains scale with the phase tolerance: a tight band gets a stiffer loop.
+// An error of HUMIDITY_PID_FULL_SCALE_TOLERANCES tolerances asks for 100 %.
+#define HUMIDITY_PID_FULL_SCALE_TOLERANCES 2.0f
+#define HUMIDITY_PID_INTEGRAL_TIME_S       300.0f
+#define HUMIDITY_PID_DERIVATIVE_TIME_S     10.0f
+#define HUMIDITY_PID_WINDOW_MS             60000   // Time-proportioning period
+
+struct PidGains {
+  float kp;   // Duty per %RH
+  float ki;   // Duty per %RH·s
+  float kd;   // Duty per %RH/s
+};
+
+struct PidController {
+  PidGains gains;
+  float integral;          // Duty contributed by the I term, kept inside 0..1
+  float lastMeasurement;
+  bool primed;             // lastMeasurement is valid
+  float output;            // Last duty, 0..1
+};
+
+struct TimeProportioner {
+  unsigned long windowMs;
+  unsigned long minPulseMs;
+  unsigned long windowStart;
+  float windowDuty;        // Duty latched at the start of the window
+  unsigned long onMs;      // What the window serves of it
+  bool carryRemainder;     // Owe a dropped short pulse to the next window
+  float carry;             // Duty owed (or served ahead), in windows
+};
+
+// --- PID Functions ---
+PidGains pidGainsForPhase(const PhaseConfig& phaseConfig);
+void pidReset(PidController& pid, const PidGains& gains, float initialOutput);
+float pidUpdate(PidController& pid, float setpoint, float measurement, float dtSec);
+
+// --- Time-Proportioned Output ---
+// A duty too small for the minimum pulse is dropped, one too close to full
+// runs solid; with carryRemainder the difference is owed to the next
+// window, so a small duty still averages out right over several
+void timeProportionReset(TimeProportioner& proportioner, unsigned long windowMs,
+                         unsigned long minPulseMs, unsigned long now, bool carryRemainder = false);
+bool timeProportion(TimeProportioner& proportioner, float duty, unsigned long now);
+
+#endif
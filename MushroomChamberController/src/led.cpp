@@ -1,7 +1,6 @@
 #include "config.h"
 #include "led.h"
-#include <FastLED.h>
-#include <time.h>  // For real-time functions
+#include "hal/hal.h"
 
 // --- LED Strip ---
 CRGB leds[NUM_LEDS];
@@ -10,19 +9,16 @@ CRGB leds[NUM_LEDS];
 extern MushroomConfig mushroomconfig;
 
 void setupLeds() {
-  FastLED.addLeds<WS2812B, LED_PIN, GRB>(leds, NUM_LEDS);
-  FastLED.clear();
-  FastLED.show();
+  halLedStripSetup(leds, NUM_LEDS);
+  setLEDColor(CRGB::Black);
 }
 
 void controlLighting(const PhaseConfig& currentConfig) {
   static bool lightOn = false;
 
   // Get current time
-  time_t now;
   struct tm timeinfo;
-  time(&now);
-  localtime_r(&now, &timeinfo);
+  halLocalTime(timeinfo);
 
   int hour = timeinfo.tm_hour;
 
@@ -49,5 +45,5 @@ void setLEDColor(CRGB color) {
   for (int i = 0; i < NUM_LEDS; i++) {
     leds[i] = color;
   }
-  FastLED.show();
+  halLedStripShow();
 }
@@ -2,6 +2,7 @@
 #define LED_H
 
 #include <FastLED.h>
+#include "mushroom_types.h"
 
 // Constants
 #define LED_PIN     27
@@ -1,15 +1,13 @@
 #include <Arduino.h>
 #include "sensors.h"
 #include "actuators.h"
+#include "thermal_outputs.h"
 #include "led.h"
 #include "config.h"
 #include "wifi_comm.h"
-
-// Global configuration and current phase
-MushroomConfig currentConfig;
-GrowthPhase currentPhase = INCUBATION; // Change as needed: INCUBATION, PRIMORDIA_FORMATION, FRUITING
-GrowthPhase oldPhase = currentPhase; // Store the previous phase for comparison
-PhaseConfig activePhaseConfig;
+#include "tasks.h"
+#include "telemetry_spool.h"
+#include "control_trace.h"
 
 void setup() {
   Serial.begin(115200);
@@ -23,63 +21,32 @@ void setup() {
   
   // Initialize hardware (no network needed)
   setupSensors();
+  // Boot marker right before the controller starts, so replays line up;
+  // chunks go through the comms task, which starts after setupSpool()
+  // mounted LittleFS
+  traceSetup(traceQueueWriter);
   setupActuators();
+  // PID tracks tighter but pulses the humidifier about five times as
+  // often; the relay and the mister wear by the switch. The server's
+  // control_mode can still select it.
+  setControlMode(ControlMode::BANG_BANG);
+  setThermalOutputs(false, false);   // Set once a heater / cooler relay is wired to pins 25 / 26
   setupLeds();
+  setupSpool();
   
   // Initialize WiFi and WAIT for connection
   Serial.println("\n🌐 Connecting to WiFi...");
   wifiSetup("#Telia-DA3228", "fc736346d1dST2A1", "http://192.168.1.126:3001");
+  setTelemetryEncoding(TelemetryEncoding::CBOR);
 
-  // Sync time for lighting control
+  // Start the time sync for lighting control; the comms task sees it land
   setupTime();
+
+  // Hand over to the sensor, control and comms tasks
+  startTasks(getDefaultTaskConfig());
 }
 
 void loop() {
-  float temp, humidity, pressure;
-
-  // Read environmental data
-  temp = readTemperature();
-  humidity = readHumidity();
-  pressure = readPressure();
-
-  // Print to serial
-  Serial.print("Phase: ");
-  Serial.print(growthPhaseToString(currentPhase));
-  Serial.print(" | Temp: ");
-  Serial.print(temp);
-  Serial.print(" °C, Humidity: ");
-  Serial.print(humidity);
-  Serial.print(" %, Pressure: ");
-  Serial.print(pressure);
-  Serial.println(" hPa");
-
-  // Handle WiFi connection retry logic
-  wifiRetryLoop();
-
-  if (wifiConnected()) {
-    bool success = sendSensorData(humidity, temp, pressure);
-    if (success) {
-      Serial.println("✅ Data sent successfully!");
-    } else {
-      Serial.printf("❌ Failed to send data: %s\n", getLastError().c_str());
-    }
-
-    // --- Get current growth phase ---
-    GrowthPhase newPhase = getCurrentPhase();
-    
-    // If ther current phase has changed, update the active config
-    if (currentPhase != newPhase) {
-      oldPhase = currentPhase;      // Store old phase
-      currentPhase = newPhase;      // Update current phase
-      activePhaseConfig = getActivePhaseConfig(); // Update config for new phase
-    }
-  } else {
-    Serial.printf("WiFi Status: %s\n", getWiFiStatusString().c_str());
-  }
-
-  // --- Control system based on phase config ---
-  updateActuators(humidity, temp, pressure);
-  controlLighting(activePhaseConfig);     // Pass in active config with light timing/color
-
-  delay(2000); // Loop delay
+  // All work happens in the sensor, control and comms tasks
+  vTaskDelete(NULL);
 }
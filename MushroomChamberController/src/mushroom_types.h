@@ -8,6 +8,14 @@ enum GrowthPhase {
   FRUITING
 };
 
+// Which fans a ventilation runs (ventilation_modes.h)
+enum class VentilationMode : uint8_t {
+  AUTO,             // Learned: the exchange mode needing the least fan time per air change
+  EXHAUST_ONLY,     // Both exhaust fans, chamber under slight negative pressure
+  INLET_ONLY,       // Inlet fan only, chamber under slight positive pressure
+  BALANCED,         // All three fans
+  CIRCULATION       // All three at their minimum speed: stirs the air, little exchange
+};
 
 struct PhaseConfig {
   float targetTemperature;
@@ -22,6 +30,8 @@ struct PhaseConfig {
   int lightStartHour;
   int lightEndHour;
   CRGB lightColor;
+
+  VentilationMode ventilationMode;   // BALANCED unless a phase opts into AUTO
 };
 
 struct MushroomConfig {
@@ -0,0 +1,255 @@
+#include "relay_autotune.h"
+#include <Arduino.h>
+
+#define PHASE_COUNT 3
+#define RELAY_AMPLITUDE 0.5f   // Relay swings the duty 0 ↔ 1 around a 50 % bias
+
+// --- Experiment State ---
+static struct {
+  AutotuneStage stage = AutotuneStage::IDLE;
+  GrowthPhase phase = INCUBATION;
+  float setpoint = 0.0f;
+  float hysteresis = 0.0f;
+  float tolerance = 0.0f;
+  float expectedDrop = 0.0f;
+  unsigned long startTime = 0;
+  unsigned long stageStart = 0;
+
+  // Relay
+  bool relayOn = false;
+  unsigned long lastOnSwitch = 0;
+  int cyclesSeen = 0;            // Completed on→on cycles, including the discarded one
+  float high = 0.0f;             // Extremes of the current half cycles
+  float low = 0.0f;
+  float periods[AUTOTUNE_CYCLES];
+  float amplitudes[AUTOTUNE_CYCLES];
+  float coasts[AUTOTUNE_CYCLES];
+
+  // Fan pulse
+  float pulseStartHumidity = 0.0f;
+  float pulseLowest = 0.0f;
+  unsigned long pulseMs = 0;
+} tune;
+
+static AutotuneResult phaseTunings[PHASE_COUNT];
+
+const char* autotuneStageToString(AutotuneStage stage) {
+  switch (stage) {
+    case AutotuneStage::IDLE: return "IDLE";
+    case AutotuneStage::RELAY: return "RELAY";
+    case AutotuneStage::PRECHARGE: return "PRECHARGE";
+    case AutotuneStage::FAN_PULSE: return "FAN_PULSE";
+    case AutotuneStage::FAN_SETTLE: return "FAN_SETTLE";
+    case AutotuneStage::DONE: return "DONE";
+    case AutotuneStage::FAILED: return "FAILED";
+    default: return "UNKNOWN";
+  }
+}
+
+static void enterStage(AutotuneStage stage, unsigned long now) {
+  Serial.printf("🎚️  Autotune: %s → %s\n", autotuneStageToString(tune.stage), autotuneStageToString(stage));
+  tune.stage = stage;
+  tune.stageStart = now;
+}
+
+void autotuneStart(const PhaseConfig& phaseConfig, GrowthPhase phase,
+                   float expectedVentilationDrop, unsigned long now) {
+  tune.phase = phase;
+  tune.setpoint = phaseConfig.targetHumidity;
+  tune.tolerance = phaseConfig.humidityTolerance;
+  tune.hysteresis = max(phaseConfig.humidityTolerance * AUTOTUNE_HYSTERESIS_FRACTION, AUTOTUNE_MIN_HYSTERESIS);
+  tune.expectedDrop = expectedVentilationDrop;
+  tune.startTime = now;
+  tune.cyclesSeen = 0;
+  tune.relayOn = false;
+  tune.lastOnSwitch = 0;
+  tune.high = -INFINITY;
+  tune.low = INFINITY;
+
+  Serial.printf("🎚️  Autotune started: relay at %.1f%% ± %.2f%%\n", tune.setpoint, tune.hysteresis);
+  tune.stage = AutotuneStage::IDLE;
+  enterStage(AutotuneStage::RELAY, now);
+}
+
+void autotuneCancel() {
+  if (tune.stage != AutotuneStage::IDLE && tune.stage != AutotuneStage::DONE &&
+      tune.stage != AutotuneStage::FAILED) {
+    Serial.println("⚠️  Autotune cancelled");
+    tune.stage = AutotuneStage::FAILED;
+  }
+}
+
+AutotuneStage getAutotuneStage() {
+  return tune.stage;
+}
+
+// --- Result Calculation ---
+static float mean(const float* values, int count) {
+  float sum = 0.0f;
+  for (int i = 0; i < count; i++) sum += values[i];
+  return sum / count;
+}
+
+static void finishExperiment() {
+  AutotuneResult result;
+  result.valid = true;
+  result.ultimatePeriodSec = mean(tune.periods, AUTOTUNE_CYCLES);
+  result.amplitude = mean(tune.amplitudes, AUTOTUNE_CYCLES);
+  result.coastOvershoot = max(mean(tune.coasts, AUTOTUNE_CYCLES), 0.0f);
+
+  // Describing function of a relay with hysteresis: Ku = 4d / (π·sqrt(a² − h²))
+  float effective = sqrtf(max(result.amplitude * result.amplitude - tune.hysteresis * tune.hysteresis, 0.01f));
+  result.ultimateGain = 4.0f * RELAY_AMPLITUDE / (PI * effective);
+
+  // Tyreus–Luyben PI: less aggressive than Ziegler–Nichols, better suited
+  // to a lagging, slow process; no D term on a noisy humidity signal
+  result.pidGains.kp = result.ultimateGain / 3.2f;
+  result.pidGains.ki = result.pidGains.kp / (2.2f * result.ultimatePeriodSec);
+  result.pidGains.kd = 0.0f;
+  result.outputWindowMs = constrain((unsigned long)(result.ultimatePeriodSec * 1000.0f / 4.0f),
+                                    10000UL, (unsigned long)HUMIDITY_PID_WINDOW_MS);
+
+  // Bang-bang stops at target + overshoot and then coasts; aim the peak at
+  // half the tolerance above target
+  result.humidityOvershoot = constrain(tune.tolerance * 0.5f - result.coastOvershoot, 0.0f, tune.tolerance);
+
+  float drop = tune.pulseStartHumidity - tune.pulseLowest;
+  result.ventilationDropRate = tune.pulseMs > 0 ? drop / (tune.pulseMs / 1000.0f) : 0.0f;
+  unsigned long duration = result.ventilationDropRate > 0.0f
+      ? (unsigned long)(tune.expectedDrop / result.ventilationDropRate * 1000.0f)
+      : 30000UL;
+  result.ventilationDuration = constrain(duration, 15000UL, 60000UL);
+
+  setPhaseTuning(tune.phase, result);
+}
+
+// --- Experiment Step ---
+static bool periodsAgree() {
+  float average = mean(tune.periods, AUTOTUNE_CYCLES);
+  for (int i = 0; i < AUTOTUNE_CYCLES; i++) {
+    if (fabs(tune.periods[i] - average) > average * AUTOTUNE_MAX_PERIOD_SPREAD) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void runRelay(float humidity, unsigned long now) {
+  tune.high = max(tune.high, humidity);
+  tune.low = min(tune.low, humidity);
+
+  if (tune.relayOn && humidity > tune.setpoint + tune.hysteresis) {
+    // Off switch: the trough of the on half is complete
+    tune.relayOn = false;
+    tune.high = humidity;
+  } else if (!tune.relayOn && humidity < tune.setpoint - tune.hysteresis) {
+    // On switch closes a full cycle: trough of its on half, peak of its off half
+    if (tune.lastOnSwitch != 0) {
+      int slot = tune.cyclesSeen - 1;   // Cycle 0 is the start-up transient
+      if (slot >= 0) {
+        tune.periods[slot % AUTOTUNE_CYCLES] = (now - tune.lastOnSwitch) / 1000.0f;
+        tune.amplitudes[slot % AUTOTUNE_CYCLES] = (tune.high - tune.low) / 2.0f;
+        tune.coasts[slot % AUTOTUNE_CYCLES] = tune.high - (tune.setpoint + tune.hysteresis);
+      }
+      tune.cyclesSeen++;
+    }
+    tune.relayOn = true;
+    tune.lastOnSwitch = now;
+    tune.low = humidity;
+
+    if (tune.cyclesSeen > AUTOTUNE_CYCLES && periodsAgree()) {
+      Serial.printf("📊 Relay cycles settled: period %.0f s\n", mean(tune.periods, AUTOTUNE_CYCLES));
+      enterStage(AutotuneStage::PRECHARGE, now);
+    }
+  }
+}
+
+AutotuneOutput autotuneUpdate(float humidity, unsigned long now) {
+  AutotuneOutput output = { false, false };
+
+  if (tune.stage != AutotuneStage::IDLE && tune.stage != AutotuneStage::DONE &&
+      tune.stage != AutotuneStage::FAILED && now - tune.startTime > AUTOTUNE_MAX_DURATION_MS) {
+    Serial.println("❌ Autotune timed out - oscillation never settled");
+    tune.stage = AutotuneStage::FAILED;
+  }
+
+  switch (tune.stage) {
+    case AutotuneStage::RELAY:
+      runRelay(humidity, now);
+      output.humidifier = tune.relayOn;
+      break;
+
+    case AutotuneStage::PRECHARGE:
+      if (humidity >= tune.setpoint) {
+        tune.pulseStartHumidity = humidity;
+        tune.pulseLowest = humidity;
+        enterStage(AutotuneStage::FAN_PULSE, now);
+        output.fans = true;
+      } else {
+        output.humidifier = true;
+      }
+      break;
+
+    case AutotuneStage::FAN_PULSE:
+      tune.pulseLowest = min(tune.pulseLowest, humidity);
+      if (tune.pulseStartHumidity - humidity >= tune.expectedDrop ||
+          now - tune.stageStart >= AUTOTUNE_FAN_PULSE_MAX_MS) {
+        tune.pulseMs = now - tune.stageStart;
+        enterStage(AutotuneStage::FAN_SETTLE, now);
+      } else {
+        output.fans = true;
+      }
+      break;
+
+    case AutotuneStage::FAN_SETTLE:
+      tune.pulseLowest = min(tune.pulseLowest, humidity);
+      if (now - tune.stageStart >= AUTOTUNE_FAN_SETTLE_MS) {
+        finishExperiment();
+        enterStage(AutotuneStage::DONE, now);
+      }
+      break;
+
+    default:
+      break;
+  }
+  return output;
+}
+
+// --- Per-Phase Results ---
+const AutotuneResult* getPhaseTuning(GrowthPhase phase) {
+  if ((int)phase < 0 || (int)phase >= PHASE_COUNT || !phaseTunings[phase].valid) {
+    return NULL;
+  }
+  return &phaseTunings[phase];
+}
+
+void setPhaseTuning(GrowthPhase phase, const AutotuneResult& result) {
+  if ((int)phase >= 0 && (int)phase < PHASE_COUNT) {
+    phaseTunings[phase] = result;
+  }
+}
+
+void clearPhaseTunings() {
+  for (int i = 0; i < PHASE_COUNT; i++) {
+    phaseTunings[i].valid = false;
+  }
+}
+
+void printAutotuneStatus() {
+  Serial.println("\n========== Autotune ==========");
+  Serial.printf("Stage: %s\n", autotuneStageToString(tune.stage));
+  for (int i = 0; i < PHASE_COUNT; i++) {
+    const AutotuneResult* result = getPhaseTuning((GrowthPhase)i);
+    if (result == NULL) {
+      Serial.printf("Phase %d: not tuned\n", i);
+      continue;
+    }
+    Serial.printf("Phase %d: Ku=%.3f Tu=%.0fs a=%.2f%% -> Kp=%.3f Ki=%.5f\n", i,
+                  result->ultimateGain, result->ultimatePeriodSec, result->amplitude,
+                  result->pidGains.kp, result->pidGains.ki);
+    Serial.printf("         window %lu s, overshoot %.1f%%, ventilation %lu s (%.2f%%/s)\n",
+                  result->outputWindowMs / 1000, result->humidityOvershoot,
+                  result->ventilationDuration / 1000, result->ventilationDropRate);
+  }
+  Serial.println("==============================");
+}
@@ -0,0 +1,65 @@
+#ifndef RELAY_AUTOTUNE_H
+#define RELAY_AUTOTUNE_H
+
+#include "mushroom_types.h"
+#include "humidity_pid.h"
+
+// Åström–Hägglund relay experiment for the AdaptiveController's AUTOTUNING
+// state. The humidifier is switched as a relay with hysteresis around the
+// phase target until the oscillation settles; its period and amplitude give
+// the ultimate gain and period of the chamber. One fan pulse then measures
+// how fast ventilation dries it. Results are kept per GrowthPhase.
+
+// --- Experiment Parameters ---
+#define AUTOTUNE_HYSTERESIS_FRACTION 0.2f     // Of humidityTolerance; must exceed sensor noise
+#define AUTOTUNE_MIN_HYSTERESIS      0.3f     // %RH
+#define AUTOTUNE_CYCLES              3        // Measured cycles, after one discarded
+#define AUTOTUNE_MAX_PERIOD_SPREAD   0.3f     // Cycles must agree within ±30 %
+#define AUTOTUNE_MAX_DURATION_MS     (3UL * 3600000UL)
+#define AUTOTUNE_FAN_PULSE_MAX_MS    60000
+#define AUTOTUNE_FAN_SETTLE_MS       30000    // Humidity keeps falling after the fans stop
+
+enum class AutotuneStage {
+  IDLE,
+  RELAY,          // Humidifier relay oscillation
+  PRECHARGE,      // Back up to target before the fan pulse
+  FAN_PULSE,
+  FAN_SETTLE,
+  DONE,
+  FAILED
+};
+
+struct AutotuneOutput {
+  bool humidifier;
+  bool fans;
+};
+
+struct AutotuneResult {
+  bool valid;
+  float ultimateGain;            // Ku, duty per %RH
+  float ultimatePeriodSec;       // Tu
+  float amplitude;               // %RH, half peak-to-peak
+  float coastOvershoot;          // %RH the chamber kept rising after the humidifier stopped
+  float ventilationDropRate;     // %RH/s with the fans on
+  PidGains pidGains;             // Tyreus–Luyben PI from Ku and Tu
+  unsigned long outputWindowMs;  // Time-proportioning window, short against Tu
+  float humidityOvershoot;       // For BANG_BANG
+  unsigned long ventilationDuration;   // ms
+};
+
+// --- Experiment Functions ---
+// expectedVentilationDrop is the %RH a normal ventilation is meant to remove
+void autotuneStart(const PhaseConfig& phaseConfig, GrowthPhase phase,
+                   float expectedVentilationDrop, unsigned long now);
+AutotuneOutput autotuneUpdate(float humidity, unsigned long now);
+void autotuneCancel();
+AutotuneStage getAutotuneStage();
+const char* autotuneStageToString(AutotuneStage stage);
+
+// --- Per-Phase Results ---
+const AutotuneResult* getPhaseTuning(GrowthPhase phase);   // NULL until tuned
+void setPhaseTuning(GrowthPhase phase, const AutotuneResult& result);
+void clearPhaseTunings();
+void printAutotuneStatus();
+
+#endif
@@ -0,0 +1,121 @@
+#include "report_policy.h"
+#include <Arduino.h>
+#include <math.h>
+
+// --- Thresholds ---
+static PhaseConfig phaseTolerances;
+static float deadbandFraction = REPORT_DEADBAND_FRACTION;
+static unsigned long heartbeatMs = REPORT_HEARTBEAT_MS;
+static float humidityDeadband = 0.0f;
+static float temperatureDeadband = 0.0f;
+static float pressureDeadband = 0.0f;
+
+// --- Last Reported Reading ---
+static bool haveReported = false;
+static SensorReading lastReported;
+static ControllerState lastState = STABILIZING;
+
+static ReportPolicyStats stats = {};
+
+static void updateDeadbands() {
+  humidityDeadband = phaseTolerances.humidityTolerance * deadbandFraction;
+  temperatureDeadband = phaseTolerances.temperatureTolerance * deadbandFraction;
+  pressureDeadband = phaseTolerances.pressureTolerance * deadbandFraction;
+}
+
+void setReportThresholds(const PhaseConfig& phaseConfig) {
+  phaseTolerances = phaseConfig;
+  updateDeadbands();
+}
+
+void setReportDeadbandFraction(float fraction) {
+  deadbandFraction = max(fraction, 0.0f);
+  updateDeadbands();
+}
+
+void setReportHeartbeat(unsigned long intervalMs) {
+  heartbeatMs = intervalMs;
+}
+
+// A sensor dropping out or coming back counts as a change
+static bool outsideDeadband(float value, float reference, float deadband) {
+  if (isnan(value) || isnan(reference)) {
+    return isnan(value) != isnan(reference);
+  }
+  return fabsf(value - reference) > deadband;
+}
+
+static ReportReason classify(const SensorReading& reading, ControllerState state) {
+  if (!haveReported) {
+    return ReportReason::FIRST;
+  }
+  if (state != lastState) {
+    return ReportReason::STATE_CHANGE;
+  }
+  if (outsideDeadband(reading.humidity, lastReported.humidity, humidityDeadband) ||
+      outsideDeadband(reading.temperature, lastReported.temperature, temperatureDeadband) ||
+      outsideDeadband(reading.pressure, lastReported.pressure, pressureDeadband)) {
+    return ReportReason::CHANGE;
+  }
+  if (reading.timestamp - lastReported.timestamp >= heartbeatMs) {
+    return ReportReason::HEARTBEAT;
+  }
+  return ReportReason::NONE;
+}
+
+ReportReason evaluateReport(const SensorReading& reading, ControllerState state) {
+  ReportReason reason = classify(reading, state);
+
+  switch (reason) {
+    case ReportReason::NONE:
+      stats.suppressed++;
+      return reason;
+    case ReportReason::CHANGE: stats.changes++; break;
+    case ReportReason::STATE_CHANGE: stats.stateChanges++; break;
+    case ReportReason::HEARTBEAT: stats.heartbeats++; break;
+    case ReportReason::FIRST: break;
+  }
+
+  // Deadbands are measured from the last reported value, not the last
+  // sample, so a slow drift is still reported once it adds up
+  stats.reported++;
+  haveReported = true;
+  lastReported = reading;
+  lastState = state;
+  return reason;
+}
+
+bool isUrgentReport(ReportReason reason) {
+  return reason == ReportReason::CHANGE || reason == ReportReason::STATE_CHANGE;
+}
+
+void resetReportPolicy() {
+  haveReported = false;
+  stats = {};
+}
+
+ReportPolicyStats getReportPolicyStats() {
+  return stats;
+}
+
+const char* reportReasonToString(ReportReason reason) {
+  switch (reason) {
+    case ReportReason::NONE: return "NONE";
+    case ReportReason::FIRST: return "FIRST";
+    case ReportReason::CHANGE: return "CHANGE";
+    case ReportReason::STATE_CHANGE: return "STATE_CHANGE";
+    case ReportReason::HEARTBEAT: return "HEARTBEAT";
+    default: return "UNKNOWN";
+  }
+}
+
+void printReportPolicyStatus() {
+  Serial.println("=== Report Policy ===");
+  Serial.printf("Deadband: %.2f %%RH, %.2f °C, %.2f hPa\n",
+                humidityDeadband, temperatureDeadband, pressureDeadband);
+  Serial.printf("Heartbeat: %lu ms\n", heartbeatMs);
+  Serial.printf("Reported: %lu (change %lu, state %lu, heartbeat %lu)\n",
+                stats.reported, stats.changes, stats.stateChanges, stats.heartbeats);
+  Serial.printf("Suppressed: %lu\n", stats.suppressed);
+  Serial.println("=====================");
+}
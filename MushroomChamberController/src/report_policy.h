@@ -0,0 +1,47 @@
+#ifndef REPORT_POLICY_H
+#define REPORT_POLICY_H
+
+#include "mushroom_types.h"
+#include "sensors.h"
+#include "actuators.h"
+
+// --- Policy Defaults ---
+// A reading is reported when any value moves more than this fraction of the
+// phase tolerance since the last reported reading, so tight phases report
+// smaller changes. Stable chambers only send a heartbeat.
+#define REPORT_DEADBAND_FRACTION 0.25f
+#define REPORT_HEARTBEAT_MS      60000
+
+// Why a reading was (or was not) reported
+enum class ReportReason {
+  NONE,           // Inside the deadband, suppressed
+  FIRST,          // Nothing reported yet
+  CHANGE,         // A value left the deadband
+  STATE_CHANGE,   // The AdaptiveController changed state
+  HEARTBEAT       // Nothing changed for REPORT_HEARTBEAT_MS
+};
+
+struct ReportPolicyStats {
+  unsigned long reported;
+  unsigned long suppressed;
+  unsigned long changes;
+  unsigned long stateChanges;
+  unsigned long heartbeats;
+};
+
+// --- Configuration Functions ---
+void setReportThresholds(const PhaseConfig& phaseConfig);   // Call on every phase change
+void setReportDeadbandFraction(float fraction);
+void setReportHeartbeat(unsigned long intervalMs);
+
+// --- Policy Functions ---
+ReportReason evaluateReport(const SensorReading& reading, ControllerState state);
+bool isUrgentReport(ReportReason reason);   // Worth uploading before the next cycle
+void resetReportPolicy();
+
+// --- Status Functions ---
+ReportPolicyStats getReportPolicyStats();
+const char* reportReasonToString(ReportReason reason);
+void printReportPolicyStatus();
+
+#endif
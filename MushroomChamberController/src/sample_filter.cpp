@@ -0,0 +1,132 @@
+#include "sample_filter.h"
+#include <Arduino.h>
+#include <math.h>
+
+// --- Filter State ---
+static DecimationMode decimationMode = DecimationMode::TRIMMED_MEAN;
+static DecimationFilter temperatureFilter;
+static DecimationFilter humidityFilter;
+static DecimationFilter pressureFilter;
+static uint16_t blockSamples = 0;
+static unsigned long lastSampleTime = 0;
+static SampleFilterStats stats = { 0, 0, 0 };
+
+void decimationReset(DecimationFilter& filter) {
+  filter.count = 0;
+  filter.next = 0;
+}
+
+void decimationAdd(DecimationFilter& filter, float value) {
+  if (isnan(value)) {
+    return;
+  }
+
+  // Keep the newest samples if the block outgrows the buffer
+  filter.samples[filter.next] = value;
+  filter.next = (filter.next + 1) % SAMPLE_FILTER_CAPACITY;
+  if (filter.count < SAMPLE_FILTER_CAPACITY) {
+    filter.count++;
+  }
+}
+
+static void sortSamples(float* values, uint8_t count) {
+  // Insertion sort; blocks are at most SAMPLE_FILTER_CAPACITY long
+  for (uint8_t i = 1; i < count; i++) {
+    float value = values[i];
+    int j = i - 1;
+    while (j >= 0 && values[j] > value) {
+      values[j + 1] = values[j];
+      j--;
+    }
+    values[j + 1] = value;
+  }
+}
+
+static float meanOf(const float* values, uint8_t count) {
+  float sum = 0.0f;
+  for (uint8_t i = 0; i < count; i++) {
+    sum += values[i];
+  }
+  return sum / count;
+}
+
+float decimationOutput(const DecimationFilter& filter, DecimationMode mode) {
+  if (filter.count == 0) {
+    return NAN;
+  }
+  if (mode == DecimationMode::MEAN) {
+    return meanOf(filter.samples, filter.count);
+  }
+
+  float sorted[SAMPLE_FILTER_CAPACITY];
+  memcpy(sorted, filter.samples, filter.count * sizeof(float));
+  sortSamples(sorted, filter.count);
+
+  if (mode == DecimationMode::MEDIAN) {
+    uint8_t middle = filter.count / 2;
+    return (filter.count % 2) ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2.0f;
+  }
+
+  uint8_t trim = filter.count / 4;
+  return meanOf(sorted + trim, filter.count - 2 * trim);
+}
+
+void setDecimationMode(DecimationMode mode) {
+  decimationMode = mode;
+}
+
+void sampleFilterAdd(const SensorReading& sample) {
+  stats.samples++;
+  if (isnan(sample.temperature) && isnan(sample.humidity) && isnan(sample.pressure)) {
+    stats.invalidSamples++;
+    return;
+  }
+
+  decimationAdd(temperatureFilter, sample.temperature);
+  decimationAdd(humidityFilter, sample.humidity);
+  decimationAdd(pressureFilter, sample.pressure);
+  blockSamples++;
+  lastSampleTime = sample.timestamp;
+}
+
+bool sampleFilterTake(SensorReading& reading) {
+  if (blockSamples == 0) {
+    return false;
+  }
+
+  reading.temperature = decimationOutput(temperatureFilter, decimationMode);
+  reading.humidity = decimationOutput(humidityFilter, decimationMode);
+  reading.pressure = decimationOutput(pressureFilter, decimationMode);
+  reading.timestamp = lastSampleTime;
+
+  decimationReset(temperatureFilter);
+  decimationReset(humidityFilter);
+  decimationReset(pressureFilter);
+  blockSamples = 0;
+  stats.outputs++;
+  return true;
+}
+
+SampleFilterStats getSampleFilterStats() {
+  return stats;
+}
+
+const char* decimationModeToString(DecimationMode mode) {
+  switch (mode) {
+    case DecimationMode::MEAN: return "mean";
+    case DecimationMode::MEDIAN: return "median";
+    case DecimationMode::TRIMMED_MEAN: return "trimmed mean";
+    default: return "unknown";
+  }
+}
+
+void printSampleFilterStatus() {
+  Serial.println("=== Sample Filter ===");
+  Serial.printf("Mode: %s\n", decimationModeToString(decimationMode));
+  Serial.printf("Samples: %lu (%lu invalid)\n", stats.samples, stats.invalidSamples);
+  if (stats.outputs > 0) {
+    Serial.printf("Samples per reading: %.1f\n",
+                  (float)(stats.samples - stats.invalidSamples) / stats.outputs);
+  }
+  Serial.println("=====================");
+}
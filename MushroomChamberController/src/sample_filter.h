@@ -0,0 +1,46 @@
+#ifndef SAMPLE_FILTER_H
+#define SAMPLE_FILTER_H
+
+#include <stdint.h>
+#include "sensors.h"
+
+// High-rate BME280 samples are collected here and reduced to one clean
+// reading per publish period, so sensing is no longer tied to control.
+
+#define SAMPLE_FILTER_CAPACITY 32   // Newest samples kept per publish period
+
+enum class DecimationMode {
+  MEAN,
+  MEDIAN,
+  TRIMMED_MEAN    // Drops the outer quartiles, then averages: spike-proof and smooth
+};
+
+// Block of samples for one channel; NaN samples are never stored
+struct DecimationFilter {
+  float samples[SAMPLE_FILTER_CAPACITY];
+  uint8_t count;
+  uint8_t next;
+};
+
+struct SampleFilterStats {
+  unsigned long samples;
+  unsigned long invalidSamples;   // Failed reads, all channels NaN
+  unsigned long outputs;
+};
+
+// --- Single Channel ---
+void decimationReset(DecimationFilter& filter);
+void decimationAdd(DecimationFilter& filter, float value);   // NaN is ignored
+float decimationOutput(const DecimationFilter& filter, DecimationMode mode);   // NaN when empty
+
+// --- Sensor Channels ---
+void setDecimationMode(DecimationMode mode);
+void sampleFilterAdd(const SensorReading& sample);
+bool sampleFilterTake(SensorReading& reading);   // Reduces and clears the block; false if no samples
+
+// --- Status Functions ---
+SampleFilterStats getSampleFilterStats();
+const char* decimationModeToString(DecimationMode mode);
+void printSampleFilterStatus();
+
+#endif
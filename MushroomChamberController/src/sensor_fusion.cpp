@@ -0,0 +1,170 @@
+#include "sensor_fusion.h"
+#include <Arduino.h>
+#include <math.h>
+
+// Random-walk process noise: how fast the chamber can drift per second
+#define TEMPERATURE_PROCESS_NOISE 0.0025f   // (0.05 °C)^2 per s
+#define HUMIDITY_PROCESS_NOISE    0.04f     // (0.2 %RH)^2 per s
+
+// Secondary bias follows the primary with a ~40 s time constant at 0.5 Hz
+#define FUSION_BIAS_ALPHA 0.05f
+
+struct FusionChannel {
+  bool initialized;
+  float estimate;
+  float variance;
+  unsigned long time;
+  float processNoise;
+  float bias[FUSION_MAX_SOURCES];
+  unsigned long lastSeen[FUSION_MAX_SOURCES];
+  bool seen[FUSION_MAX_SOURCES];
+};
+
+// --- Fusion State ---
+static FusionSourceConfig sources[FUSION_MAX_SOURCES] = {
+  { "BME280", 0.05f, 0.2f, SENSOR_STALE_MS },
+  { "DHT22", 0.2f, 0.5f, 10000 },
+};
+static FusionChannel temperatureChannel;
+static FusionChannel humidityChannel;
+static SensorHealth fusedHealth = SensorHealth::DEGRADED;
+
+static void resetChannel(FusionChannel& channel, float processNoise) {
+  channel.initialized = false;
+  channel.estimate = NAN;
+  channel.variance = 0.0f;
+  channel.time = 0;
+  channel.processNoise = processNoise;
+  for (uint8_t i = 0; i < FUSION_MAX_SOURCES; i++) {
+    channel.bias[i] = 0.0f;
+    channel.lastSeen[i] = 0;
+    channel.seen[i] = false;
+  }
+}
+
+void fusionReset() {
+  resetChannel(temperatureChannel, TEMPERATURE_PROCESS_NOISE);
+  resetChannel(humidityChannel, HUMIDITY_PROCESS_NOISE);
+  fusedHealth = SensorHealth::DEGRADED;
+}
+
+void fusionConfigureSource(uint8_t source, const FusionSourceConfig& config) {
+  if (source < FUSION_MAX_SOURCES) {
+    sources[source] = config;
+  }
+}
+
+static bool isChannelFresh(const FusionChannel& channel, uint8_t source, unsigned long now) {
+  return channel.seen[source] && now - channel.lastSeen[source] < sources[source].staleAfterMs;
+}
+
+static float predictedVariance(const FusionChannel& channel, unsigned long now) {
+  float elapsedSec = (long)(now - channel.time) > 0 ? (now - channel.time) / 1000.0f : 0.0f;
+  return channel.variance + channel.processNoise * elapsedSec;
+}
+
+static void updateChannel(FusionChannel& channel, uint8_t source, float value, float noise,
+                          unsigned long timestamp) {
+  if (isnan(value)) {
+    return;
+  }
+
+  float measurementVariance = noise * noise;
+  if (!channel.initialized) {
+    channel.initialized = true;
+    channel.estimate = value;
+    channel.variance = measurementVariance;
+    channel.time = timestamp;
+  } else {
+    // Learn the secondary's offset only while the primary anchors the estimate
+    if (source != FUSION_SOURCE_BME280 && isChannelFresh(channel, FUSION_SOURCE_BME280, timestamp)) {
+      float offset = value - channel.estimate;
+      channel.bias[source] = channel.seen[source]
+          ? channel.bias[source] + FUSION_BIAS_ALPHA * (offset - channel.bias[source])
+          : offset;
+    }
+
+    float prior = predictedVariance(channel, timestamp);
+    float gain = prior / (prior + measurementVariance);
+    channel.estimate += gain * (value - channel.bias[source] - channel.estimate);
+    channel.variance = (1.0f - gain) * prior;
+    if ((long)(timestamp - channel.time) > 0) {
+      channel.time = timestamp;
+    }
+  }
+
+  channel.seen[source] = true;
+  channel.lastSeen[source] = timestamp;
+}
+
+void fusionUpdate(uint8_t source, float temperature, float humidity, unsigned long timestamp) {
+  if (source >= FUSION_MAX_SOURCES) {
+    return;
+  }
+  updateChannel(temperatureChannel, source, temperature, sources[source].temperatureNoise, timestamp);
+  updateChannel(humidityChannel, source, humidity, sources[source].humidityNoise, timestamp);
+}
+
+bool isFusionSourceFresh(uint8_t source, unsigned long now) {
+  return source < FUSION_MAX_SOURCES &&
+         isChannelFresh(temperatureChannel, source, now) && isChannelFresh(humidityChannel, source, now);
+}
+
+FusedEstimate fusionEstimate(unsigned long now) {
+  FusedEstimate fused;
+  fused.freshSources = 0;
+  uint8_t seenSources = 0;
+  bool temperatureFresh = false;
+  bool humidityFresh = false;
+
+  for (uint8_t i = 0; i < FUSION_MAX_SOURCES; i++) {
+    if (temperatureChannel.seen[i] || humidityChannel.seen[i]) seenSources++;
+    if (isFusionSourceFresh(i, now)) fused.freshSources++;
+    if (isChannelFresh(temperatureChannel, i, now)) temperatureFresh = true;
+    if (isChannelFresh(humidityChannel, i, now)) humidityFresh = true;
+  }
+
+  fused.temperature = temperatureFresh ? temperatureChannel.estimate : NAN;
+  fused.humidity = humidityFresh ? humidityChannel.estimate : NAN;
+  fused.temperatureStddev = sqrtf(predictedVariance(temperatureChannel, now));
+  fused.humidityStddev = sqrtf(predictedVariance(humidityChannel, now));
+
+  // A sensor that never reported (e.g. no DHT22 fitted) does not degrade health
+  if (!temperatureFresh || !humidityFresh) {
+    fusedHealth = SensorHealth::FAILED;
+  } else if (fused.freshSources < seenSources) {
+    fusedHealth = SensorHealth::DEGRADED;
+  } else {
+    fusedHealth = SensorHealth::OK;
+  }
+  return fused;
+}
+
+SensorHealth getFusedHealth() {
+  return fusedHealth;
+}
+
+float getFusionBias(uint8_t source, bool humidity) {
+  if (source >= FUSION_MAX_SOURCES) {
+    return 0.0f;
+  }
+  return humidity ? humidityChannel.bias[source] : temperatureChannel.bias[source];
+}
+
+void printFusionStatus() {
+  unsigned long now = millis();
+  Serial.println("=== Sensor Fusion ===");
+  Serial.printf("Health: %s\n", sensorHealthToString(fusedHealth));
+  for (uint8_t i = 0; i < FUSION_MAX_SOURCES; i++) {
+    if (!humidityChannel.seen[i] && !temperatureChannel.seen[i]) {
+      Serial.printf("%s: never reported\n", sources[i].name);
+      continue;
+    }
+    Serial.printf("%s: %s (bias %+.2f %%RH, %+.2f °C)\n", sources[i].name,
+                  isFusionSourceFresh(i, now) ? "fresh" : "stale",
+                  humidityChannel.bias[i], temperatureChannel.bias[i]);
+  }
+  Serial.printf("Humidity: %.2f ± %.2f %%RH\n", humidityChannel.estimate,
+                sqrtf(predictedVariance(humidityChannel, now)));
+  Serial.println("=====================");
+}
@@ -0,0 +1,45 @@
+#ifndef SENSOR_FUSION_H
+#define SENSOR_FUSION_H
+
+#include <stdint.h>
+#include "sensors.h"
+
+// Temperature and humidity from several sensors are combined by a scalar
+// Kalman filter per channel. Each source weighs in by its noise, sources
+// that stop reporting simply stop contributing, and secondary sources are
+// bias-corrected against the primary so a failover does not step the value.
+
+#define FUSION_MAX_SOURCES    2
+#define FUSION_SOURCE_BME280  0    // Primary: defines the absolute level
+#define FUSION_SOURCE_DHT22   1
+
+struct FusionSourceConfig {
+  const char* name;
+  float temperatureNoise;      // Measurement standard deviation, °C
+  float humidityNoise;         // Measurement standard deviation, %RH
+  unsigned long staleAfterMs;  // Dropped from the estimate after this long without data
+};
+
+struct FusedEstimate {
+  float temperature;           // NaN when no source is fresh
+  float humidity;
+  float temperatureStddev;
+  float humidityStddev;
+  uint8_t freshSources;        // Sources with fresh temperature and humidity
+};
+
+// --- Setup Functions ---
+void fusionConfigureSource(uint8_t source, const FusionSourceConfig& config);
+void fusionReset();
+
+// --- Fusion Functions ---
+void fusionUpdate(uint8_t source, float temperature, float humidity, unsigned long timestamp);  // NaN is skipped
+FusedEstimate fusionEstimate(unsigned long now);   // Also updates the fused health
+
+// --- Status Functions ---
+SensorHealth getFusedHealth();   // FAILED without any fresh source, DEGRADED after a failover
+bool isFusionSourceFresh(uint8_t source, unsigned long now);
+float getFusionBias(uint8_t source, bool humidity);
+void printFusionStatus();
+
+#endif
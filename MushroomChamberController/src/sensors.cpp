@@ -1,28 +1,299 @@
 #include "sensors.h"
-#include <Adafruit_BME280.h>
+#include "sensor_fusion.h"
+#include "hal/hal.h"
+#include <Arduino.h>
+#include <math.h>
 
 
 // --- BME280 Setup ---
-Adafruit_BME280 bme;
-#define BME_ADDR 0x76
+#define BME_ADDR BME280_ADDR_PRIMARY
+#define I2C_SDA_PIN 21
+#define I2C_SCL_PIN 22
+
+// --- DHT22 Setup ---
+#define DHT_PIN 4
+#define DHT_READ_INTERVAL_MS 2000   // The DHT22 cannot convert faster than 0.5 Hz
+
+// Normal mode with short standby so a fresh conversion is ready every
+// ~80 ms for 10 Hz sampling; the decimation filter does the smoothing,
+// so oversampling and the on-chip IIR filter stay light
+static Bme280Settings highRateSettings() {
+  Bme280Settings settings = bme280DefaultSettings();
+  settings.temperatureOversampling = Bme280Oversampling::X1;
+  settings.pressureOversampling = Bme280Oversampling::X4;
+  settings.humidityOversampling = Bme280Oversampling::X1;
+  settings.filter = Bme280Filter::X2;
+  settings.standby = Bme280Standby::MS_62_5;
+  return settings;
+}
+
+static bool sensorFound = false;
+static uint8_t sensorAddress = BME_ADDR;
+static Bme280Settings sensorSettings = highRateSettings();
+static unsigned long samplesRead = 0;
+static unsigned long sampleTransactions = 0;   // I2C transactions spent in readEnvironment()
+
+// --- Bus Recovery State ---
+static uint16_t consecutiveFailures = 0;
+static unsigned long nextRecoveryAttempt = 0;
+static unsigned long recoveryBackoffMs = SENSOR_RECOVERY_BACKOFF_MS;
+
+// --- Validation State ---
+// Plausible range and fastest credible change of each channel
+struct ChannelLimits {
+  float min;
+  float max;
+  float maxRatePerSec;
+  float noiseMargin;    // Always allowed on top of the rate limit
+};
+
+struct ChannelState {
+  bool haveGood;
+  float lastGood;
+  unsigned long lastGoodTime;
+  uint8_t rejectStreak;     // Consecutive rejected values at about the same new level
+  float stepLevel;          // Last rejected value
+  unsigned long stepTime;
+};
+
+static const ChannelLimits TEMPERATURE_LIMITS = { -40.0f, 85.0f, 2.0f, 0.3f };
+static const ChannelLimits HUMIDITY_LIMITS = { 0.0f, 100.0f, 15.0f, 1.0f };
+static const ChannelLimits PRESSURE_LIMITS = { 300.0f, 1100.0f, 5.0f, 0.5f };
+
+static ChannelState temperatureState;
+static ChannelState humidityState;
+static ChannelState pressureState;
+static ChannelState dhtTemperatureState;
+static ChannelState dhtHumidityState;
+static unsigned long lastDhtRead = 0;
+static unsigned long dhtSamples = 0;
+static SensorHealth health = SensorHealth::DEGRADED;
+static bool haveValidSample = false;
+static unsigned long lastValidTime = 0;
+static unsigned long lastRejectTime = 0;
+static bool anyRejected = false;
+static bool validationStarted = false;
+static SensorValidationStats validationStats = { 0, 0, 0, 0, 0 };
+static SensorValidationStats backupValidationStats = { 0, 0, 0, 0, 0 };   // DHT22; no bus recovery
 
 
 void setupSensors() {
   Serial.println("Initializing sensors...");
 
-  if (!bme.begin(BME_ADDR)) {
+  sensorAddress = BME_ADDR;
+  sensorFound = bme280Begin(sensorAddress, sensorSettings);
+  if (!sensorFound) {
+    sensorAddress = BME280_ADDR_SECONDARY;
+    sensorFound = bme280Begin(sensorAddress, sensorSettings);
+  }
+  if (!sensorFound) {
     Serial.println("Could not find BME280 sensor!");
   }
+
+  halDhtSetup(DHT_PIN);
+  lastDhtRead = millis();   // First conversion needs the full interval
+  fusionReset();
+}
+
+bool setSensorSettings(const Bme280Settings& settings) {
+  sensorSettings = settings;
+  return sensorFound && bme280Configure(settings);
+}
+
+Bme280Settings getSensorSettings() {
+  return sensorSettings;
+}
+
+static void attemptRecovery(unsigned long now) {
+  Serial.printf("⚠️  BME280 not answering (%u reads) - recovering I2C bus\n", consecutiveFailures);
+  validationStats.busRecoveries++;
+  halI2cRecoverBus(I2C_SDA_PIN, I2C_SCL_PIN);
+
+  sensorFound = bme280Begin(sensorAddress, sensorSettings);
+  if (sensorFound) {
+    Serial.println("✅ BME280 re-initialized");
+    recoveryBackoffMs = SENSOR_RECOVERY_BACKOFF_MS;
+    consecutiveFailures = 0;
+  } else {
+    validationStats.reinitFailures++;
+    nextRecoveryAttempt = now + recoveryBackoffMs;
+    recoveryBackoffMs = min(recoveryBackoffMs * 2, (unsigned long)SENSOR_RECOVERY_MAX_MS);
+  }
+}
+
+SensorReading readEnvironment() {
+  SensorReading reading = { NAN, NAN, NAN, millis() };
+
+  Bme280Sample sample;
+  unsigned long transactionsBefore = bme280TransactionCount();
+  if (sensorFound && bme280ReadSample(sample)) {
+    reading.temperature = sample.temperature;
+    reading.humidity = sample.humidity;
+    reading.pressure = sample.pressure;
+    samplesRead++;
+    consecutiveFailures = 0;
+  } else {
+    validationStats.failedReads++;
+    consecutiveFailures++;
+  }
+  sampleTransactions += bme280TransactionCount() - transactionsBefore;
+
+  if (consecutiveFailures >= SENSOR_RECOVERY_AFTER && (long)(reading.timestamp - nextRecoveryAttempt) >= 0) {
+    attemptRecovery(reading.timestamp);
+  }
+
+  validateSample(reading);
+  return reading;
+}
+
+// --- Validation Functions ---
+static void resetChannel(ChannelState& state) {
+  state.haveGood = false;
+  state.lastGood = NAN;
+  state.lastGoodTime = 0;
+  state.rejectStreak = 0;
+  state.stepLevel = NAN;
+  state.stepTime = 0;
+}
+
+void resetSensorValidation() {
+  resetChannel(temperatureState);
+  resetChannel(humidityState);
+  resetChannel(pressureState);
+  health = SensorHealth::DEGRADED;
+  haveValidSample = false;
+  anyRejected = false;
+  validationStarted = false;
+}
+
+// Returns false and sets the value to NaN when it cannot be trusted
+static bool validateChannel(float& value, const ChannelLimits& limits, ChannelState& state,
+                            unsigned long timestamp, SensorValidationStats& stats) {
+  if (isnan(value)) {
+    return false;
+  }
+  if (value < limits.min || value > limits.max) {
+    stats.outOfRange++;
+    value = NAN;
+    return false;
+  }
+
+  if (state.haveGood) {
+    float elapsedSec = (timestamp - state.lastGoodTime) / 1000.0f;
+    float allowed = limits.maxRatePerSec * elapsedSec + limits.noiseMargin;
+    // A genuine step keeps reading the new level; glitches scatter, so
+    // each one that lands elsewhere starts the count again
+    if (fabsf(value - state.lastGood) > allowed) {
+      float stepAllowed = limits.maxRatePerSec * (timestamp - state.stepTime) / 1000.0f + limits.noiseMargin;
+      bool sameLevel = state.rejectStreak > 0 && fabsf(value - state.stepLevel) <= stepAllowed;
+      state.rejectStreak = sameLevel ? state.rejectStreak + 1 : 1;
+      state.stepLevel = value;
+      state.stepTime = timestamp;
+      if (state.rejectStreak < SENSOR_STEP_ACCEPT) {
+        stats.rateLimited++;
+        value = NAN;
+        return false;
+      }
+    }
+  }
+
+  state.haveGood = true;
+  state.lastGood = value;
+  state.lastGoodTime = timestamp;
+  state.rejectStreak = 0;
+  return true;
 }
 
-float readTemperature() {
-  return bme.readTemperature();
+void validateSample(SensorReading& sample) {
+  if (!validationStarted) {
+    validationStarted = true;
+    lastValidTime = sample.timestamp;   // Grace period before a missing sensor counts as FAILED
+  }
+
+  bool rawComplete = !isnan(sample.temperature) && !isnan(sample.humidity) && !isnan(sample.pressure);
+  bool temperatureOk = validateChannel(sample.temperature, TEMPERATURE_LIMITS, temperatureState,
+                                       sample.timestamp, validationStats);
+  bool humidityOk = validateChannel(sample.humidity, HUMIDITY_LIMITS, humidityState,
+                                    sample.timestamp, validationStats);
+  bool pressureOk = validateChannel(sample.pressure, PRESSURE_LIMITS, pressureState,
+                                    sample.timestamp, validationStats);
+
+  if (temperatureOk && humidityOk) {
+    haveValidSample = true;
+    lastValidTime = sample.timestamp;
+  }
+  if (!rawComplete || !temperatureOk || !humidityOk || !pressureOk) {
+    anyRejected = true;
+    lastRejectTime = sample.timestamp;
+  }
+
+  // The controller acts on temperature and humidity; pressure only degrades
+  if (sample.timestamp - lastValidTime >= SENSOR_STALE_MS) {
+    health = SensorHealth::FAILED;
+  } else if (!haveValidSample || (anyRejected && sample.timestamp - lastRejectTime < SENSOR_STALE_MS)) {
+    health = SensorHealth::DEGRADED;
+  } else {
+    health = SensorHealth::OK;
+  }
 }
 
-float readHumidity() {
-  return bme.readHumidity();
+bool readBackupSensor(SensorReading& reading) {
+  unsigned long now = millis();
+  if (now - lastDhtRead < DHT_READ_INTERVAL_MS) {
+    return false;
+  }
+  lastDhtRead = now;
+
+  reading.pressure = NAN;
+  reading.timestamp = now;
+  if (!halDhtRead(reading.temperature, reading.humidity)) {
+    backupValidationStats.failedReads++;
+    return false;
+  }
+
+  validateChannel(reading.temperature, TEMPERATURE_LIMITS, dhtTemperatureState, now, backupValidationStats);
+  validateChannel(reading.humidity, HUMIDITY_LIMITS, dhtHumidityState, now, backupValidationStats);
+  dhtSamples++;
+  return true;
+}
+
+SensorHealth getSensorHealth() {
+  return health;
+}
+
+const char* sensorHealthToString(SensorHealth sensorHealth) {
+  switch (sensorHealth) {
+    case SensorHealth::OK: return "OK";
+    case SensorHealth::DEGRADED: return "DEGRADED";
+    case SensorHealth::FAILED: return "FAILED";
+    default: return "UNKNOWN";
+  }
+}
+
+SensorValidationStats getSensorValidationStats() {
+  return validationStats;
 }
 
-float readPressure() {
-  return bme.readPressure() / 100.0F; // in hPa
+SensorValidationStats getBackupSensorValidationStats() {
+  return backupValidationStats;
+}
+
+void printSensorStatus() {
+  Serial.println("=== Sensor Status ===");
+  Serial.printf("BME280: %s at 0x%02X (%s mode)\n", sensorFound ? "found" : "missing", sensorAddress,
+                sensorSettings.mode == Bme280Mode::FORCED ? "forced" : "normal");
+  Serial.printf("Health: %s\n", sensorHealthToString(health));
+  Serial.printf("Samples: %lu (%lu failed)\n", samplesRead, validationStats.failedReads);
+  if (samplesRead > 0) {
+    Serial.printf("I2C transactions per sample: %.2f\n",
+                  (float)sampleTransactions / (samplesRead + validationStats.failedReads));
+  }
+  Serial.printf("Rejected: %lu out of range, %lu rate limited\n",
+                validationStats.outOfRange, validationStats.rateLimited);
+  Serial.printf("DHT22: %lu samples (%lu failed), rejected %lu out of range, %lu rate limited\n",
+                dhtSamples, backupValidationStats.failedReads,
+                backupValidationStats.outOfRange, backupValidationStats.rateLimited);
+  Serial.printf("Bus recoveries: %lu (%lu re-init failures)\n",
+                validationStats.busRecoveries, validationStats.reinitFailures);
+  Serial.println("=====================");
 }
@@ -1,9 +1,56 @@
 #ifndef SENSORS_H
 #define SENSORS_H
 
+#include "bme280_burst.h"
+
+// One sample of all environmental values, stamped with millis()
+struct SensorReading {
+  float temperature;
+  float humidity;
+  float pressure;
+  unsigned long timestamp;
+};
+
+// Whether the controller can trust the readings
+enum class SensorHealth {
+  OK,
+  DEGRADED,   // Values were rejected recently or no valid sample yet
+  FAILED      // No valid temperature and humidity for SENSOR_STALE_MS
+};
+
+// --- Validation Limits ---
+#define SENSOR_STALE_MS            5000    // Without valid data for this long the sensor is FAILED
+#define SENSOR_RECOVERY_AFTER      10      // Consecutive failed reads before I2C bus recovery
+#define SENSOR_RECOVERY_BACKOFF_MS 1000    // First retry delay, doubles up to the max
+#define SENSOR_RECOVERY_MAX_MS     60000
+#define SENSOR_STEP_ACCEPT         5       // Consecutive rate-limited samples at one new level accepted as a real step
+
+struct SensorValidationStats {
+  unsigned long failedReads;     // Sensor did not answer
+  unsigned long outOfRange;      // Values outside the BME280 operating range
+  unsigned long rateLimited;     // Values that jumped faster than the chamber can change
+  unsigned long busRecoveries;
+  unsigned long reinitFailures;
+};
+
 void setupSensors();
-float readTemperature();
-float readHumidity();
-float readPressure(); 
+bool setSensorSettings(const Bme280Settings& settings);   // Oversampling, IIR filter, forced/normal mode
+Bme280Settings getSensorSettings();
+
+// All values from a single burst read, validated; rejected values are NaN
+SensorReading readEnvironment();
+
+// DHT22 backup sensor; true when a new validated sample was taken (at most every 2 s)
+bool readBackupSensor(SensorReading& reading);
+
+// --- Validation Functions ---
+void validateSample(SensorReading& sample);   // Range and rate-of-change checks, updates health
+void resetSensorValidation();
+SensorHealth getSensorHealth();
+const char* sensorHealthToString(SensorHealth health);
+SensorValidationStats getSensorValidationStats();         // BME280
+SensorValidationStats getBackupSensorValidationStats();   // DHT22
+
+void printSensorStatus();
 
 #endif
@@ -0,0 +1,206 @@
+#ifndef ARDUINO
+
+#include "chamber_sim.h"
+#include "../hal/hal.h"
+#include "../actuators.h"
+#include "../config.h"
+#include "../sensor_fusion.h"
+#include "../control_trace.h"
+#include "../relay_autotune.h"
+#include "../ventilation_modes.h"
+#include "../thermal_outputs.h"
+#include <Arduino.h>
+
+#define SIM_STEP_MS 1000   // Controller period, the default control tick
+
+ChamberPlant chamberDefaultPlant() {
+  // Roughly a 150 L tent with an ultrasonic fogger and three 80 mm fans:
+  // fogging from 45 % to 90 % takes about five minutes, a 30 s air
+  // exchange drops about 10 %RH, and the chamber loses ~2 %RH per minute
+  ChamberPlant plant;
+  plant.ambientTemperature = 20.0f;
+  plant.ambientHumidity = 45.0f;
+  plant.humidifierGain = 0.25f;
+  plant.humidityLeakRate = 0.0005f;
+  plant.fanExchangeRate = 0.01f;
+  for (int i = 0; i < FAN_COUNT; i++) {
+    plant.fanAirflow[i] = 1.0f / FAN_COUNT;   // Identical fans
+  }
+  plant.thermalLeakRate = 0.0005f;
+  plant.humidifierCooling = 0.001f;
+  plant.heatGain = 0.0005f;
+  plant.heaterGain = 0.0f;     // Neither fitted by default
+  plant.coolerGain = 0.0f;
+  plant.sensorNoise = 0.2f;
+  plant.humidifierWatts = 24.0f;
+  plant.fanWatts = 7.2f;
+  plant.heaterWatts = 100.0f;
+  plant.coolerWatts = 60.0f;
+  return plant;
+}
+
+void chamberStep(const ChamberPlant& plant, ChamberState& state, bool humidifierOn, float fanAirflow, float dtSec,
+                 bool heaterOn, bool coolerOn) {
+  float exchange = plant.humidityLeakRate + fanAirflow * plant.fanExchangeRate;
+  float dH = -exchange * (state.humidity - plant.ambientHumidity);
+  if (humidifierOn) {
+    dH += plant.humidifierGain * (100.0f - state.humidity) / (100.0f - plant.ambientHumidity);
+  }
+
+  float thermalExchange = plant.thermalLeakRate + fanAirflow * plant.fanExchangeRate;
+  float dT = -thermalExchange * (state.temperature - plant.ambientTemperature) + plant.heatGain;
+  if (humidifierOn) {
+    dT -= plant.humidifierCooling;
+  }
+  if (heaterOn) {
+    dT += plant.heaterGain;
+  }
+  if (coolerOn) {
+    dT -= plant.coolerGain;
+  }
+
+  state.humidity = constrain(state.humidity + dH * dtSec, 0.0f, 100.0f);
+  state.temperature += dT * dtSec;
+}
+
+// --- Sensor Noise ---
+// Fixed seed so every run of a scenario scores the same
+static uint32_t noiseState = 1;
+
+static float uniformNoise() {
+  noiseState = noiseState * 1664525UL + 1013904223UL;
+  return (noiseState >> 8) / 16777216.0f;
+}
+
+static float gaussianNoise(float stddev) {
+  // Irwin-Hall: sum of 12 uniforms has unit variance
+  float sum = 0.0f;
+  for (int i = 0; i < 12; i++) {
+    sum += uniformNoise();
+  }
+  return (sum - 6.0f) * stddev;
+}
+
+// --- Simulation ---
+ChamberSimKpis chamberSimulate(const ChamberPlant& plant, MushroomType type,
+                               const ChamberSimPhase* phases, size_t phaseCount,
+                               unsigned long settleSec) {
+  ChamberSimKpis kpis = {};
+  unsigned long scoredSec = 0;
+  unsigned long inToleranceSec = 0;
+  double absErrorSum = 0.0;
+  unsigned long temperatureInToleranceSec = 0;
+  double temperatureErrorSum = 0.0;
+
+  bool wasSerialEnabled = Serial.outputEnabled();
+  Serial.setOutputEnabled(false);
+
+  noiseState = 1;
+  currentConfig = getMushroomConfig(type);
+  fusionReset();
+  clearPhaseTunings();
+  clearVentilationModeStats();
+  clearControllerCheckpoint();
+  setThermalOutputs(plant.heaterGain > 0.0f, plant.coolerGain > 0.0f);
+  setupActuators();
+
+  ChamberState chamber = { plant.ambientTemperature, plant.ambientHumidity };
+  bool humidifierWasOn = false;
+  bool fansWereOn = false;
+  double fanEnergyWs = 0.0;
+
+  for (size_t p = 0; p < phaseCount; p++) {
+    currentPhase = phases[p].phase;
+    activePhaseConfig = getActivePhaseConfig();
+    if (phases[p].autoVentilation) {
+      activePhaseConfig.ventilationMode = VentilationMode::AUTO;
+    }
+    float target = activePhaseConfig.targetHumidity;
+    float tolerance = activePhaseConfig.humidityTolerance;
+    bool autotunePending = phases[p].autotune;
+
+    for (unsigned long sec = 0; sec < phases[p].durationSec; sec++) {
+      bool humidifierOn = isHumidifierOn();
+      bool heaterOn = isHeaterOn();
+      bool coolerOn = isCoolerOn();
+      // Fan affinity laws: airflow follows speed, power its cube
+      float fanAirflow = 0.0f;
+      for (int i = 0; i < FAN_COUNT; i++) {
+        float duty = getFanDuty((FanId)i);
+        fanAirflow += plant.fanAirflow[i] * duty;
+        fanEnergyWs += plant.fanWatts / FAN_COUNT * duty * duty * duty;
+      }
+      bool fansOn = areFansOn();
+      chamberStep(plant, chamber, humidifierOn, fanAirflow, SIM_STEP_MS / 1000.0f, heaterOn, coolerOn);
+      halNativeAdvanceMillis(SIM_STEP_MS);
+
+      // Same path as the sensor task: fuse, then hand the estimate to the controller
+      float reported = chamber.humidity + gaussianNoise(plant.sensorNoise);
+      fusionUpdate(FUSION_SOURCE_BME280, chamber.temperature, reported, millis());
+      FusedEstimate estimate = fusionEstimate(millis());
+      if (autotunePending && sec > 0) {
+        startAutotune();   // After the first reading, so the controller has a humidity
+        autotunePending = false;
+      }
+      updateActuators(estimate.humidity, estimate.temperature, 1013.25f, SIM_STEP_MS / 1000.0f);
+      writeStagedCheckpoints();   // The comms task's job on the device
+      traceRecord(estimate.humidity, estimate.temperature, 1013.25f);
+
+      if (humidifierOn && !humidifierWasOn) kpis.humidifierCycles++;
+      if (fansOn && !fansWereOn) kpis.fanCycles++;
+      if (humidifierOn) kpis.humidifierOnSec++;
+      if (fansOn) kpis.fanOnSec++;
+      if (heaterOn) kpis.heaterOnSec++;
+      if (coolerOn) kpis.coolerOnSec++;
+      humidifierWasOn = humidifierOn;
+      fansWereOn = fansOn;
+      kpis.simulatedSec++;
+
+      if (sec < settleSec) {
+        continue;
+      }
+      float error = chamber.humidity - target;
+      scoredSec++;
+      absErrorSum += fabs(error);
+      if (fabs(error) <= tolerance) inToleranceSec++;
+      kpis.maxOvershoot = max(kpis.maxOvershoot, error);
+      kpis.maxUndershoot = max(kpis.maxUndershoot, -error);
+
+      float temperatureError = fabs(chamber.temperature - activePhaseConfig.targetTemperature);
+      temperatureErrorSum += temperatureError;
+      if (temperatureError <= activePhaseConfig.temperatureTolerance) temperatureInToleranceSec++;
+    }
+  }
+
+  if (scoredSec > 0) {
+    kpis.timeInTolerance = (float)inToleranceSec / scoredSec;
+    kpis.meanAbsError = absErrorSum / scoredSec;
+    kpis.temperatureInTolerance = (float)temperatureInToleranceSec / scoredSec;
+    kpis.temperatureMeanAbsError = temperatureErrorSum / scoredSec;
+  }
+  kpis.energyWh = (kpis.humidifierOnSec * plant.humidifierWatts + kpis.heaterOnSec * plant.heaterWatts +
+                   kpis.coolerOnSec * plant.coolerWatts + fanEnergyWs) / 3600.0f;
+
+  Serial.setOutputEnabled(wasSerialEnabled);
+  return kpis;
+}
+
+void printChamberKpis(const ChamberSimKpis& kpis) {
+  Serial.println("\n========== Simulation KPIs ==========");
+  Serial.printf("Simulated: %.1f days\n", kpis.simulatedSec / 86400.0f);
+  Serial.printf("Humidity in tolerance: %.1f%% of the time (mean error %.2f%%)\n",
+                kpis.timeInTolerance * 100.0f, kpis.meanAbsError);
+  Serial.printf("Worst overshoot: +%.1f%%, worst undershoot: -%.1f%%\n",
+                kpis.maxOvershoot, kpis.maxUndershoot);
+  Serial.printf("Temperature in tolerance: %.1f%% of the time (mean error %.2f°C)\n",
+                kpis.temperatureInTolerance * 100.0f, kpis.temperatureMeanAbsError);
+  Serial.printf("Humidifier: %lu cycles, %.1f h on\n", kpis.humidifierCycles, kpis.humidifierOnSec / 3600.0f);
+  Serial.printf("Fans: %lu cycles, %.1f h on\n", kpis.fanCycles, kpis.fanOnSec / 3600.0f);
+  if (kpis.heaterOnSec > 0 || kpis.coolerOnSec > 0) {
+    Serial.printf("Heater: %.1f h on, cooler: %.1f h on\n", kpis.heaterOnSec / 3600.0f, kpis.coolerOnSec / 3600.0f);
+  }
+  Serial.printf("Energy: %.1f Wh\n", kpis.energyWh);
+  Serial.println("=====================================");
+}
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef CHAMBER_SIM_H
+#define CHAMBER_SIM_H
+
+#include <stddef.h>
+#include "../mushroom_types.h"
+#include "../fan_driver.h"
+
+// Host-side plant model of the chamber, driven by the native HAL's virtual
+// clock. chamberSimulate() runs the real updateActuators() against it one
+// control period at a time, so weeks of growing take seconds. Only built
+// for [env:native].
+
+// First-order model: both quantities relax toward ambient, faster with the
+// fans running; the humidifier adds moisture and cools by evaporation, the
+// optional heater and cooler move the temperature at a fixed rate
+struct ChamberPlant {
+  float ambientTemperature;    // °C
+  float ambientHumidity;       // %RH
+  float humidifierGain;        // %RH/s from ambient with the humidifier on, shrinking to 0 at 100 %
+  float humidityLeakRate;      // 1/s, fraction of the gap to ambient closed per second, fans off
+  float fanExchangeRate;       // 1/s added with all fans at full speed, proportional to airflow
+  float fanAirflow[FAN_COUNT]; // Share of fanExchangeRate each fan moves at full speed
+  float thermalLeakRate;       // 1/s, same for temperature
+  float humidifierCooling;     // °C/s while misting
+  float heatGain;              // °C/s from the LEDs and metabolism
+  float heaterGain;            // °C/s while the heater runs, 0 without one
+  float coolerGain;            // °C/s while the cooler runs, 0 without one
+  float sensorNoise;           // %RH standard deviation on the reported humidity
+  float humidifierWatts;
+  float fanWatts;              // All fans together at full speed, cubic in speed
+  float heaterWatts;
+  float coolerWatts;
+};
+
+struct ChamberState {
+  float temperature;
+  float humidity;
+};
+
+// One leg of a grow: which phase config the controller follows, for how long
+struct ChamberSimPhase {
+  GrowthPhase phase;
+  unsigned long durationSec;
+  bool autotune;               // Run the relay autotune when the phase starts
+  bool autoVentilation;        // Let the phase learn its ventilation mode (VentilationMode::AUTO)
+};
+
+struct ChamberSimKpis {
+  unsigned long simulatedSec;
+  float timeInTolerance;       // Fraction of seconds within target ± humidityTolerance
+  float meanAbsError;          // %RH
+  float maxOvershoot;          // %RH above target, 0 if never above
+  float maxUndershoot;         // %RH below target, 0 if never below
+  float temperatureInTolerance;     // Fraction of seconds within targetTemperature ± temperatureTolerance
+  float temperatureMeanAbsError;    // °C
+  unsigned long humidifierCycles;   // Off→on switches
+  unsigned long fanCycles;
+  unsigned long humidifierOnSec;
+  unsigned long fanOnSec;
+  unsigned long heaterOnSec;
+  unsigned long coolerOnSec;
+  float energyWh;
+};
+
+// --- Plant Functions ---
+ChamberPlant chamberDefaultPlant();
+// fanAirflow: 0 with the fans off, 1 with all of them at full speed
+void chamberStep(const ChamberPlant& plant, ChamberState& state, bool humidifierOn, float fanAirflow, float dtSec,
+                 bool heaterOn = false, bool coolerOn = false);
+
+// --- Simulation ---
+// Resets the controller, its phase tunings, its stored checkpoint and the
+// sensor fusion, installs a heater / cooler if the plant has one, starts the chamber at ambient and skips the first settleSec
+// of every phase when scoring (the controller needs time to reach a new target)
+ChamberSimKpis chamberSimulate(const ChamberPlant& plant, MushroomType type,
+                               const ChamberSimPhase* phases, size_t phaseCount,
+                               unsigned long settleSec = 1800);
+void printChamberKpis(const ChamberSimKpis& kpis);
+
+#endif
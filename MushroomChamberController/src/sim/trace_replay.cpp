@@ -0,0 +1,218 @@
+#ifndef ARDUINO
+
+#include "trace_replay.h"
+#include "../hal/hal.h"
+#include "../actuators.h"
+#include "../config.h"
+#include "../control_trace.h"
+#include "../sensor_fusion.h"
+#include "../relay_autotune.h"
+#include "../ventilation_modes.h"
+#include "../controller_store.h"
+#include <Arduino.h>
+
+// --- Loading Functions ---
+size_t traceParseLog(const char* text, uint8_t* out, size_t maxBytes) {
+  size_t length = 0;
+  const char* line = text;
+  while (line != NULL && *line != '\0' && length + TRACE_RECORD_SIZE <= maxBytes) {
+    const char* end = strchr(line, '\n');
+    std::string current = end ? std::string(line, end - line) : std::string(line);
+    if (traceParseLine(current.c_str(), out + length)) {
+      length += TRACE_RECORD_SIZE;
+    }
+    line = end ? end + 1 : NULL;
+  }
+  return length;
+}
+
+size_t traceLoadFile(const char* path, uint8_t* out, size_t maxBytes) {
+  FILE* file = fopen(path, "rb");
+  if (file == NULL) {
+    Serial.printf("❌ Cannot open trace %s\n", path);
+    return 0;
+  }
+  std::string contents;
+  char buffer[4096];
+  size_t read;
+  while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    contents.append(buffer, read);
+  }
+  fclose(file);
+
+  // A serial capture is text with TRACE: lines; anything else is a raw flash log
+  if (contents.find(TRACE_LINE_PREFIX) != std::string::npos) {
+    return traceParseLog(contents.c_str(), out, maxBytes);
+  }
+  size_t length = min(contents.size(), maxBytes);
+  length -= length % TRACE_RECORD_SIZE;
+  memcpy(out, contents.data(), length);
+  return length;
+}
+
+// --- Replay ---
+// Accumulates actuator KPIs from the flags of consecutive decisions
+static void countActuators(TraceActuatorKpis& kpis, uint8_t flags, uint8_t previousFlags, unsigned long dtMs) {
+  if ((flags & ACTUATOR_FLAG_HUMIDIFIER) && !(previousFlags & ACTUATOR_FLAG_HUMIDIFIER)) kpis.humidifierCycles++;
+  if ((flags & ACTUATOR_FLAG_FANS) && !(previousFlags & ACTUATOR_FLAG_FANS)) kpis.fanCycles++;
+  if (previousFlags & ACTUATOR_FLAG_HUMIDIFIER) kpis.humidifierOnMs += dtMs;
+  if (previousFlags & ACTUATOR_FLAG_FANS) kpis.fanOnMs += dtMs;
+}
+
+// Puts the fused health where updateActuators() will find it
+static void replayHealth(SensorHealth health, uint32_t timestampMs) {
+  if (health == SensorHealth::FAILED) {
+    fusionReset();
+  } else {
+    fusionUpdate(FUSION_SOURCE_BME280, 20.0f, 50.0f, timestampMs);
+  }
+  fusionEstimate(timestampMs);
+}
+
+// Brings the controller up like the device did at the boot marker: at its
+// time and phase, from the checkpoint recorded after it (if any)
+static void replayBoot(const TraceRecord& boot, const uint8_t* checkpoint, size_t checkpointLength) {
+  halNativeSetMillis(boot.timestampMs);
+  currentPhase = boot.phase;
+  activePhaseConfig = getActivePhaseConfig();
+  if (!isnan(boot.targetHumidity)) {
+    activePhaseConfig.targetHumidity = boot.targetHumidity;
+  }
+
+  // Nothing learned survives a reboot except through the checkpoint
+  clearPhaseTunings();
+  clearVentilationModeStats();
+  clearControllerCheckpoint();
+  if (checkpointLength > 0) {
+    writeStoredControllerCheckpoint(checkpoint, checkpointLength);
+  }
+  fusionReset();
+  setupActuators();
+}
+
+TraceReplayResult traceReplay(const uint8_t* data, size_t length, MushroomType type) {
+  TraceReplayResult result = {};
+  result.firstMismatch = -1;
+  size_t scored = 0;
+  size_t inTolerance = 0;
+  double absErrorSum = 0.0;
+
+  bool wasSerialEnabled = Serial.outputEnabled();
+  Serial.setOutputEnabled(false);
+
+  currentConfig = getMushroomConfig(type);
+  bool started = false;
+  uint32_t previousTime = 0;
+  uint8_t recordedFlags = 0;
+  uint8_t replayedFlags = 0;
+
+  // The controller comes up at the first decision after a boot marker,
+  // once the checkpoint records in between are collected
+  bool bootPending = false;
+  TraceRecord boot = {};
+  uint8_t checkpoint[CONTROLLER_STORE_MAX_BYTES];
+  size_t checkpointLength = 0;
+
+  for (size_t offset = 0; offset + TRACE_RECORD_SIZE <= length; offset += TRACE_RECORD_SIZE) {
+    const uint8_t* raw = data + offset;
+    if ((raw[16] & 0x0F) == TRACE_STATE_CHECKPOINT) {
+      size_t used = min((size_t)raw[17], (size_t)TRACE_CHECKPOINT_BYTES);
+      if (bootPending && checkpointLength + used <= sizeof(checkpoint)) {
+        memcpy(checkpoint + checkpointLength, raw, used);
+        checkpointLength += used;
+      }
+      continue;
+    }
+
+    TraceRecord record;
+    traceDecode(raw, record);
+    if (record.state == TRACE_STATE_BOOT) {
+      result.boots++;
+      boot = record;
+      bootPending = true;
+      checkpointLength = 0;
+      continue;
+    }
+
+    // A trace that starts mid-run still gets a fresh controller
+    if (bootPending || !started) {
+      if (!bootPending) {
+        boot = record;
+      }
+      replayBoot(boot, checkpoint, checkpointLength);
+      bootPending = false;
+      started = true;
+      recordedFlags = 0;
+      replayedFlags = 0;
+      previousTime = boot.timestampMs;
+    }
+
+    halNativeSetMillis(record.timestampMs);
+
+    currentPhase = record.phase;
+    activePhaseConfig = getActivePhaseConfig();
+    if (!isnan(record.targetHumidity)) {
+      activePhaseConfig.targetHumidity = record.targetHumidity;   // Covers server-side config edits
+    }
+
+
+    setControlMode(record.actuatorFlags & TRACE_FLAG_PID_MODE ? ControlMode::PID : ControlMode::BANG_BANG);
+    replayHealth(record.health, record.timestampMs);
+    // Steps replay with the spacing they were recorded at
+    unsigned long dtMs = record.timestampMs - previousTime;
+    previousTime = record.timestampMs;
+    updateActuators(record.humidity, record.temperature, record.pressure, dtMs / 1000.0f);
+
+    countActuators(result.recorded, record.actuatorFlags & ~TRACE_FLAG_PID_MODE, recordedFlags, dtMs);
+    countActuators(result.replayed, getActuatorFlags(), replayedFlags, dtMs);
+    recordedFlags = record.actuatorFlags & ~TRACE_FLAG_PID_MODE;
+    replayedFlags = getActuatorFlags();
+
+    if (replayedFlags != recordedFlags || (uint8_t)getControllerState() != record.state) {
+      if (result.firstMismatch < 0) {
+        result.firstMismatch = (long)(offset / TRACE_RECORD_SIZE);
+      }
+      result.mismatches++;
+    }
+    result.records++;
+
+    if (!isnan(record.humidity)) {
+      float error = record.humidity - activePhaseConfig.targetHumidity;
+      scored++;
+      absErrorSum += fabs(error);
+      if (fabs(error) <= activePhaseConfig.humidityTolerance) inTolerance++;
+    }
+  }
+
+  if (scored > 0) {
+    result.timeInTolerance = (float)inTolerance / scored;
+    result.meanAbsError = absErrorSum / scored;
+  }
+
+  Serial.setOutputEnabled(wasSerialEnabled);
+  return result;
+}
+
+static void printActuatorKpis(const char* label, const TraceActuatorKpis& kpis) {
+  Serial.printf("%s: humidifier %lu cycles / %.1f h, fans %lu cycles / %.1f h\n", label,
+                kpis.humidifierCycles, kpis.humidifierOnMs / 3600000.0f,
+                kpis.fanCycles, kpis.fanOnMs / 3600000.0f);
+}
+
+void printTraceReplayResult(const TraceReplayResult& result) {
+  Serial.println("\n========== Trace Replay ==========");
+  Serial.printf("Decisions: %u (%u boots)\n", (unsigned)result.records, (unsigned)result.boots);
+  if (result.mismatches == 0) {
+    Serial.println("✅ All decisions match the recording");
+  } else {
+    Serial.printf("⚠️  %u decisions differ, first at record %ld\n",
+                  (unsigned)result.mismatches, result.firstMismatch);
+  }
+  Serial.printf("Recorded humidity in tolerance: %.1f%% (mean error %.2f%%)\n",
+                result.timeInTolerance * 100.0f, result.meanAbsError);
+  printActuatorKpis("Recorded", result.recorded);
+  printActuatorKpis("Replayed", result.replayed);
+  Serial.println("==================================");
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef TRACE_REPLAY_H
+#define TRACE_REPLAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../mushroom_types.h"
+
+// Feeds a recorded control trace (control_trace.h) through the current
+// updateActuators() on the virtual clock and diffs every decision against
+// the recording. The inputs are replayed open-loop: the recorded humidity
+// does not react to the new decisions, so the humidity KPIs describe the
+// recording and the actuator KPIs show how the new build would have driven
+// the hardware. Only built for [env:native].
+
+struct TraceActuatorKpis {
+  unsigned long humidifierCycles;   // Off→on switches
+  unsigned long fanCycles;
+  unsigned long humidifierOnMs;
+  unsigned long fanOnMs;
+};
+
+struct TraceReplayResult {
+  size_t records;              // Decisions replayed, boot markers excluded
+  size_t boots;
+  size_t mismatches;           // Decisions whose state or actuators differ
+  long firstMismatch;          // Record index, -1 if none
+  float timeInTolerance;       // Recorded humidity within target ± humidityTolerance
+  float meanAbsError;
+  TraceActuatorKpis recorded;
+  TraceActuatorKpis replayed;
+};
+
+// --- Loading Functions ---
+// Both return the number of bytes written to out (whole records only)
+size_t traceParseLog(const char* text, uint8_t* out, size_t maxBytes);   // Serial capture with TRACE: lines
+size_t traceLoadFile(const char* path, uint8_t* out, size_t maxBytes);   // Raw flash log or serial capture
+
+// --- Replay ---
+TraceReplayResult traceReplay(const uint8_t* data, size_t length, MushroomType type);
+void printTraceReplayResult(const TraceReplayResult& result);
+
+#endif
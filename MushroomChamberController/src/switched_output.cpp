@@ -0,0 +1,69 @@
+#include "switched_output.h"
+#include "hal/hal.h"
+#include <Arduino.h>
+
+static void writeOutput(SwitchedOutput& output, bool on, unsigned long now) {
+  halOutputWrite(output.pin, on);
+  wearRecordSwitch(output.actuator, on, now);
+  output.outputOn = on;
+  output.lastSwitch = now;
+  Serial.printf("%s: %s\n", output.label, on ? "ON" : "OFF");
+}
+
+void switchedOutputSetup(SwitchedOutput& output, const char* label, uint8_t pin, ActuatorId actuator,
+                         const SwitchLimits& limits, unsigned long dutyWindowMs) {
+  unsigned long now = millis();
+  halOutputSetup(pin);
+  wearRecordSwitch(actuator, false, now);
+
+  output.label = label;
+  output.pin = pin;
+  output.actuator = actuator;
+  output.limits = limits;
+  output.outputOn = false;
+  output.requestedOn = false;
+  output.lastSwitch = now - limits.minOffMs;   // Free to start right away
+  output.startTokens = limits.startBurst;
+  output.lastTokenUpdate = now;
+  output.stats = SwitchStats();
+  timeProportionReset(output.dutyWindow, dutyWindowMs, max(limits.minOnMs, limits.minOffMs), now);
+}
+
+// Token bucket: one start per token, refilled at maxStartsPerHour
+static void refillStartTokens(SwitchedOutput& output, unsigned long now) {
+  output.startTokens = min((float)output.limits.startBurst,
+                           output.startTokens + output.limits.maxStartsPerHour *
+                           (now - output.lastTokenUpdate) / 3600000.0f);
+  output.lastTokenUpdate = now;
+}
+
+void switchedOutputUpdate(SwitchedOutput& output, unsigned long now) {
+  refillStartTokens(output, now);
+  if (output.requestedOn == output.outputOn) {
+    return;
+  }
+
+  unsigned long minimum = output.outputOn ? output.limits.minOnMs : output.limits.minOffMs;
+  if (now - output.lastSwitch < minimum) {
+    output.stats.heldSwitches++;
+    return;
+  }
+  if (output.requestedOn) {
+    if (output.startTokens < 1.0f) {
+      output.stats.rateLimitedStarts++;
+      return;
+    }
+    output.startTokens -= 1.0f;
+  }
+  writeOutput(output, output.requestedOn, now);
+}
+
+void switchedOutputRequest(SwitchedOutput& output, bool on, unsigned long now) {
+  output.requestedOn = on;
+  switchedOutputUpdate(output, now);
+}
+
+void switchedOutputRequestDuty(SwitchedOutput& output, float duty, unsigned long windowMs, unsigned long now) {
+  output.dutyWindow.windowMs = windowMs;
+  switchedOutputRequest(output, timeProportion(output.dutyWindow, duty, now), now);
+}
@@ -0,0 +1,49 @@
+#ifndef SWITCHED_OUTPUT_H
+#define SWITCHED_OUTPUT_H
+
+#include <stdint.h>
+#include "actuator_wear.h"
+#include "humidity_pid.h"
+
+// On/off output stage shared by the humidifier, heater and cooler drivers.
+// Requests are applied only within minimum on/off times and a start rate
+// budget, so a controller flickering around a threshold cannot chatter the
+// load. A request that is held back is retried on every update until the
+// limits allow it. Every edge is reported to the wear counters.
+
+struct SwitchLimits {
+  unsigned long minOnMs;
+  unsigned long minOffMs;
+  uint16_t maxStartsPerHour;
+  uint16_t startBurst;         // Starts allowed back to back before the rate applies
+};
+
+struct SwitchStats {
+  unsigned long heldSwitches;      // Updates a switch waited out the minimum on/off times
+  unsigned long rateLimitedStarts; // Updates a start waited for the rate budget
+};
+
+struct SwitchedOutput {
+  const char* label;           // For the log
+  uint8_t pin;
+  ActuatorId actuator;
+  SwitchLimits limits;
+  TimeProportioner dutyWindow;
+  bool outputOn;
+  bool requestedOn;
+  unsigned long lastSwitch;
+  float startTokens;
+  unsigned long lastTokenUpdate;
+  SwitchStats stats;
+};
+
+// --- Output Functions ---
+void switchedOutputSetup(SwitchedOutput& output, const char* label, uint8_t pin, ActuatorId actuator,
+                         const SwitchLimits& limits, unsigned long dutyWindowMs);
+void switchedOutputRequest(SwitchedOutput& output, bool on, unsigned long now);
+// Time-proportioned: on for duty of every windowMs, pulses shorter than
+// the minimum on/off times skipped
+void switchedOutputRequestDuty(SwitchedOutput& output, float duty, unsigned long windowMs, unsigned long now);
+void switchedOutputUpdate(SwitchedOutput& output, unsigned long now);   // Retries a held request
+
+#endif
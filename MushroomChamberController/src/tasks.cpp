@@ -0,0 +1,498 @@
+#include "tasks.h"
+#include "sensors.h"
+#include "actuators.h"
+#include "led.h"
+#include "config.h"
+#include "wifi_comm.h"
+#include "telemetry_spool.h"
+#include "report_policy.h"
+#include "window_stats.h"
+#include "sample_filter.h"
+#include "sensor_fusion.h"
+#include "control_trace.h"
+#include "control_tick.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+
+// --- Global Configuration ---
+extern GrowthPhase currentPhase;
+extern GrowthPhase oldPhase;
+extern PhaseConfig activePhaseConfig;
+
+// --- Task Layout ---
+// Control runs next to the Arduino core on core 1, networking next to the
+// WiFi stack on core 0, so a slow server can never delay the actuators.
+#define SENSOR_TASK_CORE   1
+#define CONTROL_TASK_CORE  1
+#define COMMS_TASK_CORE    0
+
+#define SENSOR_TASK_PRIORITY   2
+#define CONTROL_TASK_PRIORITY  3
+#define COMMS_TASK_PRIORITY    1
+
+#define SENSOR_TASK_STACK   4096
+#define CONTROL_TASK_STACK  4096
+#define COMMS_TASK_STACK    8192
+
+// The control timer normally releases every step; without it the control
+// task still runs, this many periods apart, so control never stops
+#define CONTROL_TIMEOUT_PERIODS 2
+
+#define TELEMETRY_QUEUE_LENGTH 8
+#define TRACE_QUEUE_LENGTH     2     // Chunks of TRACE_CHUNK_RECORDS, ~1 min at 1 Hz
+#define COMMS_POLL_INTERVAL_MS 20
+#define MIN_REPORT_INTERVAL_MS 1000
+
+// Phase/config changes normally arrive over the long-poll watch; while it
+// is down the phase is polled at this slow rate instead
+#define PHASE_FALLBACK_POLL_MS  60000
+#define WATCH_RETRY_MIN_MS      2000
+#define WATCH_RETRY_MAX_MS      60000
+
+// Phase and config version as last reported by the server
+struct PhaseUpdate {
+  GrowthPhase phase;
+  unsigned long configVersion;
+  unsigned long autotuneRequests;   // Counts up once per requested autotune
+  ControlMode controlMode;
+  VentilationStyle ventilationStyle;
+  VentilationMode ventilationMode;   // Overrides the phase table's
+};
+
+// A published reading with the actuator state it was taken under
+struct TelemetrySample {
+  SensorReading reading;
+  uint8_t actuatorFlags;
+  float fanSpeed;
+};
+
+// One full trace chunk on its way to flash
+struct TraceChunk {
+  size_t length;
+  uint8_t data[TRACE_CHUNK_RECORDS * TRACE_RECORD_SIZE];
+};
+
+// --- Task State ---
+// 10 Hz sampling, decimated to one reading per control cycle
+static const TaskConfig DEFAULT_TASK_CONFIG = { 100, 1000, 1000, 20000 };
+static TaskConfig periods = DEFAULT_TASK_CONFIG;
+
+static QueueHandle_t controlReadingQueue = NULL;  // sensor -> control, latest reading only
+static QueueHandle_t telemetryQueue = NULL;       // sensor -> comms, bounded backlog of TelemetrySample
+static QueueHandle_t phaseQueue = NULL;           // comms -> control, latest PhaseUpdate only
+static QueueHandle_t traceQueue = NULL;           // control -> comms, full trace chunks
+
+static TaskHandle_t sensorTaskHandle = NULL;
+static TaskHandle_t controlTaskHandle = NULL;
+static TaskHandle_t commsTaskHandle = NULL;
+
+static esp_timer_handle_t controlTimer = NULL;
+static bool controlTimerRunning = false;
+
+static volatile unsigned long droppedTelemetry = 0;
+static volatile unsigned long droppedTraceChunks = 0;
+
+static TickType_t periodTicks(unsigned long periodMs) {
+  TickType_t ticks = pdMS_TO_TICKS(periodMs);
+  return ticks > 0 ? ticks : 1;
+}
+
+// --- Sensor Task ---
+// Samples at the high rate, decimates the BME280 and fuses it with the DHT22
+// into one reading per sensor period
+static void sensorTask(void* parameter) {
+  TickType_t lastWake = xTaskGetTickCount();
+  unsigned long lastPublish = millis();
+
+  for (;;) {
+    sampleFilterAdd(readEnvironment());
+
+    SensorReading backup;
+    if (readBackupSensor(backup)) {
+      fusionUpdate(FUSION_SOURCE_DHT22, backup.temperature, backup.humidity, backup.timestamp);
+    }
+
+    unsigned long now = millis();
+    if (now - lastPublish >= periods.sensorPeriodMs) {
+      lastPublish = now;
+
+      SensorReading reading = { NAN, NAN, NAN, now };
+      if (sampleFilterTake(reading)) {
+        fusionUpdate(FUSION_SOURCE_BME280, reading.temperature, reading.humidity, reading.timestamp);
+      }
+      FusedEstimate fused = fusionEstimate(now);
+      reading.temperature = fused.temperature;
+      reading.humidity = fused.humidity;
+      reading.timestamp = now;
+
+      // Formatted on the stack; Serial.printf() mallocs for lines over 64 bytes
+      char line[128];
+      snprintf(line, sizeof(line), "Phase: %s | Temp: %.2f °C, Humidity: %.2f %%, Pressure: %.2f hPa",
+               growthPhaseName(currentPhase),
+               reading.temperature, reading.humidity, reading.pressure);
+      Serial.println(line);
+
+      // Control always sees the freshest value
+      xQueueOverwrite(controlReadingQueue, &reading);
+
+      // Comms keeps a short backlog; drop the oldest reading when it falls behind
+      TelemetrySample sample = { reading, getActuatorFlags(), getCurrentFanSpeed() };
+      if (xQueueSend(telemetryQueue, &sample, 0) != pdPASS) {
+        TelemetrySample discarded;
+        xQueueReceive(telemetryQueue, &discarded, 0);
+        xQueueSend(telemetryQueue, &sample, 0);
+        droppedTelemetry++;
+      }
+    }
+
+    vTaskDelayUntil(&lastWake, periodTicks(periods.samplePeriodMs));
+  }
+}
+
+// --- Control Timer ---
+// A periodic esp_timer keeps the steps on a fixed grid with microsecond
+// resolution, independent of the FreeRTOS tick and of how long each step
+// took. The callback runs in the esp_timer task and only wakes the control
+// task.
+static void controlTimerCallback(void* parameter) {
+  xTaskNotifyGive(controlTaskHandle);
+}
+
+static bool startControlTimer() {
+  if (controlTimer == NULL) {
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = controlTimerCallback;
+    timerArgs.name = "control";
+    if (esp_timer_create(&timerArgs, &controlTimer) != ESP_OK) {
+      controlTimer = NULL;
+      return false;
+    }
+  } else {
+    esp_timer_stop(controlTimer);
+  }
+
+  uint64_t periodUs = (uint64_t)periods.controlPeriodMs * 1000;
+  controlTickStart(periodUs, esp_timer_get_time());
+  controlTimerRunning = esp_timer_start_periodic(controlTimer, periodUs) == ESP_OK;
+  return controlTimerRunning;
+}
+
+// --- Control Task ---
+static void controlTask(void* parameter) {
+  // NaN until the first reading arrives; the controller falls back to its
+  // open-loop duty if none does within SENSOR_STALE_MS
+  SensorReading reading = { NAN, NAN, NAN, millis() };
+  unsigned long appliedConfigVersion = 0;
+  unsigned long appliedAutotuneRequests = 0;
+
+  for (;;) {
+    // Ticks that piled up while a step overran collapse into one; the
+    // tick bookkeeping counts them as missed and widens dt to match
+    ulTaskNotifyTake(pdTRUE, periodTicks(periods.controlPeriodMs * CONTROL_TIMEOUT_PERIODS));
+    ControlTick tick = controlTickBegin(esp_timer_get_time());
+
+    // Apply phase or config changes reported by the comms task
+    PhaseUpdate update;
+    if (xQueueReceive(phaseQueue, &update, 0) == pdPASS) {
+      if (update.phase != currentPhase || update.configVersion != appliedConfigVersion) {
+        if (update.phase != currentPhase) {
+          Serial.printf("🔄 Phase changed: %s → %s\n",
+                        growthPhaseName(currentPhase),
+                        growthPhaseName(update.phase));
+          oldPhase = currentPhase;
+          currentPhase = update.phase;
+        }
+        appliedConfigVersion = update.configVersion;
+        activePhaseConfig = getActivePhaseConfig();
+        activePhaseConfig.ventilationMode = update.ventilationMode;
+        setReportThresholds(activePhaseConfig);
+        setControlMode(update.controlMode);
+        setVentilationStyle(update.ventilationStyle);
+      }
+      // After the phase, so the experiment tunes the phase it was asked for
+      if (update.autotuneRequests != appliedAutotuneRequests) {
+        appliedAutotuneRequests = update.autotuneRequests;
+        Serial.printf("🎯 Autotune requested for %s\n", growthPhaseName(currentPhase));
+        startAutotune();
+      }
+    }
+
+    // A reading the sensor task stopped replacing is not reused forever
+    if (xQueueReceive(controlReadingQueue, &reading, 0) != pdPASS &&
+        millis() - reading.timestamp >= SENSOR_STALE_MS) {
+      reading.temperature = NAN;
+      reading.humidity = NAN;
+      reading.pressure = NAN;
+    }
+
+    updateActuators(reading.humidity, reading.temperature, reading.pressure, tick.dtSec);
+    traceRecord(reading.humidity, reading.temperature, reading.pressure);
+    controlLighting(activePhaseConfig);
+  }
+}
+
+// --- Trace Writer ---
+// Runs inside the control step, so it only copies the chunk; the comms
+// task does the LittleFS append. A chunk that finds the queue full is lost.
+static TraceChunk pendingTrace;
+
+void traceQueueWriter(const uint8_t* data, size_t length) {
+  pendingTrace.length = min(length, sizeof(pendingTrace.data));
+  memcpy(pendingTrace.data, data, pendingTrace.length);
+  if (traceQueue == NULL || xQueueSend(traceQueue, &pendingTrace, 0) != pdPASS) {
+    droppedTraceChunks++;
+  }
+}
+
+// --- Comms Task ---
+// Every reading feeds the window statistics, and each closed window is
+// uploaded as one summary. Raw readings are spooled only while the server
+// asks for them, or when the report policy flags a change worth seeing
+// right away. Uploads go out once per comms period, back to back while a
+// backlog drains, or immediately for urgent changes. Requests advance in
+// small non-blocking steps, so a slow server never holds this task either.
+// Phase and config changes are pushed over a long-poll watch that is kept
+// open next to the uploads. Flash and NVS writes queued by the control
+// task are done here as well, where a slow erase holds nothing up.
+static SpoolRecord uploadBatch[SPOOL_BATCH_SIZE];
+static WindowSummary uploadSummaries[SUMMARY_BATCH_SIZE];
+static TraceChunk traceChunk;
+
+// Hand phase/config from a sync or watch reply to the control task. A
+// sync reply that was in flight while a newer config was pushed carries
+// the older version and is ignored, so it cannot roll the config back.
+// The server hands out an autotune request in one reply only; counting
+// it keeps it from being lost when a later update overwrites the queue.
+static void applyServerConfig(const SyncResult& result, PhaseUpdate& config, bool& rawSamples) {
+  if (result.configVersion < config.configVersion) {
+    return;
+  }
+  if (result.rawSamples != rawSamples) {
+    Serial.printf("📡 Raw samples %s by server\n", result.rawSamples ? "requested" : "no longer needed");
+    rawSamples = result.rawSamples;
+  }
+
+  config.phase = result.phase;
+  config.configVersion = result.configVersion;
+  config.controlMode = result.controlMode;
+  config.ventilationStyle = result.ventilationStyle;
+  config.ventilationMode = result.ventilationMode;
+  if (result.autotune) {
+    config.autotuneRequests++;
+  }
+  xQueueOverwrite(phaseQueue, &config);
+
+  if (result.reportIntervalMs >= MIN_REPORT_INTERVAL_MS && result.reportIntervalMs != periods.commsPeriodMs) {
+    Serial.printf("📡 Report interval: %lu → %lu ms\n", periods.commsPeriodMs, result.reportIntervalMs);
+    periods.commsPeriodMs = result.reportIntervalMs;
+  }
+}
+
+static void commsTask(void* parameter) {
+  unsigned long lastCycle = 0;
+  bool firstCycle = true;
+  PhaseUpdate serverConfig = { currentPhase, 0, 0, getControlMode(), getVentilationStyle(),
+                                activePhaseConfig.ventilationMode };
+  bool lastSyncSucceeded = false;
+  bool reportNow = false;
+  bool rawSamples = false;
+  unsigned long lastSyncStart = 0;
+  unsigned long lastPhasePoll = millis() - PHASE_FALLBACK_POLL_MS;
+  unsigned long nextWatchAttempt = 0;
+  unsigned long watchRetryMs = WATCH_RETRY_MIN_MS;
+  bool watchWasActive = false;
+
+  for (;;) {
+    wifiRetryLoop();
+
+    // Keep every summary and reportable reading, online or not
+    TelemetrySample sample;
+    while (xQueueReceive(telemetryQueue, &sample, 0) == pdPASS) {
+      const SensorReading& reading = sample.reading;
+      windowStatsAdd(reading, sample.actuatorFlags);
+
+      ReportReason reason = evaluateReport(reading, getControllerState());
+      bool urgent = isUrgentReport(reason);
+      if (reason != ReportReason::NONE && (rawSamples || urgent)) {
+        spoolPush(reading, sample.actuatorFlags, sample.fanSpeed);
+        reportNow = reportNow || urgent;
+      }
+    }
+    // Closed windows go to the spool at once, where an outage spills them to flash
+    WindowSummary closed;
+    while (summaryPeek(&closed, 1) == 1) {
+      spoolPushSummary(closed);
+      summaryConsume(1);
+    }
+
+    while (xQueueReceive(traceQueue, &traceChunk, 0) == pdPASS) {
+      traceFlashWriter(traceChunk.data, traceChunk.length);
+    }
+    writeStagedCheckpoints();
+
+    unsigned long now = millis();
+    bool cycleDue = firstCycle || now - lastCycle >= periods.commsPeriodMs;
+    if (cycleDue) {
+      firstCycle = false;
+      lastCycle = now;
+
+      if (!wifiConnected()) {
+        Serial.printf("WiFi Status: %s (%u readings spooled)\n",
+                      getWiFiStatusString().c_str(), (unsigned)spoolSize());
+      } else if (!isTimeSynced()) {
+        setupTime();   // Only checks; SNTP retries on its own
+      }
+    }
+
+    // Drain full batches immediately after a good sync; after a failure
+    // wait for the next cycle instead of retrying every poll
+    bool drainBacklog = lastSyncSucceeded &&
+                        (spoolSize() >= SPOOL_BATCH_SIZE || spoolSummaryCount() >= SUMMARY_BATCH_SIZE);
+
+    // Changes go out immediately, but never more often than the server allows
+    bool reportDue = reportNow && now - lastSyncStart >= MIN_REPORT_INTERVAL_MS;
+
+    if (wifiConnected() && !isSyncInFlight() && (cycleDue || drainBacklog || reportDue)) {
+      // One sync carries readings and summaries up and the phase back;
+      // with nothing to upload and no push channel the phase is polled
+      size_t count = spoolPeek(uploadBatch, SPOOL_BATCH_SIZE);
+      size_t summaries = spoolPeekSummaries(uploadSummaries, SUMMARY_BATCH_SIZE);
+      if (count > 0 || summaries > 0) {
+        lastSyncSucceeded = false;
+        lastSyncStart = now;
+        reportNow = false;
+        if (!syncBatchAsync(uploadBatch, count, uploadSummaries, summaries)) {
+          Serial.printf("❌ Failed to sync: %s\n", getLastError().c_str());
+        }
+      } else if (cycleDue && !isPushChannelUp() && now - lastPhasePoll >= PHASE_FALLBACK_POLL_MS) {
+        requestPhaseAsync();
+        lastPhasePoll = now;
+      }
+    }
+
+    // Keep the watch armed; back off while the server does not answer it
+    if (wifiConnected() && !isPhaseWatchActive() && (long)(now - nextWatchAttempt) >= 0) {
+      watchWasActive = watchPhaseAsync(serverConfig.configVersion);
+    }
+
+    wifiCommPoll();
+
+    if (watchWasActive && !isPhaseWatchActive()) {
+      watchWasActive = false;
+      if (isPushChannelUp()) {
+        watchRetryMs = WATCH_RETRY_MIN_MS;
+        nextWatchAttempt = millis();
+      } else {
+        nextWatchAttempt = millis() + watchRetryMs;
+        watchRetryMs = min(watchRetryMs * 2, (unsigned long)WATCH_RETRY_MAX_MS);
+      }
+    }
+
+    SyncResult sync;
+    if (takeSyncResult(sync)) {
+      if (sync.readingsUploaded > 0) {
+        spoolConsume(sync.readingsUploaded);
+      }
+      if (sync.summariesUploaded > 0) {
+        spoolConsumeSummaries(sync.summariesUploaded);
+      }
+      lastSyncSucceeded = true;
+      applyServerConfig(sync, serverConfig, rawSamples);
+    }
+
+    SyncResult pushed;
+    if (takeWatchResult(pushed)) {
+      Serial.printf("📨 Config pushed (version %lu)\n", pushed.configVersion);
+      applyServerConfig(pushed, serverConfig, rawSamples);
+    }
+
+    GrowthPhase newPhase;
+    if (takePhaseUpdate(newPhase)) {
+      serverConfig.phase = newPhase;
+      xQueueOverwrite(phaseQueue, &serverConfig);
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(COMMS_POLL_INTERVAL_MS));
+  }
+}
+
+void startTasks(const TaskConfig& taskConfig) {
+  periods = taskConfig;
+  setReportThresholds(activePhaseConfig);
+
+  controlReadingQueue = xQueueCreate(1, sizeof(SensorReading));
+  telemetryQueue = xQueueCreate(TELEMETRY_QUEUE_LENGTH, sizeof(TelemetrySample));
+  phaseQueue = xQueueCreate(1, sizeof(PhaseUpdate));
+  traceQueue = xQueueCreate(TRACE_QUEUE_LENGTH, sizeof(TraceChunk));
+
+  if (controlReadingQueue == NULL || telemetryQueue == NULL || phaseQueue == NULL || traceQueue == NULL) {
+    Serial.println("❌ Failed to create task queues");
+    return;
+  }
+
+  xTaskCreatePinnedToCore(controlTask, "control", CONTROL_TASK_STACK, NULL,
+                          CONTROL_TASK_PRIORITY, &controlTaskHandle, CONTROL_TASK_CORE);
+  if (!startControlTimer()) {
+    Serial.printf("❌ Failed to start control timer - stepping every %lu ms instead\n",
+                  periods.controlPeriodMs * CONTROL_TIMEOUT_PERIODS);
+  }
+  xTaskCreatePinnedToCore(sensorTask, "sensor", SENSOR_TASK_STACK, NULL,
+                          SENSOR_TASK_PRIORITY, &sensorTaskHandle, SENSOR_TASK_CORE);
+  xTaskCreatePinnedToCore(commsTask, "comms", COMMS_TASK_STACK, NULL,
+                          COMMS_TASK_PRIORITY, &commsTaskHandle, COMMS_TASK_CORE);
+
+  Serial.println("✅ Tasks started");
+  Serial.printf("  Sample period: %lu ms\n", periods.samplePeriodMs);
+  Serial.printf("  Sensor period: %lu ms\n", periods.sensorPeriodMs);
+  Serial.printf("  Control period: %lu ms (core %d, %s)\n", periods.controlPeriodMs, CONTROL_TASK_CORE,
+                controlTimerRunning ? "esp_timer" : "timeout");
+  Serial.printf("  Comms period: %lu ms (core %d)\n", periods.commsPeriodMs, COMMS_TASK_CORE);
+}
+
+TaskConfig getDefaultTaskConfig() {
+  return DEFAULT_TASK_CONFIG;
+}
+
+void setSamplePeriod(unsigned long periodMs) {
+  periods.samplePeriodMs = periodMs;
+}
+
+void setSensorPeriod(unsigned long periodMs) {
+  periods.sensorPeriodMs = periodMs;
+}
+
+void setControlPeriod(unsigned long periodMs) {
+  periods.controlPeriodMs = periodMs;
+  if (controlTaskHandle != NULL && !startControlTimer()) {
+    Serial.println("❌ Failed to restart control timer");
+  }
+}
+
+void setCommsPeriod(unsigned long periodMs) {
+  periods.commsPeriodMs = periodMs;
+}
+
+void printTaskStatus() {
+  Serial.println("=== Task Status ===");
+  if (sensorTaskHandle != NULL) {
+    Serial.printf("Sensor stack free: %u bytes\n", uxTaskGetStackHighWaterMark(sensorTaskHandle));
+  }
+  if (controlTaskHandle != NULL) {
+    Serial.printf("Control stack free: %u bytes\n", uxTaskGetStackHighWaterMark(controlTaskHandle));
+  }
+  if (commsTaskHandle != NULL) {
+    Serial.printf("Comms stack free: %u bytes\n", uxTaskGetStackHighWaterMark(commsTaskHandle));
+  }
+  if (telemetryQueue != NULL) {
+    Serial.printf("Telemetry backlog: %u readings\n", uxQueueMessagesWaiting(telemetryQueue));
+  }
+  Serial.printf("Dropped readings: %lu, trace chunks: %lu\n", droppedTelemetry, droppedTraceChunks);
+  Serial.println("===================");
+  printControlTickStatus();
+  printSensorStatus();
+  printSampleFilterStatus();
+  printFusionStatus();
+  printSpoolStatus();
+  printReportPolicyStatus();
+  printWindowStatsStatus();
+}
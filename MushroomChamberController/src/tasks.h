@@ -0,0 +1,32 @@
+#ifndef TASKS_H
+#define TASKS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Periods for the FreeRTOS tasks that replace the old loop()
+struct TaskConfig {
+  unsigned long samplePeriodMs;   // How often the BME280 is sampled
+  unsigned long sensorPeriodMs;   // How often a filtered reading is published
+  unsigned long controlPeriodMs;  // Control timer period for updateActuators()/controlLighting()
+  unsigned long commsPeriodMs;    // How often data is uploaded and the phase polled
+};
+
+// --- Setup Function ---
+void startTasks(const TaskConfig& taskConfig);
+
+// --- Trace Writer ---
+// For traceSetup(): queues each chunk for the comms task to append to flash
+void traceQueueWriter(const uint8_t* data, size_t length);
+
+// --- Configuration Functions ---
+TaskConfig getDefaultTaskConfig();
+void setSamplePeriod(unsigned long periodMs);
+void setSensorPeriod(unsigned long periodMs);
+void setControlPeriod(unsigned long periodMs);
+void setCommsPeriod(unsigned long periodMs);
+
+// --- Status Functions ---
+void printTaskStatus();
+
+#endif
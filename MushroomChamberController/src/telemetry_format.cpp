@@ -0,0 +1,317 @@
+#include "telemetry_format.h"
+#include "hal/hal.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+#include <string.h>
+
+// Appends to a fixed buffer and remembers if anything did not fit
+struct JsonWriter {
+  char* buffer;
+  size_t size;
+  size_t length;
+  bool overflowed;
+};
+
+static void append(JsonWriter& writer, const char* format, ...) {
+  if (writer.overflowed) {
+    return;
+  }
+
+  va_list args;
+  va_start(args, format);
+  int written = vsnprintf(writer.buffer + writer.length, writer.size - writer.length, format, args);
+  va_end(args);
+
+  if (written < 0 || (size_t)written >= writer.size - writer.length) {
+    writer.overflowed = true;
+    return;
+  }
+  writer.length += written;
+}
+
+// NaN and infinity are not valid JSON; send null like ArduinoJson does
+static void appendFloat(JsonWriter& writer, const char* key, float value) {
+  if (isnan(value) || isinf(value)) {
+    append(writer, "\"%s\":null", key);
+  } else {
+    append(writer, "\"%s\":%.2f", key, value);
+  }
+}
+
+static size_t finish(const JsonWriter& writer) {
+  if (writer.overflowed) {
+    if (writer.size > 0) {
+      writer.buffer[0] = '\0';
+    }
+    return 0;
+  }
+  return writer.length;
+}
+
+size_t writeSensorJson(char* buffer, size_t size, const TelemetryContext& context,
+                       unsigned long timestamp, float humidity, float temperature, float pressure) {
+  JsonWriter writer = { buffer, size, 0, size == 0 };
+
+  append(writer, "{\"timestamp\":%lu,\"device_id\":\"%s\",", timestamp, context.deviceId);
+  appendFloat(writer, "humidity", humidity);
+  append(writer, ",");
+  appendFloat(writer, "temperature", temperature);
+  append(writer, ",");
+  appendFloat(writer, "pressure", pressure);
+  append(writer, ",\"wifi_rssi\":%d}", context.rssi);
+
+  return finish(writer);
+}
+
+static void appendFieldSummary(JsonWriter& writer, const char* key, const FieldSummary& field) {
+  append(writer, "\"%s\":{", key);
+  appendFloat(writer, "min", field.min);
+  append(writer, ",");
+  appendFloat(writer, "max", field.max);
+  append(writer, ",");
+  appendFloat(writer, "mean", field.mean);
+  append(writer, ",");
+  appendFloat(writer, "stddev", field.stddev);
+  append(writer, "}");
+}
+
+size_t writeBatchJson(char* buffer, size_t size, const TelemetryContext& context,
+                      const SpoolRecord* records, size_t count,
+                      const WindowSummary* summaries, size_t summaryCount) {
+  JsonWriter writer = { buffer, size, 0, size == 0 };
+
+  append(writer, "{\"device_id\":\"%s\",\"wifi_rssi\":%d,\"readings\":[", context.deviceId, context.rssi);
+  for (size_t i = 0; i < count; i++) {
+    append(writer, "%s{\"timestamp\":%lu,\"epoch\":%lu,", i > 0 ? "," : "",
+           (unsigned long)records[i].uptimeMs, (unsigned long)records[i].epoch);
+    appendFloat(writer, "humidity", records[i].humidity);
+    append(writer, ",");
+    appendFloat(writer, "temperature", records[i].temperature);
+    append(writer, ",");
+    appendFloat(writer, "pressure", records[i].pressure);
+    append(writer, "}");
+  }
+  append(writer, "]");
+
+  if (context.wear != NULL) {
+    append(writer, ",\"actuators\":{");
+    for (int i = 0; i < ACTUATOR_COUNT; i++) {
+      append(writer, "%s\"%s\":{\"cycles\":%lu,\"on_seconds\":%lu}", i > 0 ? "," : "",
+             actuatorName((ActuatorId)i), (unsigned long)context.wear[i].cycles,
+             (unsigned long)context.wear[i].onSeconds);
+    }
+    append(writer, "}");
+  }
+
+  if (context.controlTick != NULL) {
+    const ControlTickStats& tick = *context.controlTick;
+    append(writer, ",\"control_tick\":{\"period_ms\":%lu,\"ticks\":%lu,\"missed\":%lu,\"window_ticks\":%lu,"
+           "\"max_lateness_us\":%lu,\"p99_lateness_us\":%lu}",
+           (unsigned long)(tick.periodUs / 1000), (unsigned long)tick.ticks, (unsigned long)tick.missed,
+           (unsigned long)tick.windowTicks, (unsigned long)tick.maxLatenessUs, (unsigned long)tick.p99LatenessUs);
+  }
+
+  if (summaryCount > 0) {
+    append(writer, ",\"summaries\":[");
+    for (size_t i = 0; i < summaryCount; i++) {
+      const WindowSummary& summary = summaries[i];
+      append(writer, "%s{\"epoch\":%lu,\"timestamp\":%lu,\"duration_ms\":%lu,\"samples\":%u,",
+             i > 0 ? "," : "", (unsigned long)summary.epoch, (unsigned long)summary.uptimeMs,
+             (unsigned long)summary.durationMs, (unsigned)summary.samples);
+      appendFieldSummary(writer, "humidity", summary.humidity);
+      append(writer, ",");
+      appendFieldSummary(writer, "temperature", summary.temperature);
+      append(writer, ",");
+      appendFieldSummary(writer, "pressure", summary.pressure);
+      append(writer, ",\"duty\":{\"humidifier\":%.2f,\"fans\":%.2f,\"ventilation\":%.2f}}",
+             summary.humidifierDutyPct / 100.0f, summary.fanDutyPct / 100.0f,
+             summary.ventilationDutyPct / 100.0f);
+    }
+    append(writer, "]");
+  }
+  append(writer, "}");
+
+  return finish(writer);
+}
+
+// --- CBOR ---
+
+struct CborWriter {
+  uint8_t* buffer;
+  size_t size;
+  size_t length;
+  bool overflowed;
+};
+
+static void putBytes(CborWriter& writer, const void* data, size_t length) {
+  if (writer.overflowed || length > writer.size - writer.length) {
+    writer.overflowed = true;
+    return;
+  }
+  memcpy(writer.buffer + writer.length, data, length);
+  writer.length += length;
+}
+
+// Major type plus argument in the shortest form the spec allows
+static void putHead(CborWriter& writer, uint8_t major, uint32_t value) {
+  uint8_t head[5];
+  size_t length;
+  major <<= 5;
+
+  if (value < 24) {
+    head[0] = major | value;
+    length = 1;
+  } else if (value <= 0xFF) {
+    head[0] = major | 24;
+    head[1] = value;
+    length = 2;
+  } else if (value <= 0xFFFF) {
+    head[0] = major | 25;
+    head[1] = value >> 8;
+    head[2] = value;
+    length = 3;
+  } else {
+    head[0] = major | 26;
+    head[1] = value >> 24;
+    head[2] = value >> 16;
+    head[3] = value >> 8;
+    head[4] = value;
+    length = 5;
+  }
+  putBytes(writer, head, length);
+}
+
+static void putInt(CborWriter& writer, int32_t value) {
+  if (value >= 0) {
+    putHead(writer, 0, value);
+  } else {
+    putHead(writer, 1, (uint32_t)(-1 - value));
+  }
+}
+
+static void putText(CborWriter& writer, const char* text) {
+  size_t length = strlen(text);
+  putHead(writer, 3, length);
+  putBytes(writer, text, length);
+}
+
+static void putFloat(CborWriter& writer, float value) {
+  if (isnan(value)) {
+    uint8_t null = 0xF6;
+    putBytes(writer, &null, 1);
+    return;
+  }
+
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  uint8_t encoded[5] = { 0xFA, (uint8_t)(bits >> 24), (uint8_t)(bits >> 16),
+                         (uint8_t)(bits >> 8), (uint8_t)bits };
+  putBytes(writer, encoded, sizeof(encoded));
+}
+
+static void putFieldSummary(CborWriter& writer, const FieldSummary& field) {
+  putFloat(writer, field.min);
+  putFloat(writer, field.max);
+  putFloat(writer, field.mean);
+  putFloat(writer, field.stddev);
+}
+
+size_t writeBatchCbor(uint8_t* buffer, size_t size, const TelemetryContext& context,
+                      const SpoolRecord* records, size_t count,
+                      const WindowSummary* summaries, size_t summaryCount) {
+  CborWriter writer = { buffer, size, 0, false };
+
+  putHead(writer, 5, 4 + (summaryCount > 0 ? 1 : 0) + (context.wear != NULL ? 1 : 0) +
+                     (context.controlTick != NULL ? 1 : 0));
+  putText(writer, "v");
+  putHead(writer, 0, TELEMETRY_CBOR_VERSION);
+  putText(writer, "id");
+  putText(writer, context.deviceId);
+  putText(writer, "rssi");
+  putInt(writer, context.rssi);
+  putText(writer, "r");
+  putHead(writer, 4, count);
+
+  for (size_t i = 0; i < count; i++) {
+    putHead(writer, 4, 7);
+    putHead(writer, 0, records[i].epoch);
+    putHead(writer, 0, records[i].uptimeMs);
+    putFloat(writer, records[i].humidity);
+    putFloat(writer, records[i].temperature);
+    putFloat(writer, records[i].pressure);
+    putHead(writer, 0, records[i].actuatorFlags);
+    putHead(writer, 0, records[i].fanSpeedPct);
+  }
+
+  if (context.wear != NULL) {
+    putText(writer, "w");
+    putHead(writer, 4, ACTUATOR_COUNT);
+    for (int i = 0; i < ACTUATOR_COUNT; i++) {
+      putHead(writer, 4, 2);
+      putHead(writer, 0, context.wear[i].cycles);
+      putHead(writer, 0, context.wear[i].onSeconds);
+    }
+  }
+
+  if (context.controlTick != NULL) {
+    const ControlTickStats& tick = *context.controlTick;
+    putText(writer, "t");
+    putHead(writer, 4, 6);
+    putHead(writer, 0, tick.periodUs / 1000);
+    putHead(writer, 0, tick.ticks);
+    putHead(writer, 0, tick.missed);
+    putHead(writer, 0, tick.windowTicks);
+    putHead(writer, 0, tick.maxLatenessUs);
+    putHead(writer, 0, tick.p99LatenessUs);
+  }
+
+  if (summaryCount > 0) {
+    putText(writer, "s");
+    putHead(writer, 4, summaryCount);
+    for (size_t i = 0; i < summaryCount; i++) {
+      const WindowSummary& summary = summaries[i];
+      putHead(writer, 4, 19);
+      putHead(writer, 0, summary.epoch);
+      putHead(writer, 0, summary.uptimeMs);
+      putHead(writer, 0, summary.durationMs);
+      putHead(writer, 0, summary.samples);
+      putFieldSummary(writer, summary.humidity);
+      putFieldSummary(writer, summary.temperature);
+      putFieldSummary(writer, summary.pressure);
+      putHead(writer, 0, summary.humidifierDutyPct);
+      putHead(writer, 0, summary.fanDutyPct);
+      putHead(writer, 0, summary.ventilationDutyPct);
+    }
+  }
+
+  return writer.overflowed ? 0 : writer.length;
+}
+
+const char* telemetryContentType(TelemetryEncoding encoding) {
+  return encoding == TelemetryEncoding::CBOR ? "application/cbor" : "application/json";
+}
+
+TelemetryContext deviceTelemetryContext() {
+  // Only the comms task builds uploads, so one snapshot buffer is enough
+  static ActuatorWear wear[ACTUATOR_COUNT];
+  static ControlTickStats controlTick;
+  unsigned long now = millis();
+  for (int i = 0; i < ACTUATOR_COUNT; i++) {
+    wear[i] = getActuatorWear((ActuatorId)i, now);
+  }
+
+  TelemetryContext context;
+  context.deviceId = halDeviceId();
+  context.rssi = halWifiRssi();
+  context.wear = wear;
+  controlTick = getControlTickStats();
+  context.controlTick = &controlTick;
+  return context;
+}
+
+String createSensorJson(float humidity, float temperature, float pressure) {
+  char buffer[256];
+  writeSensorJson(buffer, sizeof(buffer), deviceTelemetryContext(), millis(), humidity, temperature, pressure);
+  return String(buffer);
+}
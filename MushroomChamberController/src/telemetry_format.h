@@ -0,0 +1,57 @@
+#ifndef TELEMETRY_FORMAT_H
+#define TELEMETRY_FORMAT_H
+
+#include <stddef.h>
+#include <Arduino.h>
+#include "telemetry_spool.h"
+#include "window_stats.h"
+#include "actuator_wear.h"
+#include "control_tick.h"
+
+// Wire format for uploads; the server picks the decoder from Content-Type
+enum class TelemetryEncoding {
+  JSON,   // application/json, human readable
+  CBOR    // application/cbor, ~4x smaller batches, includes actuator state
+};
+
+#define TELEMETRY_CBOR_VERSION 1
+
+// Device fields sent with every upload
+struct TelemetryContext {
+  const char* deviceId;
+  int rssi;
+  const ActuatorWear* wear;   // ACTUATOR_COUNT lifetime counters, NULL to leave out
+  const ControlTickStats* controlTick;   // Control step jitter, NULL to leave out
+};
+
+// Device id, signal strength, actuator wear and control jitter of this board
+TelemetryContext deviceTelemetryContext();
+
+// --- Serialization Functions ---
+// Write into a caller-provided buffer without touching the heap.
+// Return the number of bytes written, or 0 if the buffer is too small.
+size_t writeSensorJson(char* buffer, size_t size, const TelemetryContext& context,
+                       unsigned long timestamp, float humidity, float temperature, float pressure);
+size_t writeBatchJson(char* buffer, size_t size, const TelemetryContext& context,
+                      const SpoolRecord* records, size_t count,
+                      const WindowSummary* summaries = NULL, size_t summaryCount = 0);
+
+// CBOR batch: {"v": 1, "id": text, "rssi": int, "r": [[epoch, uptimeMs,
+// humidity, temperature, pressure, actuatorFlags, fanSpeedPct], ...]}.
+// Readings are positional arrays to keep per-reading overhead to a few bytes;
+// floats are float32 and NaN is sent as null. Window summaries, if any, go
+// under "s" as [epoch, uptimeMs, durationMs, samples, humidity min/max/mean/
+// stddev, temperature x4, pressure x4, humidifier/fan/ventilation duty %].
+// Actuator wear, if given, goes under "w" as [cycles, onSeconds] per
+// actuator in ActuatorId order. Control step jitter, if given, goes under
+// "t" as [periodMs, steps, missed, windowSteps, maxLatenessUs, p99LatenessUs].
+size_t writeBatchCbor(uint8_t* buffer, size_t size, const TelemetryContext& context,
+                      const SpoolRecord* records, size_t count,
+                      const WindowSummary* summaries = NULL, size_t summaryCount = 0);
+
+const char* telemetryContentType(TelemetryEncoding encoding);
+
+// String wrapper for tests; the upload path uses writeSensorJson()/writeBatchJson() directly
+String createSensorJson(float humidity, float temperature, float pressure);
+
+#endif
@@ -0,0 +1,280 @@
+#include "telemetry_spool.h"
+#include "config.h"
+#include "hal/hal.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+
+// --- Flash Log ---
+// Records that do not fit in RAM are appended to an append-only log.
+// The log always holds the oldest records, so it is drained first; the
+// read position lives in a separate file and both are deleted once empty.
+// Readings and window summaries each have a log of their own.
+#define SPOOL_LOG_PATH "/spool.log"
+#define SPOOL_POS_PATH "/spool.pos"
+#define SUMMARY_LOG_PATH "/summary.log"
+#define SUMMARY_POS_PATH "/summary.pos"
+
+// One RAM ring in front of one flash log.
+//
+// A batch peeked from RAM stays pinned at the front of the ring until it is
+// consumed or the next peek, so an overflow while it is in flight moves the
+// records behind it instead. Those pinned records are then older than the
+// newest on flash and are peeked before the log to keep the upload in order.
+struct RecordLog {
+  const char* logPath;
+  const char* posPath;
+  size_t recordSize;
+  size_t capacity;          // Records in the ring
+  size_t chunk;             // Records moved to flash per write
+  uint32_t flashMaxBytes;
+  uint8_t* ring;
+
+  size_t head;              // Next write position
+  size_t count;
+  size_t pinned;
+  size_t olderThanFlash;
+  uint32_t logSize;         // Bytes written to the log
+  uint32_t logReadOffset;   // Bytes already uploaded
+  bool peekedFromFlash;
+  unsigned long dropped;    // Lost because RAM and flash were both full
+};
+
+static bool flashAvailable = false;
+
+static uint8_t readingRing[SPOOL_RAM_CAPACITY * sizeof(SpoolRecord)];
+static uint8_t summaryRing[SPOOL_SUMMARY_RAM_CAPACITY * sizeof(WindowSummary)];
+
+// Ring and log state start empty
+static RecordLog readings = { SPOOL_LOG_PATH, SPOOL_POS_PATH, sizeof(SpoolRecord),
+                              SPOOL_RAM_CAPACITY, SPOOL_OVERFLOW_CHUNK, SPOOL_FLASH_MAX_BYTES, readingRing,
+                              0, 0, 0, 0, 0, 0, false, 0 };
+static RecordLog summaries = { SUMMARY_LOG_PATH, SUMMARY_POS_PATH, sizeof(WindowSummary),
+                               SPOOL_SUMMARY_RAM_CAPACITY, SPOOL_SUMMARY_CHUNK, SPOOL_SUMMARY_FLASH_MAX_BYTES,
+                               summaryRing,
+                               0, 0, 0, 0, 0, 0, false, 0 };
+
+static uint8_t* ringSlot(RecordLog& log, size_t offsetFromOldest) {
+  size_t index = (log.head + log.capacity - log.count + offsetFromOldest) % log.capacity;
+  return log.ring + index * log.recordSize;
+}
+
+static size_t flashRecordCount(const RecordLog& log) {
+  return (log.logSize - log.logReadOffset) / log.recordSize;
+}
+
+static void saveReadOffset(const RecordLog& log) {
+  File pos = LittleFS.open(log.posPath, FILE_WRITE);
+  if (pos) {
+    pos.write((const uint8_t*)&log.logReadOffset, sizeof(log.logReadOffset));
+    pos.close();
+  }
+}
+
+// Resume whatever a previous boot left behind
+static void resumeLog(RecordLog& log) {
+  log.logSize = 0;
+  log.logReadOffset = 0;
+  if (LittleFS.exists(log.logPath)) {
+    File file = LittleFS.open(log.logPath, FILE_READ);
+    log.logSize = file ? file.size() : 0;
+    file.close();
+
+    // Ignore a torn record at the end of the log
+    log.logSize -= log.logSize % log.recordSize;
+  }
+  if (LittleFS.exists(log.posPath)) {
+    File pos = LittleFS.open(log.posPath, FILE_READ);
+    if (!pos || pos.read((uint8_t*)&log.logReadOffset, sizeof(log.logReadOffset)) != sizeof(log.logReadOffset)) {
+      log.logReadOffset = 0;
+    }
+    pos.close();
+  }
+  if (log.logReadOffset > log.logSize) {
+    log.logReadOffset = log.logSize;
+  }
+}
+
+void setupSpool() {
+  flashAvailable = LittleFS.begin(true);
+  if (!flashAvailable) {
+    Serial.println("⚠️  LittleFS mount failed - spool limited to RAM");
+    return;
+  }
+
+  resumeLog(readings);
+  resumeLog(summaries);
+  Serial.printf("✅ Telemetry spool ready (%u readings, %u summaries waiting on flash)\n",
+                (unsigned)flashRecordCount(readings), (unsigned)flashRecordCount(summaries));
+}
+
+// Drop the chunk of records that starts skip records into the ring,
+// sliding the ones in front of it up behind the rest
+static void removeFromRing(RecordLog& log, size_t skip) {
+  for (size_t i = skip; i-- > 0;) {
+    memcpy(ringSlot(log, i + log.chunk), ringSlot(log, i), log.recordSize);
+  }
+  log.count -= log.chunk;
+}
+
+// Move the oldest RAM records that are not in flight to flash in one
+// write to limit wear
+static void overflowToFlash(RecordLog& log) {
+  size_t chunkBytes = log.chunk * log.recordSize;
+  size_t skip = max(log.pinned, log.olderThanFlash);
+
+  if (flashAvailable && log.logSize + chunkBytes <= log.flashMaxBytes) {
+    File file = LittleFS.open(log.logPath, FILE_APPEND);
+    if (file) {
+      size_t written = 0;
+      for (size_t i = 0; i < log.chunk; i++) {
+        written += file.write(ringSlot(log, skip + i), log.recordSize);
+      }
+      file.close();
+      log.logSize += written - written % log.recordSize;
+
+      if (written == chunkBytes) {
+        removeFromRing(log, skip);
+        log.olderThanFlash = skip;
+        return;
+      }
+    }
+  }
+
+  // No room anywhere; the oldest RAM records not in flight are lost
+  removeFromRing(log, skip);
+  log.dropped += log.chunk;
+}
+
+static void logPush(RecordLog& log, const void* record) {
+  if (log.count == log.capacity) {
+    overflowToFlash(log);
+  }
+
+  memcpy(log.ring + log.head * log.recordSize, record, log.recordSize);
+  log.head = (log.head + 1) % log.capacity;
+  log.count++;
+}
+
+static size_t logPeek(RecordLog& log, void* records, size_t maxRecords) {
+  size_t flashCount = flashRecordCount(log);
+  log.peekedFromFlash = flashCount > 0 && log.olderThanFlash == 0;
+  log.pinned = 0;
+
+  if (log.peekedFromFlash) {
+    size_t count = min(maxRecords, flashCount);
+    File file = LittleFS.open(log.logPath, FILE_READ);
+    if (!file || !file.seek(log.logReadOffset)) {
+      return 0;
+    }
+    size_t read = file.read((uint8_t*)records, count * log.recordSize);
+    file.close();
+    return read / log.recordSize;
+  }
+
+  size_t count = min(maxRecords, log.olderThanFlash > 0 ? log.olderThanFlash : log.count);
+  count = min(count, log.capacity - log.chunk);   // Leave a chunk to overflow
+  for (size_t i = 0; i < count; i++) {
+    memcpy((uint8_t*)records + i * log.recordSize, ringSlot(log, i), log.recordSize);
+  }
+  log.pinned = count;
+  return count;
+}
+
+// Consumes from the same store the last logPeek() read from
+static void logConsume(RecordLog& log, size_t count) {
+  if (log.peekedFromFlash) {
+    log.logReadOffset = min(log.logSize, (uint32_t)(log.logReadOffset + count * log.recordSize));
+
+    if (log.logReadOffset >= log.logSize) {
+      LittleFS.remove(log.logPath);
+      LittleFS.remove(log.posPath);
+      log.logSize = 0;
+      log.logReadOffset = 0;
+    } else {
+      saveReadOffset(log);
+    }
+    log.peekedFromFlash = false;
+    return;
+  }
+
+  count = min(count, log.pinned);
+  log.count -= count;
+  log.olderThanFlash -= min(count, log.olderThanFlash);
+  log.pinned = 0;
+}
+
+// --- Spool Functions ---
+SpoolRecord makeSpoolRecord(const SensorReading& reading, uint8_t actuatorFlags, float fanSpeed) {
+  SpoolRecord record;
+  record.uptimeMs = reading.timestamp;
+  record.humidity = reading.humidity;
+  record.temperature = reading.temperature;
+  record.pressure = reading.pressure;
+  record.actuatorFlags = actuatorFlags;
+  record.fanSpeedPct = (uint8_t)(constrain(fanSpeed, 0.0f, 1.0f) * 100.0f + 0.5f);
+  record.reserved[0] = 0;
+  record.reserved[1] = 0;
+
+  // Back-date wall time to when the reading was actually taken
+  record.epoch = 0;
+  if (isTimeSynced()) {
+    record.epoch = (uint32_t)halWallClock() - (millis() - reading.timestamp) / 1000;
+  }
+  return record;
+}
+
+void spoolPush(const SensorReading& reading, uint8_t actuatorFlags, float fanSpeed) {
+  SpoolRecord record = makeSpoolRecord(reading, actuatorFlags, fanSpeed);
+  logPush(readings, &record);
+}
+
+size_t spoolPeek(SpoolRecord* records, size_t maxRecords) {
+  return logPeek(readings, records, maxRecords);
+}
+
+void spoolConsume(size_t count) {
+  logConsume(readings, count);
+}
+
+size_t spoolSize() {
+  return readings.count + flashRecordCount(readings);
+}
+
+void spoolPushSummary(const WindowSummary& summary) {
+  logPush(summaries, &summary);
+}
+
+size_t spoolPeekSummaries(WindowSummary* out, size_t maxSummaries) {
+  return logPeek(summaries, out, maxSummaries);
+}
+
+void spoolConsumeSummaries(size_t count) {
+  logConsume(summaries, count);
+}
+
+size_t spoolSummaryCount() {
+  return summaries.count + flashRecordCount(summaries);
+}
+
+// --- Status Functions ---
+SpoolStats getSpoolStats() {
+  SpoolStats stats;
+  stats.ramRecords = readings.count;
+  stats.flashRecords = flashRecordCount(readings);
+  stats.droppedRecords = readings.dropped;
+  stats.ramSummaries = summaries.count;
+  stats.flashSummaries = flashRecordCount(summaries);
+  stats.droppedSummaries = summaries.dropped;
+  stats.flashAvailable = flashAvailable;
+  return stats;
+}
+
+void printSpoolStatus() {
+  Serial.println("=== Telemetry Spool ===");
+  Serial.printf("RAM: %u/%u readings, %u/%u summaries\n", (unsigned)readings.count, SPOOL_RAM_CAPACITY,
+                (unsigned)summaries.count, SPOOL_SUMMARY_RAM_CAPACITY);
+  Serial.printf("Flash: %u readings, %u summaries%s\n", (unsigned)flashRecordCount(readings),
+                (unsigned)flashRecordCount(summaries), flashAvailable ? "" : " (unavailable)");
+  Serial.printf("Dropped: %lu readings, %lu summaries\n", readings.dropped, summaries.dropped);
+  Serial.println("=======================");
+}
@@ -0,0 +1,67 @@
+#ifndef TELEMETRY_SPOOL_H
+#define TELEMETRY_SPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sensors.h"
+#include "window_stats.h"
+
+// --- Spool Sizing ---
+#define SPOOL_RAM_CAPACITY    64        // Readings kept in RAM
+#define SPOOL_OVERFLOW_CHUNK  32        // Readings moved to flash per write
+#define SPOOL_FLASH_MAX_BYTES 400000    // ~11 h of 2 s readings on LittleFS
+#define SPOOL_BATCH_SIZE      10        // Readings per upload request
+
+// Window summaries are few but are all there is between reportable
+// readings, so they spill to flash early: a reboot offline loses at most
+// the ones still in RAM
+#define SPOOL_SUMMARY_RAM_CAPACITY    4
+#define SPOOL_SUMMARY_CHUNK           2
+#define SPOOL_SUMMARY_FLASH_MAX_BYTES 200000   // ~2 days of 1 min summaries
+
+// One stored reading; fixed size so the flash log can be indexed directly
+struct SpoolRecord {
+  uint32_t epoch;       // Unix time, 0 if the clock was not synced yet
+  uint32_t uptimeMs;    // millis() when the reading was taken
+  float humidity;
+  float temperature;
+  float pressure;
+  uint8_t actuatorFlags;  // ACTUATOR_FLAG_* when the reading was taken
+  uint8_t fanSpeedPct;    // 0-100
+  uint8_t reserved[2];
+};
+
+struct SpoolStats {
+  size_t ramRecords;
+  size_t flashRecords;
+  unsigned long droppedRecords;   // Lost because RAM and flash were both full
+  size_t ramSummaries;
+  size_t flashSummaries;
+  unsigned long droppedSummaries;
+  bool flashAvailable;
+};
+
+// --- Setup Function ---
+void setupSpool();
+
+// --- Spool Functions ---
+// Actuator state is passed in as it was when the reading was taken; it may
+// have changed by the time the reading is spooled
+SpoolRecord makeSpoolRecord(const SensorReading& reading, uint8_t actuatorFlags, float fanSpeed);  // Adds wall time
+void spoolPush(const SensorReading& reading, uint8_t actuatorFlags, float fanSpeed);
+size_t spoolPeek(SpoolRecord* records, size_t maxRecords);  // Oldest first, not removed
+void spoolConsume(size_t count);                             // Drop after a good upload of the last peek
+size_t spoolSize();
+
+// --- Summary Functions ---
+// Same contract as the readings: oldest first, consume after a good upload
+void spoolPushSummary(const WindowSummary& summary);
+size_t spoolPeekSummaries(WindowSummary* summaries, size_t maxSummaries);
+void spoolConsumeSummaries(size_t count);
+size_t spoolSummaryCount();
+
+// --- Status Functions ---
+SpoolStats getSpoolStats();
+void printSpoolStatus();
+
+#endif
@@ -0,0 +1,153 @@
+#include "temperature_control.h"
+#include <Arduino.h>
+
+// --- Loop State ---
+static TemperatureControlStatus status = {};
+static float ventilationDirection = 0.0f;   // +1 heating, -1 cooling, 0 while idle
+static float runStartTemperature = 0.0f;
+static unsigned long runStart = 0;
+static bool trialOpen = false;              // The run has not been judged yet
+static unsigned long ambientSince = 0;
+static unsigned long stoppedAt = 0;
+static unsigned long restMs = 0;            // Before the fans may start again for temperature
+
+static unsigned long backoffMs() {
+  return THERMAL_AMBIENT_VALID_MS << min(status.uselessInRow, (uint8_t)THERMAL_AMBIENT_MAX_BACKOFF);
+}
+
+static void stopVentilating(unsigned long now) {
+  if (status.ventilating) {
+    stoppedAt = now;
+    restMs = THERMAL_VENT_MIN_OFF_MS;
+    if (trialOpen) {
+      // Cut short before it could be judged, mostly by humidity: back off as
+      // for a useless trial rather than paying for the same attempt again
+      status.uselessInRow = min(status.uselessInRow + 1, 255);
+      restMs = backoffMs();
+      trialOpen = false;
+    }
+  }
+  status.ventilating = false;
+  ventilationDirection = 0.0f;
+}
+
+void temperatureControlReset() {
+  status = TemperatureControlStatus();
+  trialOpen = false;
+  stopVentilating(0);
+  restMs = 0;
+}
+
+// Error fresh air can remove, in tolerances: all of it until the outside
+// temperature is known, then only the part on the chamber's side of it
+static float ventilationScore(float error, float temperature, float tolerance, unsigned long now) {
+  if (status.ambientKnown && now - ambientSince > backoffMs()) {
+    status.ambientKnown = false;
+  }
+  float reachable = fabs(error);
+  if (status.ambientKnown) {
+    reachable = min(reachable, max(0.0f, (status.ambientEstimate - temperature) * (error > 0.0f ? 1.0f : -1.0f)));
+  }
+  return min(reachable / tolerance, THERMAL_VENT_MAX_SCORE);
+}
+
+// Judged once per run: at the end of the trial, or early if it is heading
+// away from the target
+static void judgeTrial(float temperature, float tolerance, unsigned long now) {
+  float progress = (temperature - runStartTemperature) * ventilationDirection;
+  if (progress > -THERMAL_WRONG_WAY && now - runStart < THERMAL_TRIAL_MS) {
+    return;
+  }
+  trialOpen = false;
+  if (progress >= tolerance * THERMAL_MIN_PROGRESS_TOLERANCES) {
+    status.uselessInRow = 0;
+    return;
+  }
+  status.ambientKnown = true;
+  status.ambientEstimate = temperature;
+  status.ambientEstimates++;
+  status.uselessInRow = min(status.uselessInRow + 1, 255);
+  ambientSince = now;
+  Serial.printf("🌡️  Ventilation moved the chamber %.1f°C - taking %.1f°C as the outside air\n",
+                progress, temperature);
+}
+
+ThermalDemand temperatureControlUpdate(const PhaseConfig& phaseConfig, float temperature, float humidity,
+                                       bool canHeat, bool canCool, bool ventilationAllowed,
+                                       unsigned long now, float dtSec) {
+  ThermalDemand demand = {};
+  float tolerance = max(phaseConfig.temperatureTolerance, 0.1f);
+  float error = phaseConfig.targetTemperature - temperature;   // + too cold
+  float deadband = tolerance * TEMPERATURE_DEADBAND_TOLERANCES;
+  float effectiveError = error > deadband ? error - deadband : (error < -deadband ? error + deadband : 0.0f);
+  float direction = effectiveError > 0.0f ? 1.0f : (effectiveError < 0.0f ? -1.0f : 0.0f);
+
+  // A run that brought the chamber into the deadband has proven itself
+  if (status.ventilating && trialOpen) {
+    if (direction != ventilationDirection) {
+      trialOpen = false;
+      status.uselessInRow = 0;
+    } else {
+      judgeTrial(temperature, tolerance, now);
+    }
+  }
+
+  // --- Arbitration against the humidity loop ---
+  float humidityTolerance = max(phaseConfig.humidityTolerance, 0.1f);
+  status.temperatureScore = ventilationScore(error, temperature, tolerance, now);
+  status.humidityScore = max(0.0f, (phaseConfig.targetHumidity - humidity) / humidityTolerance +
+                                   THERMAL_HUMIDITY_COST_TOLERANCES);
+
+  // Hysteresis on both the margin and the time, so the humidity loop
+  // recovering from the extra air does not restart the fans at once. An
+  // open trial runs on unless humidity is about to leave its band for good.
+  bool resting = now - stoppedAt < restMs;
+  bool humidityCritical = status.humidityScore > THERMAL_VENT_MAX_SCORE + THERMAL_HUMIDITY_COST_TOLERANCES;
+  bool wanted = ventilationAllowed && direction != 0.0f &&
+                (status.ventilating ? direction == ventilationDirection &&
+                                      (status.temperatureScore > status.humidityScore ||
+                                       (trialOpen && !humidityCritical))
+                                    : !resting && status.temperatureScore > THERMAL_VENT_START_TOLERANCES &&
+                                      status.temperatureScore > status.humidityScore + THERMAL_ARBITRATION_HYSTERESIS);
+  if (!wanted) {
+    stopVentilating(now);
+  } else if (!status.ventilating) {
+    status.ventilating = true;
+    ventilationDirection = direction;
+    runStartTemperature = temperature;
+    runStart = now;
+    trialOpen = true;
+  }
+  demand.ventilation = status.ventilating ? 1.0f : 0.0f;
+
+  // --- PI demand ---
+  // The integral is bounded by the stages installed, so a chamber without
+  // a heater does not wind up asking for one
+  float kp = 1.0f / (TEMPERATURE_FULL_SCALE_TOLERANCES * tolerance);
+  status.integral = constrain(status.integral + kp / TEMPERATURE_INTEGRAL_TIME_S * effectiveError * dtSec,
+                              canCool ? -1.0f : 0.0f, canHeat ? 1.0f : 0.0f);
+  status.demand = constrain(kp * effectiveError + status.integral, -1.0f, 1.0f);
+
+  demand.heating = canHeat ? max(status.demand, 0.0f) : 0.0f;
+  demand.cooling = canCool ? max(-status.demand, 0.0f) : 0.0f;
+  return demand;
+}
+
+// --- Status Functions ---
+TemperatureControlStatus getTemperatureControlStatus() {
+  return status;
+}
+
+void printTemperatureControlStatus() {
+  Serial.println("\n========== Temperature Control ==========");
+  Serial.printf("Demand: %+.0f%% (I=%+.0f%%)\n", status.demand * 100.0f, status.integral * 100.0f);
+  Serial.printf("Scores: temperature %.2f, humidity cost %.2f\n", status.temperatureScore, status.humidityScore);
+  Serial.printf("Ventilating for temperature: %s\n",
+                status.ventilating ? (ventilationDirection > 0.0f ? "heating" : "cooling") : "no");
+  if (status.ambientKnown) {
+    Serial.printf("Outside air: ~%.1f°C (%lu estimates)\n", status.ambientEstimate, status.ambientEstimates);
+  } else {
+    Serial.printf("Outside air: unknown (%lu estimates)\n", status.ambientEstimates);
+  }
+  Serial.println("=========================================");
+}
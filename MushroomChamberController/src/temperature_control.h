@@ -0,0 +1,69 @@
+#ifndef TEMPERATURE_CONTROL_H
+#define TEMPERATURE_CONTROL_H
+
+#include <stdint.h>
+#include "mushroom_types.h"
+
+// Temperature loop of the AdaptiveController, tracking each phase's
+// targetTemperature ± temperatureTolerance. A PI on the error gives one
+// signed demand, split into a heater and a cooler duty for whichever of the
+// two is installed (thermal_outputs.h).
+//
+// Fresh air pulls the chamber toward the outside temperature, which is not
+// measured. The first minutes of every run are a trial: if the chamber
+// barely moved toward the target, the temperature it reached is taken as
+// the outside air and the fans are not started for temperature again until
+// the chamber has drifted clear of it or the estimate has gone stale.
+//
+// Extra air also dries the chamber, so it is arbitrated against the
+// humidity loop. Both are scored in tolerances of their phase band: the
+// part of the temperature error fresh air can actually remove, against the
+// humidity deficit plus what the added air is expected to cost. The fans
+// run for temperature only while the first is larger.
+
+// --- Tuning ---
+#define TEMPERATURE_DEADBAND_TOLERANCES   0.25f     // No proportional demand this close to target
+#define TEMPERATURE_FULL_SCALE_TOLERANCES 2.0f      // Error asking for 100 %
+#define TEMPERATURE_INTEGRAL_TIME_S       1800.0f
+#define THERMAL_VENT_START_TOLERANCES     1.0f      // Out of band before the fans start for temperature
+#define THERMAL_VENT_MAX_SCORE            2.0f      // Humidity is never pushed further below its band than this
+#define THERMAL_HUMIDITY_COST_TOLERANCES  0.5f      // Humidity deficit charged for the added air
+#define THERMAL_ARBITRATION_HYSTERESIS    0.5f      // Extra margin the temperature needs to start the fans
+#define THERMAL_VENT_MIN_OFF_MS           300000UL  // Rest after the fans stopped, so the loops cannot chatter
+#define THERMAL_TRIAL_MS                  300000UL  // Run length before the arbitration may stop it
+#define THERMAL_MIN_PROGRESS_TOLERANCES   0.25f     // Progress toward target a trial has to make
+#define THERMAL_WRONG_WAY                 0.3f      // °C away from target that ends a trial outright
+#define THERMAL_AMBIENT_VALID_MS          7200000UL // Outside air moves; try again after 2 h,
+#define THERMAL_AMBIENT_MAX_BACKOFF       3         // doubled per useless estimate in a row, up to 16 h
+
+struct ThermalDemand {
+  float heating;           // Heater duty, 0..1
+  float cooling;           // Cooler duty, 0..1
+  float ventilation;       // Fan speed for temperature, 0 while the arbitration says no
+};
+
+struct TemperatureControlStatus {
+  float demand;            // Signed PI output: + heating, - cooling
+  float integral;
+  float temperatureScore;  // Error fresh air can remove, in temperature tolerances
+  float humidityScore;     // Cost of ventilating, in humidity tolerances
+  bool ventilating;        // The fans currently run for temperature
+  bool ambientKnown;
+  float ambientEstimate;   // °C where the last useless trial left the chamber
+  unsigned long ambientEstimates;
+  uint8_t uselessInRow;    // Trials in a row that barely moved the chamber
+};
+
+// --- Control Functions ---
+void temperatureControlReset();
+// canHeat / canCool: a heater / cooler is installed. ventilationAllowed is
+// false while something else owns the fans (e.g. the autotune relay).
+ThermalDemand temperatureControlUpdate(const PhaseConfig& phaseConfig, float temperature, float humidity,
+                                       bool canHeat, bool canCool, bool ventilationAllowed,
+                                       unsigned long now, float dtSec);
+
+// --- Status Functions ---
+TemperatureControlStatus getTemperatureControlStatus();
+void printTemperatureControlStatus();
+
+#endif
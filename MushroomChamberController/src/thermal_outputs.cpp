@@ -0,0 +1,68 @@
+#include "thermal_outputs.h"
+#include <Arduino.h>
+
+// --- Pin Definitions ---
+#define HEATER_PIN 25
+#define COOLER_PIN 26
+
+// --- Driver State ---
+static SwitchedOutput heater;
+static SwitchedOutput cooler;
+static bool heaterInstalled = false;
+static bool coolerInstalled = false;
+
+void setupThermalOutputs() {
+  SwitchLimits heaterLimits = { HEATER_MIN_ON_MS, HEATER_MIN_OFF_MS, HEATER_MAX_STARTS_PER_HOUR, 1 };
+  SwitchLimits coolerLimits = { COOLER_MIN_ON_MS, COOLER_MIN_OFF_MS, COOLER_MAX_STARTS_PER_HOUR, 1 };
+  switchedOutputSetup(heater, "Heater", HEATER_PIN, ACTUATOR_HEATER, heaterLimits, HEATER_WINDOW_MS);
+  switchedOutputSetup(cooler, "Cooler", COOLER_PIN, ACTUATOR_COOLER, coolerLimits, COOLER_WINDOW_MS);
+}
+
+void setThermalOutputs(bool heaterPresent, bool coolerPresent) {
+  if (heaterPresent != heaterInstalled || coolerPresent != coolerInstalled) {
+    Serial.printf("🌡️  Thermal outputs: heater %s, cooler %s\n",
+                  heaterPresent ? "installed" : "none", coolerPresent ? "installed" : "none");
+  }
+  heaterInstalled = heaterPresent;
+  coolerInstalled = coolerPresent;
+
+  // A stage removed while running is switched off through its limits
+  unsigned long now = millis();
+  if (!heaterInstalled) {
+    switchedOutputRequest(heater, false, now);
+  }
+  if (!coolerInstalled) {
+    switchedOutputRequest(cooler, false, now);
+  }
+}
+
+bool hasHeater() {
+  return heaterInstalled;
+}
+
+bool hasCooler() {
+  return coolerInstalled;
+}
+
+// --- Driver Functions ---
+void requestHeaterDuty(float duty, unsigned long now) {
+  switchedOutputRequestDuty(heater, heaterInstalled ? duty : 0.0f, HEATER_WINDOW_MS, now);
+}
+
+void requestCoolerDuty(float duty, unsigned long now) {
+  switchedOutputRequestDuty(cooler, coolerInstalled ? duty : 0.0f, COOLER_WINDOW_MS, now);
+}
+
+void updateThermalOutputs(unsigned long now) {
+  switchedOutputUpdate(heater, now);
+  switchedOutputUpdate(cooler, now);
+}
+
+// --- Status Functions ---
+bool isHeaterOn() {
+  return heater.outputOn;
+}
+
+bool isCoolerOn() {
+  return cooler.outputOn;
+}
@@ -0,0 +1,37 @@
+#ifndef THERMAL_OUTPUTS_H
+#define THERMAL_OUTPUTS_H
+
+#include "switched_output.h"
+
+// Optional heater and cooler relays for the temperature loop. Both pins are
+// driven low at setup; a stage only switches once it is marked installed,
+// so a board without them behaves exactly as before. Each stage is a
+// SwitchedOutput time-proportioned over a window long enough for its load.
+
+// --- Default Limits ---
+#define HEATER_MIN_ON_MS           30000
+#define HEATER_MIN_OFF_MS          30000
+#define HEATER_MAX_STARTS_PER_HOUR 30
+#define HEATER_WINDOW_MS           300000    // 5 min
+#define COOLER_MIN_ON_MS           120000
+#define COOLER_MIN_OFF_MS          300000    // Lets a compressor equalise before restarting
+#define COOLER_MAX_STARTS_PER_HOUR 6
+#define COOLER_WINDOW_MS           1200000   // 20 min
+
+// --- Setup Functions ---
+void setupThermalOutputs();
+void setThermalOutputs(bool heaterInstalled, bool coolerInstalled);   // Kept across setupThermalOutputs()
+bool hasHeater();
+bool hasCooler();
+
+// --- Driver Functions ---
+// Duties of 0..1; ignored by a stage that is not installed
+void requestHeaterDuty(float duty, unsigned long now);
+void requestCoolerDuty(float duty, unsigned long now);
+void updateThermalOutputs(unsigned long now);   // Retries held requests
+
+// --- Status Functions ---
+bool isHeaterOn();
+bool isCoolerOn();
+
+#endif
@@ -0,0 +1,179 @@
+#include "ventilation_modes.h"
+#include <Arduino.h>
+
+#define PHASE_COUNT 3
+
+// --- Learner State ---
+static VentilationModeStats phaseStats[PHASE_COUNT];
+
+// Exchange modes in the order AUTO first tries them; BALANCED is the
+// reference the ventilation duration is learned for
+static const VentilationMode exchangeModes[VENTILATION_EXCHANGE_MODES] = {
+  VentilationMode::BALANCED, VentilationMode::EXHAUST_ONLY, VentilationMode::INLET_ONLY
+};
+
+static int statsIndex(VentilationMode mode) {
+  switch (mode) {
+    case VentilationMode::EXHAUST_ONLY: return 0;
+    case VentilationMode::INLET_ONLY: return 1;
+    case VentilationMode::BALANCED: return 2;
+    default: return -1;   // Not an exchange mode
+  }
+}
+
+static bool validPhase(GrowthPhase phase) {
+  return (int)phase >= 0 && (int)phase < PHASE_COUNT;
+}
+
+// --- Mode Functions ---
+VentilationMode selectVentilationMode(GrowthPhase phase, VentilationMode configured) {
+  if (configured != VentilationMode::AUTO) {
+    return configured;
+  }
+  if (!validPhase(phase)) {
+    return VentilationMode::BALANCED;
+  }
+  const VentilationModeStats& stats = phaseStats[phase];
+
+  // Explore until every mode has been scored, then now and again
+  VentilationMode leastSampled = exchangeModes[0];
+  for (int i = 0; i < VENTILATION_EXCHANGE_MODES; i++) {
+    int index = statsIndex(exchangeModes[i]);
+    if (stats.samples[index] < VENTILATION_MIN_SAMPLES) {
+      return exchangeModes[i];
+    }
+    if (stats.samples[index] < stats.samples[statsIndex(leastSampled)]) {
+      leastSampled = exchangeModes[i];
+    }
+  }
+  if (stats.ventilations % VENTILATION_EXPLORE_EVERY == VENTILATION_EXPLORE_EVERY - 1) {
+    return leastSampled;
+  }
+
+  VentilationMode best = exchangeModes[0];
+  for (int i = 1; i < VENTILATION_EXCHANGE_MODES; i++) {
+    if (stats.volumePerExchange[statsIndex(exchangeModes[i])] < stats.volumePerExchange[statsIndex(best)]) {
+      best = exchangeModes[i];
+    }
+  }
+  return best;
+}
+
+float ventilationAirflowShare(VentilationMode mode) {
+  switch (mode) {
+    case VentilationMode::EXHAUST_ONLY: return 2.0f / FAN_COUNT;
+    case VentilationMode::INLET_ONLY: return 1.0f / FAN_COUNT;
+    case VentilationMode::CIRCULATION: return FAN_MIN_RUNNING_DUTY;
+    default: return 1.0f;
+  }
+}
+
+void ventilationFanDuties(VentilationMode mode, float speed, float duties[FAN_COUNT]) {
+  bool exhaust = mode != VentilationMode::INLET_ONLY;
+  bool inlet = mode != VentilationMode::EXHAUST_ONLY;
+  if (mode == VentilationMode::CIRCULATION && speed > 0.0f) {
+    speed = FAN_MIN_RUNNING_DUTY;
+  }
+  duties[FAN_EXHAUST_1] = exhaust ? speed : 0.0f;
+  duties[FAN_EXHAUST_2] = exhaust ? speed : 0.0f;
+  duties[FAN_INLET] = inlet ? speed : 0.0f;
+}
+
+unsigned long ventilationDurationFor(VentilationMode mode, unsigned long balancedDurationMs) {
+  if (mode == VentilationMode::CIRCULATION) {
+    return balancedDurationMs;   // Not meant to exchange the air
+  }
+  float stretch = min(1.0f / ventilationAirflowShare(mode), VENTILATION_MAX_STRETCH);
+  return (unsigned long)(balancedDurationMs * stretch);
+}
+
+void recordVentilation(GrowthPhase phase, VentilationMode mode, float humidityDrop, float expectedDrop,
+                       unsigned long durationMs) {
+  int index = statsIndex(mode);
+  if (!validPhase(phase) || index < 0 || durationMs == 0 || expectedDrop <= 0.0f) {
+    return;
+  }
+  VentilationModeStats& stats = phaseStats[phase];
+  float volume = ventilationAirflowShare(mode) * durationMs / 1000.0f;
+  float exchanges = max(humidityDrop, expectedDrop * VENTILATION_MIN_DROP_SHARE) / expectedDrop;
+  float score = volume / exchanges;
+
+  if (stats.samples[index] == 0) {
+    stats.volumePerExchange[index] = score;
+  } else {
+    stats.volumePerExchange[index] = VENTILATION_SCORE_ALPHA * score +
+                                     (1.0f - VENTILATION_SCORE_ALPHA) * stats.volumePerExchange[index];
+  }
+  if (stats.samples[index] < UINT16_MAX) stats.samples[index]++;
+  stats.ventilations++;
+  Serial.printf("📊 %s ventilation: %.1f s of full airflow per air change (avg %.1f, %u samples)\n",
+                ventilationModeToString(mode), score, stats.volumePerExchange[index], stats.samples[index]);
+}
+
+float balancedEquivalentDrop(GrowthPhase phase, VentilationMode mode, float humidityDrop) {
+  int index = statsIndex(mode);
+  int balanced = statsIndex(VentilationMode::BALANCED);
+  if (!validPhase(phase) || index < 0 || index == balanced) {
+    return humidityDrop;
+  }
+  const VentilationModeStats& stats = phaseStats[phase];
+  if (stats.samples[index] == 0 || stats.samples[balanced] == 0) {
+    return humidityDrop;
+  }
+  return humidityDrop * stats.volumePerExchange[index] / stats.volumePerExchange[balanced];
+}
+
+const char* ventilationModeToString(VentilationMode mode) {
+  switch (mode) {
+    case VentilationMode::AUTO: return "AUTO";
+    case VentilationMode::EXHAUST_ONLY: return "EXHAUST_ONLY";
+    case VentilationMode::INLET_ONLY: return "INLET_ONLY";
+    case VentilationMode::BALANCED: return "BALANCED";
+    case VentilationMode::CIRCULATION: return "CIRCULATION";
+    default: return "UNKNOWN";
+  }
+}
+
+VentilationMode stringToVentilationMode(const char* modeStr) {
+  if (strcmp(modeStr, "AUTO") == 0) {
+    return VentilationMode::AUTO;
+  }
+  for (int i = 0; i < VENTILATION_EXCHANGE_MODES; i++) {
+    if (strcmp(modeStr, ventilationModeToString(exchangeModes[i])) == 0) {
+      return exchangeModes[i];
+    }
+  }
+  return VentilationMode::BALANCED;
+}
+
+// --- Per-Phase Results ---
+VentilationModeStats getVentilationModeStats(GrowthPhase phase) {
+  return validPhase(phase) ? phaseStats[phase] : VentilationModeStats();
+}
+
+void setVentilationModeStats(GrowthPhase phase, const VentilationModeStats& stats) {
+  if (validPhase(phase)) {
+    phaseStats[phase] = stats;
+  }
+}
+
+void clearVentilationModeStats() {
+  for (int i = 0; i < PHASE_COUNT; i++) {
+    phaseStats[i] = VentilationModeStats();
+  }
+}
+
+void printVentilationModeStatus() {
+  Serial.println("\n========== Ventilation Modes ==========");
+  for (int i = 0; i < PHASE_COUNT; i++) {
+    const VentilationModeStats& stats = phaseStats[i];
+    Serial.printf("Phase %d: %u ventilations, next AUTO: %s\n", i, stats.ventilations,
+                  ventilationModeToString(selectVentilationMode((GrowthPhase)i, VentilationMode::AUTO)));
+    for (int m = 0; m < VENTILATION_EXCHANGE_MODES; m++) {
+      int index = statsIndex(exchangeModes[m]);
+      Serial.printf("  %-12s %.1f s of full airflow per air change (%u samples)\n",
+                    ventilationModeToString(exchangeModes[m]), stats.volumePerExchange[index], stats.samples[index]);
+    }
+  }
+  Serial.println("=======================================");
+}
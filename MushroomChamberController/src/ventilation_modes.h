@@ -0,0 +1,53 @@
+#ifndef VENTILATION_MODES_H
+#define VENTILATION_MODES_H
+
+#include <stdint.h>
+#include "mushroom_types.h"
+#include "fan_driver.h"
+
+// Fan patterns for the ventilation modes, and the per-phase learner behind
+// VentilationMode::AUTO. There is no CO2 sensor, so the humidity drop over
+// a ventilation (the before/after bookkeeping in changeState()) stands in
+// for the air it really exchanged: outside air is drier than the chamber,
+// whichever fan brings it in. Every ventilation is scored by the rated fan
+// volume it took per air change the phase asks for, i.e. per
+// VENTILATION_EXPECTED_DROP_FRACTION of target humidity; AUTO then runs the
+// exchange mode with the lowest score. A mode whose fans are ducted badly
+// or leak around the seals scores high however little humidity it costs.
+
+// --- Learner Parameters ---
+#define VENTILATION_EXCHANGE_MODES    3       // EXHAUST_ONLY, INLET_ONLY, BALANCED
+#define VENTILATION_MIN_SAMPLES       2       // Per mode before AUTO trusts the scores
+#define VENTILATION_EXPLORE_EVERY     8       // Every 8th ventilation retries the least-sampled mode
+#define VENTILATION_SCORE_ALPHA       0.3f
+#define VENTILATION_MAX_STRETCH       3.0f    // Longest a mode may stretch the BALANCED duration
+#define VENTILATION_MIN_DROP_SHARE    0.1f    // Drops below this share of the expected one score as this
+
+struct VentilationModeStats {
+  float volumePerExchange[VENTILATION_EXCHANGE_MODES];   // Seconds of all fans at full speed per air change
+  uint16_t samples[VENTILATION_EXCHANGE_MODES];
+  uint16_t ventilations;
+};
+
+// --- Mode Functions ---
+// Resolves AUTO to an exchange mode for the next ventilation of the phase
+VentilationMode selectVentilationMode(GrowthPhase phase, VentilationMode configured);
+float ventilationAirflowShare(VentilationMode mode);   // Rated airflow relative to BALANCED at full speed
+void ventilationFanDuties(VentilationMode mode, float speed, float duties[FAN_COUNT]);
+// How long the mode runs to move the air BALANCED moves in balancedDurationMs
+unsigned long ventilationDurationFor(VentilationMode mode, unsigned long balancedDurationMs);
+void recordVentilation(GrowthPhase phase, VentilationMode mode, float humidityDrop, float expectedDrop,
+                       unsigned long durationMs);
+// The drop a BALANCED run of the same rated volume would have given, from
+// the two modes' scores; the drop itself until both have been scored
+float balancedEquivalentDrop(GrowthPhase phase, VentilationMode mode, float humidityDrop);
+const char* ventilationModeToString(VentilationMode mode);
+VentilationMode stringToVentilationMode(const char* modeStr);   // AUTO or an exchange mode, else BALANCED
+
+// --- Per-Phase Results ---
+VentilationModeStats getVentilationModeStats(GrowthPhase phase);
+void setVentilationModeStats(GrowthPhase phase, const VentilationModeStats& stats);
+void clearVentilationModeStats();
+void printVentilationModeStatus();
+
+#endif
@@ -1,12 +1,21 @@
 #include "wifi_comm.h"
 #include <WiFi.h>
-#include <HTTPClient.h>
 #include <ArduinoJson.h>
+#include "http_async.h"
+#include "telemetry_format.h"
+#include "actuators.h"
+#include "ventilation_modes.h"
+#include "hal/hal.h"
+#include <stdarg.h>
 
 // WiFi configuration
 static WiFiConfig config;
 static WiFiStatus currentStatus = WiFiStatus::DISCONNECTED;
-static String lastError = "";
+static char lastError[96] = "";
+
+// Upload bodies are serialized here; httpAsyncStart() copies them out
+static char payloadBuffer[HTTP_ASYNC_REQUEST_SIZE];
+static TelemetryEncoding telemetryEncoding = TelemetryEncoding::JSON;
 
 // Retry logic state
 static unsigned long lastAttemptTime = 0;
@@ -14,6 +23,100 @@ static unsigned int currentRetries = 0;
 static const unsigned long DEFAULT_RETRY_INTERVAL = 10000; // 10 seconds
 static const unsigned int DEFAULT_MAX_RETRIES = 5;
 
+// Asynchronous phase result, handed over by takePhaseUpdate()
+static bool phaseUpdateReady = false;
+static GrowthPhase receivedPhase = INCUBATION;
+
+// Asynchronous sync result, handed over by takeSyncResult()
+static bool syncResultReady = false;
+static SyncResult receivedSync;
+static size_t pendingSyncReadings = 0;
+static size_t pendingSyncSummaries = 0;
+
+// Phase watch (long-poll push channel), handed over by takeWatchResult()
+#define PHASE_WATCH_WAIT_MS  25000   // Server holds the request at most this long
+#define PHASE_WATCH_SLACK_MS 5000    // Extra time before the device gives up on it
+static bool watchResultReady = false;
+static SyncResult receivedWatch;
+static bool pushChannelUp = false;
+
+// --- Response Parsing Arena ---
+// Replies are tiny, so ArduinoJson gets a fixed bump allocator that is
+// rewound before every parse instead of going through malloc.
+#define PARSE_ARENA_SIZE 2048
+
+class ParseArena : public ArduinoJson::Allocator {
+ public:
+  void reset() {
+    used = 0;
+    lastBlock = 0;
+  }
+
+  void* allocate(size_t size) override {
+    size = (size + 7) & ~(size_t)7;
+    if (used + size > sizeof(memory)) {
+      return NULL;
+    }
+    lastBlock = used;
+    used += size;
+    return memory + lastBlock;
+  }
+
+  void deallocate(void* block) override {
+    // Released all at once by reset()
+  }
+
+  void* reallocate(void* block, size_t newSize) override {
+    if (block == NULL) {
+      return allocate(newSize);
+    }
+
+    // The most recent block (usually the string being parsed) resizes in place
+    size_t offset = (uint8_t*)block - memory;
+    if (offset == lastBlock) {
+      newSize = (newSize + 7) & ~(size_t)7;
+      if (offset + newSize > sizeof(memory)) {
+        return NULL;
+      }
+      used = offset + newSize;
+      return block;
+    }
+
+    // Older blocks are copied; their size is unknown, so copy at most up to the end
+    size_t available = used - offset;
+    void* moved = allocate(newSize);
+    if (moved != NULL) {
+      memcpy(moved, block, newSize < available ? newSize : available);
+    }
+    return moved;
+  }
+
+ private:
+  alignas(8) uint8_t memory[PARSE_ARENA_SIZE];
+  size_t used = 0;
+  size_t lastBlock = 0;
+};
+
+static ParseArena parseArena;
+
+static void setLastError(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  vsnprintf(lastError, sizeof(lastError), format, args);
+  va_end(args);
+}
+
+// Serializes readings into payloadBuffer in the selected encoding
+static size_t encodeReadings(const SpoolRecord* records, size_t count,
+                             const WindowSummary* summaries = NULL, size_t summaryCount = 0) {
+  if (telemetryEncoding == TelemetryEncoding::CBOR) {
+    return writeBatchCbor((uint8_t*)payloadBuffer, sizeof(payloadBuffer), deviceTelemetryContext(),
+                          records, count, summaries, summaryCount);
+  }
+  return writeBatchJson(payloadBuffer, sizeof(payloadBuffer), deviceTelemetryContext(),
+                        records, count, summaries, summaryCount);
+}
+
 void wifiSetup(const char* ssid, const char* password, const char* serverUrl) {
   config.ssid = String(ssid);
   config.password = String(password);
@@ -23,7 +126,11 @@ void wifiSetup(const char* ssid, const char* password, const char* serverUrl) {
   
   currentStatus = WiFiStatus::DISCONNECTED;
   currentRetries = 0;
-  lastError = "";
+  lastError[0] = '\0';
+
+  if (!httpAsyncSetup(serverUrl)) {
+    Serial.printf("⚠️ Invalid server URL '%s'\n", serverUrl);
+  }
 
   WiFi.mode(WIFI_STA);
   
@@ -42,7 +149,7 @@ void wifiRetryLoop() {
       Serial.println(WiFi.localIP());
       currentStatus = WiFiStatus::CONNECTED;
       currentRetries = 0;
-      lastError = "";
+      lastError[0] = '\0';
     }
     return;
   }
@@ -65,7 +172,7 @@ void wifiRetryLoop() {
         if (currentRetries >= config.maxRetries) {
           Serial.println("Max retries reached, marking as failed");
           currentStatus = WiFiStatus::CONNECTION_FAILED;
-          lastError = "Max connection retries exceeded";
+          setLastError("Max connection retries exceeded");
           return;
         }
         
@@ -83,7 +190,7 @@ void wifiRetryLoop() {
         currentRetries++;
         if (currentRetries >= config.maxRetries) {
           currentStatus = WiFiStatus::CONNECTION_FAILED;
-          lastError = "Max reconnection retries exceeded";
+          setLastError("Max reconnection retries exceeded");
           return;
         }
         
@@ -123,22 +230,26 @@ String getWiFiStatusString() {
 }
 
 // Add this helper function to convert string to enum
-GrowthPhase stringToGrowthPhase(const String& phaseStr) {
-  if (phaseStr == "Incubation") {
+GrowthPhase stringToGrowthPhase(const char* phaseStr) {
+  if (strcmp(phaseStr, "Incubation") == 0) {
     return INCUBATION;
-  } else if (phaseStr == "Primordia") {
+  } else if (strcmp(phaseStr, "Primordia") == 0) {
     return PRIMORDIA_FORMATION;
-  } else if (phaseStr == "Fruiting") {
+  } else if (strcmp(phaseStr, "Fruiting") == 0) {
     return FRUITING;
   } else {
     // Default fallback
-    Serial.printf("⚠️ Unknown phase '%s', defaulting to INCUBATION\n", phaseStr.c_str());
+    Serial.printf("⚠️ Unknown phase '%s', defaulting to INCUBATION\n", phaseStr);
     return INCUBATION;
   }
 }
 
-// Add this helper function to convert enum to string (useful for debugging)
-String growthPhaseToString(GrowthPhase phase) {
+GrowthPhase stringToGrowthPhase(const String& phaseStr) {
+  return stringToGrowthPhase(phaseStr.c_str());
+}
+
+// Static name, safe to use from the sensor/control tasks without allocating
+const char* growthPhaseName(GrowthPhase phase) {
   switch (phase) {
     case INCUBATION: return "Incubation";
     case PRIMORDIA_FORMATION: return "Primordia";
@@ -147,106 +258,230 @@ String growthPhaseToString(GrowthPhase phase) {
   }
 }
 
-// Updated getCurrentPhase function
-GrowthPhase getCurrentPhase() {
-  HTTPClient http;
-  String phaseUrl = config.serverUrl + "/api/phase";
-  
-  http.begin(phaseUrl.c_str());
-  http.addHeader("User-Agent", "ESP32-Sensor");
-  http.setTimeout(5000);
+// Add this helper function to convert enum to string (useful for debugging)
+String growthPhaseToString(GrowthPhase phase) {
+  return growthPhaseName(phase);
+}
 
-  // Serial.printf("Getting phase from: %s\n", phaseUrl.c_str());
+// --- Asynchronous requests ---
 
-  int httpResponseCode = http.GET();
+static void onPhaseResponse(HttpEndpoint endpoint, bool success, int statusCode,
+                            const char* body, void* context) {
+  // Only a good answer may change the phase; errors keep the current one
+  if (!success) {
+    setLastError("HTTP client error: %s", body);
+    Serial.printf("Error on GET: %s\n", body);
+    return;
+  }
+  if (statusCode < 200 || statusCode >= 300) {
+    setLastError("HTTP error code: %d", statusCode);
+    return;
+  }
 
-  if (httpResponseCode > 0) {
-    // Serial.printf("GET Response code: %d\n", httpResponseCode);
-    
-    if (httpResponseCode >= 200 && httpResponseCode < 300) {
-      String response = http.getString();
-      Serial.printf("Phase response: %s\n", response.c_str());
-      
-      // Parse JSON response to extract phase
-      JsonDocument doc;
-      deserializeJson(doc, response);
-      String phaseStr = doc["phase"];
-      
-      http.end();
-      return stringToGrowthPhase(phaseStr);
-    } else {
-      lastError = "HTTP error code: " + String(httpResponseCode);
-      http.end();
-      return INCUBATION; 
-    }
-  } else {
-    String error = http.errorToString(httpResponseCode);
-    lastError = "HTTP client error: " + error;
-    Serial.printf("Error on GET: %s\n", error.c_str());
-    http.end();
-    return INCUBATION;
+  if (!parsePhaseResponse(body, receivedPhase)) {
+    setLastError("Invalid phase response");
+    return;
   }
+  phaseUpdateReady = true;
 }
 
-bool sendPostRequest(const char* serverUrl, const String& jsonPayload) {
+bool requestPhaseAsync() {
   if (!wifiConnected()) {
-    lastError = "WiFi not connected";
-    Serial.println("WiFi not connected, can't send POST");
+    setLastError("WiFi not connected");
+    return false;
+  }
+  if (isHttpAsyncBusy(ENDPOINT_PHASE)) {
     return false;
   }
+  if (!httpAsyncStart(ENDPOINT_PHASE, "GET", "/api/phase", NULL, NULL, 0, onPhaseResponse, NULL)) {
+    setLastError("Could not start phase request");
+    return false;
+  }
+  return true;
+}
 
-  HTTPClient http;
-  http.begin(serverUrl);
-  http.addHeader("Content-Type", "application/json");
-  http.addHeader("User-Agent", "ESP32-Sensor");
-  http.setTimeout(10000); // 10 second timeout
-
-  // Serial.printf("Sending POST to: %s\n", serverUrl);
-  // Serial.printf("Payload: %s\n", jsonPayload.c_str());
-
-  int httpResponseCode = http.POST(jsonPayload);
-
-  if (httpResponseCode > 0) {
-    Serial.printf("POST Response code: %d\n", httpResponseCode);
-    
-    if (httpResponseCode >= 200 && httpResponseCode < 300) {
-      String response = http.getString();
-      // Serial.printf("Response: %s\n", response.c_str());
-      http.end();
-      return true;
-    } else {
-      lastError = "HTTP error code: " + String(httpResponseCode);
-      http.end();
-      return false;
-    }
-  } else {
-    String error = http.errorToString(httpResponseCode);
-    lastError = "HTTP client error: " + error;
-    Serial.printf("Error on POST: %s\n", error.c_str());
-    http.end();
+static void onSyncResponse(HttpEndpoint endpoint, bool success, int statusCode,
+                           const char* body, void* context) {
+  if (!success) {
+    setLastError("HTTP client error: %s", body);
+    Serial.printf("❌ Sync failed: %s\n", body);
+    return;
+  }
+  if (statusCode < 200 || statusCode >= 300) {
+    setLastError("HTTP error code: %d", statusCode);
+    Serial.printf("❌ Sync failed: %s\n", lastError);
+    return;
+  }
+
+  if (!parseSyncResponse(body, receivedSync)) {
+    setLastError("Invalid sync response");
+    return;
+  }
+  receivedSync.readingsUploaded = pendingSyncReadings;
+  receivedSync.summariesUploaded = pendingSyncSummaries;
+  syncResultReady = true;
+}
+
+bool syncBatchAsync(const SpoolRecord* records, size_t count,
+                    const WindowSummary* summaries, size_t summaryCount) {
+  if (!wifiConnected()) {
+    setLastError("WiFi not connected");
+    return false;
+  }
+  if (isHttpAsyncBusy(ENDPOINT_SYNC)) {
+    setLastError("Previous sync still in flight");
+    return false;
+  }
+
+  size_t length = encodeReadings(records, count, summaries, summaryCount);
+  if (length == 0 ||
+      !httpAsyncStart(ENDPOINT_SYNC, "POST", "/api/sync", telemetryContentType(telemetryEncoding),
+                      payloadBuffer, length, onSyncResponse, NULL)) {
+    setLastError("Could not start sync");
     return false;
   }
+  pendingSyncReadings = count;
+  pendingSyncSummaries = summaryCount;
+  return true;
 }
 
-bool sendSensorData(float humidity, float temperature, float pressure) {
-  String sensorUrl = String(config.serverUrl) + "/api/sensor-data";
-  String json = createSensorJson(humidity, temperature, pressure);
-  return sendPostRequest(sensorUrl.c_str(), json);
+static void onPhaseWatchResponse(HttpEndpoint endpoint, bool success, int statusCode,
+                                 const char* body, void* context) {
+  if (!success) {
+    pushChannelUp = false;
+    setLastError("Phase watch: %s", body);
+    return;
+  }
+  if (statusCode != 200 && statusCode != 304) {
+    // e.g. 404 from a server without /api/phase/watch
+    pushChannelUp = false;
+    setLastError("Phase watch: HTTP error code: %d", statusCode);
+    return;
+  }
+
+  pushChannelUp = true;
+  if (statusCode == 304) {
+    return;   // Nothing changed while the server held the request
+  }
+  if (!parseSyncResponse(body, receivedWatch)) {
+    setLastError("Invalid phase watch response");
+    return;
+  }
+  receivedWatch.readingsUploaded = 0;
+  receivedWatch.summariesUploaded = 0;
+  watchResultReady = true;
 }
 
-String createSensorJson(float humidity, float temperature, float pressure) {
-  JsonDocument doc;
+bool watchPhaseAsync(unsigned long knownConfigVersion) {
+  if (!wifiConnected()) {
+    setLastError("WiFi not connected");
+    return false;
+  }
+  if (isHttpAsyncBusy(ENDPOINT_PHASE_WATCH)) {
+    return false;
+  }
+
+  char path[64];
+  snprintf(path, sizeof(path), "/api/phase/watch?version=%lu&wait_ms=%u",
+           knownConfigVersion, PHASE_WATCH_WAIT_MS);
+  setHttpEndpointTimeout(ENDPOINT_PHASE_WATCH, PHASE_WATCH_WAIT_MS + PHASE_WATCH_SLACK_MS);
+
+  if (!httpAsyncStart(ENDPOINT_PHASE_WATCH, "GET", path, NULL, NULL, 0, onPhaseWatchResponse, NULL)) {
+    pushChannelUp = false;
+    setLastError("Could not start phase watch");
+    return false;
+  }
+  return true;
+}
+
+bool isPhaseWatchActive() {
+  return isHttpAsyncBusy(ENDPOINT_PHASE_WATCH);
+}
+
+bool isPushChannelUp() {
+  return pushChannelUp;
+}
 
-  doc["timestamp"] = millis();
-  doc["device_id"] = WiFi.macAddress();
-  doc["humidity"] = humidity;
-  doc["temperature"] = temperature;
-  doc["pressure"] = pressure;
-  doc["wifi_rssi"] = WiFi.RSSI();
+bool takeWatchResult(SyncResult& result) {
+  if (!watchResultReady) {
+    return false;
+  }
+  watchResultReady = false;
+  result = receivedWatch;
+  return true;
+}
+
+bool isSyncInFlight() {
+  return isHttpAsyncBusy(ENDPOINT_SYNC);
+}
+
+bool takeSyncResult(SyncResult& result) {
+  if (!syncResultReady) {
+    return false;
+  }
+  syncResultReady = false;
+  result = receivedSync;
+  return true;
+}
+
+void wifiCommPoll() {
+  httpAsyncPoll();
+}
+
+bool takePhaseUpdate(GrowthPhase& phase) {
+  if (!phaseUpdateReady) {
+    return false;
+  }
+  phaseUpdateReady = false;
+  phase = receivedPhase;
+  return true;
+}
+
+// --- Response Parsing ---
+
+bool parsePhaseResponse(const char* body, GrowthPhase& phase) {
+  parseArena.reset();
+  JsonDocument doc(&parseArena);
+  DeserializationError error = deserializeJson(doc, body);
+  const char* phaseStr = doc["phase"];
+  if (error || phaseStr == NULL) {
+    return false;
+  }
+
+  phase = stringToGrowthPhase(phaseStr);
+  return true;
+}
+
+bool parseSyncResponse(const char* body, SyncResult& result) {
+  parseArena.reset();
+  JsonDocument doc(&parseArena);
+  DeserializationError error = deserializeJson(doc, body);
+  const char* phaseStr = doc["phase"];
+  if (error || phaseStr == NULL) {
+    return false;
+  }
+
+  result.phase = stringToGrowthPhase(phaseStr);
+  result.configVersion = doc["config_version"] | 0UL;
+  result.reportIntervalMs = doc["report_interval_ms"] | 0UL;
+  result.rawSamples = doc["raw_samples"] | false;
+  result.autotune = doc["autotune"] | false;
+  result.controlMode = stringToControlMode(doc["control_mode"] | "BANG_BANG");
+  result.ventilationStyle = stringToVentilationStyle(doc["ventilation_style"] | "BURST");
+  result.ventilationMode = stringToVentilationMode(doc["ventilation_mode"] | "BALANCED");
+  return true;
+}
+
+void setTelemetryEncoding(TelemetryEncoding encoding) {
+  telemetryEncoding = encoding;
+}
+
+TelemetryEncoding getTelemetryEncoding() {
+  return telemetryEncoding;
+}
 
-  String output;
-  serializeJson(doc, output);
-  return output;
+const char* getDeviceId() {
+  return halDeviceId();
 }
 
 void setRetryInterval(unsigned long intervalMs) {
@@ -259,6 +494,7 @@ void setMaxRetries(unsigned int retries) {
 
 void setServerUrl(const char* url) {
   config.serverUrl = String(url);
+  httpAsyncSetup(url);
 }
 
 void printWiFiStatus() {
@@ -266,13 +502,14 @@ void printWiFiStatus() {
   Serial.printf("SSID: %s\n", config.ssid.c_str());
   Serial.printf("Status: %s\n", getWiFiStatusString().c_str());
   Serial.printf("IP Address: %s\n", WiFi.localIP().toString().c_str());
-  Serial.printf("MAC Address: %s\n", WiFi.macAddress().c_str());
+  Serial.printf("MAC Address: %s\n", halDeviceId());
   Serial.printf("RSSI: %d dBm\n", WiFi.RSSI());
   Serial.printf("Retries: %d/%d\n", currentRetries, config.maxRetries);
-  if (!lastError.isEmpty()) {
-    Serial.printf("Last Error: %s\n", lastError.c_str());
+  if (lastError[0] != '\0') {
+    Serial.printf("Last Error: %s\n", lastError);
   }
   Serial.println("==================");
+  printHttpConnectionStats();
 }
 
 String getLastError() {
@@ -3,6 +3,9 @@
 
 #include <Arduino.h>
 #include <mushroom_types.h>
+#include "telemetry_spool.h"
+#include "telemetry_format.h"
+#include "actuators.h"
 
 // WiFi connection status enum for better status tracking
 enum class WiFiStatus {
@@ -22,6 +25,20 @@ struct WiFiConfig {
   unsigned int maxRetries;
 };
 
+// Result of one /api/sync exchange
+struct SyncResult {
+  GrowthPhase phase;
+  unsigned long configVersion;     // Bumped by the server whenever phase/config change
+  unsigned long reportIntervalMs;  // How often the server wants readings, 0 = unchanged
+  size_t readingsUploaded;         // Readings carried by the request that got this reply
+  size_t summariesUploaded;        // Window summaries carried by that request
+  bool rawSamples;                 // Server wants raw readings, not just summaries
+  bool autotune;                   // Start an autotune of the current phase
+  ControlMode controlMode;         // BANG_BANG when the server leaves it out
+  VentilationStyle ventilationStyle;   // BURST when the server leaves it out
+  VentilationMode ventilationMode;     // For the phase above; BALANCED when left out
+};
+
 // WiFi management functions
 void wifiSetup(const char* ssid, const char* password, const char* serverUrl);
 void wifiRetryLoop();
@@ -29,14 +46,38 @@ bool wifiConnected();
 WiFiStatus getWiFiStatus();
 String getWiFiStatusString();
 
-// HTTP communication functions
-bool sendPostRequest(const char* serverUrl, const String& jsonPayload);
-bool sendSensorData(float humidity, float temperature, float pressure);
-GrowthPhase getCurrentPhase();
+// Phase names
+GrowthPhase stringToGrowthPhase(const char* phaseStr);
 GrowthPhase stringToGrowthPhase(const String& phaseStr);
 String growthPhaseToString(GrowthPhase phase);
-// JSON utility functions
-String createSensorJson(float humidity, float temperature, float pressure);
+const char* growthPhaseName(GrowthPhase phase);
+
+// Asynchronous HTTP functions (return immediately, advanced by wifiCommPoll)
+bool requestPhaseAsync();
+void wifiCommPoll();
+bool takePhaseUpdate(GrowthPhase& phase);
+
+// Single round trip: upload readings and receive phase/config in the reply
+bool syncBatchAsync(const SpoolRecord* records, size_t count,
+                    const WindowSummary* summaries = NULL, size_t summaryCount = 0);
+bool isSyncInFlight();
+bool takeSyncResult(SyncResult& result);
+
+// Push channel: a long-poll that the server answers as soon as the phase or
+// config version changes. Results carry no upload counts.
+bool watchPhaseAsync(unsigned long knownConfigVersion);
+bool isPhaseWatchActive();
+bool isPushChannelUp();        // Last watch succeeded; polling can back off
+bool takeWatchResult(SyncResult& result);
+
+// Upload encoding (JSON by default)
+void setTelemetryEncoding(TelemetryEncoding encoding);
+TelemetryEncoding getTelemetryEncoding();
+
+// JSON utility functions (createSensorJson() lives in telemetry_format.h)
+bool parsePhaseResponse(const char* body, GrowthPhase& phase);   // No heap use
+bool parseSyncResponse(const char* body, SyncResult& result);    // No heap use
+const char* getDeviceId();                                       // halDeviceId()
 
 // Configuration functions
 void setRetryInterval(unsigned long intervalMs);
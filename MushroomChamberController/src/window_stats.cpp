@@ -0,0 +1,163 @@
+#include "window_stats.h"
+#include "actuators.h"
+#include "config.h"
+#include "hal/hal.h"
+#include <Arduino.h>
+#include <math.h>
+
+// --- Current Window ---
+static unsigned long windowMs = SUMMARY_WINDOW_MS;
+static bool windowOpen = false;
+static unsigned long windowStart = 0;
+static unsigned long lastSampleTime = 0;
+static uint32_t windowEpoch = 0;
+static uint16_t windowSamples = 0;
+static RunningStats humidityStats;
+static RunningStats temperatureStats;
+static RunningStats pressureStats;
+static uint16_t humidifierOnSamples = 0;
+static uint16_t fansOnSamples = 0;
+static uint16_t ventilatingSamples = 0;
+
+// --- Summary Ring ---
+static WindowSummary summaries[SUMMARY_QUEUE_CAPACITY];
+static size_t summaryHead = 0;
+static size_t summaryTotal = 0;
+static unsigned long droppedSummaries = 0;
+
+void runningStatsReset(RunningStats& stats) {
+  stats.count = 0;
+  stats.mean = 0.0f;
+  stats.m2 = 0.0f;
+  stats.min = NAN;
+  stats.max = NAN;
+}
+
+void runningStatsAdd(RunningStats& stats, float value) {
+  if (isnan(value)) {
+    return;
+  }
+
+  stats.count++;
+  float delta = value - stats.mean;
+  stats.mean += delta / stats.count;
+  stats.m2 += delta * (value - stats.mean);
+
+  if (stats.count == 1 || value < stats.min) stats.min = value;
+  if (stats.count == 1 || value > stats.max) stats.max = value;
+}
+
+FieldSummary runningStatsSummary(const RunningStats& stats) {
+  FieldSummary summary;
+  if (stats.count == 0) {
+    summary.min = summary.max = summary.mean = summary.stddev = NAN;
+    return summary;
+  }
+
+  summary.min = stats.min;
+  summary.max = stats.max;
+  summary.mean = stats.mean;
+  // Population deviation: the window is the whole population we report on
+  summary.stddev = sqrtf(stats.m2 / stats.count);
+  return summary;
+}
+
+void setSummaryWindow(unsigned long newWindowMs) {
+  windowMs = max(newWindowMs, 1000UL);
+}
+
+static uint8_t dutyPct(uint16_t onSamples) {
+  return windowSamples > 0 ? (uint8_t)((onSamples * 100UL + windowSamples / 2) / windowSamples) : 0;
+}
+
+static void queueSummary(const WindowSummary& summary) {
+  if (summaryTotal == SUMMARY_QUEUE_CAPACITY) {
+    summaryTotal--;
+    droppedSummaries++;
+  }
+  summaries[summaryHead] = summary;
+  summaryHead = (summaryHead + 1) % SUMMARY_QUEUE_CAPACITY;
+  summaryTotal++;
+}
+
+static void closeWindow() {
+  WindowSummary summary;
+  summary.epoch = windowEpoch;
+  summary.uptimeMs = windowStart;
+  summary.durationMs = lastSampleTime - windowStart;
+  summary.samples = windowSamples;
+  summary.humidity = runningStatsSummary(humidityStats);
+  summary.temperature = runningStatsSummary(temperatureStats);
+  summary.pressure = runningStatsSummary(pressureStats);
+  summary.humidifierDutyPct = dutyPct(humidifierOnSamples);
+  summary.fanDutyPct = dutyPct(fansOnSamples);
+  summary.ventilationDutyPct = dutyPct(ventilatingSamples);
+  queueSummary(summary);
+}
+
+static void openWindow(unsigned long start) {
+  windowOpen = true;
+  windowStart = start;
+  windowSamples = 0;
+  humidifierOnSamples = 0;
+  fansOnSamples = 0;
+  ventilatingSamples = 0;
+  runningStatsReset(humidityStats);
+  runningStatsReset(temperatureStats);
+  runningStatsReset(pressureStats);
+
+  windowEpoch = 0;
+  if (isTimeSynced()) {
+    windowEpoch = (uint32_t)halWallClock() - (millis() - start) / 1000;
+  }
+}
+
+void windowStatsAdd(const SensorReading& reading, uint8_t actuatorFlags) {
+  if (windowOpen && reading.timestamp - windowStart >= windowMs) {
+    closeWindow();
+    windowOpen = false;
+  }
+  if (!windowOpen) {
+    openWindow(reading.timestamp);
+  }
+
+  runningStatsAdd(humidityStats, reading.humidity);
+  runningStatsAdd(temperatureStats, reading.temperature);
+  runningStatsAdd(pressureStats, reading.pressure);
+
+  // Readings are evenly spaced, so the share of samples is the duty cycle
+  windowSamples++;
+  if (actuatorFlags & ACTUATOR_FLAG_HUMIDIFIER) humidifierOnSamples++;
+  if (actuatorFlags & ACTUATOR_FLAG_FANS) fansOnSamples++;
+  if (actuatorFlags & ACTUATOR_FLAG_VENTILATING) ventilatingSamples++;
+  lastSampleTime = reading.timestamp;
+}
+
+size_t summaryPeek(WindowSummary* out, size_t maxSummaries) {
+  size_t count = min(maxSummaries, summaryTotal);
+  size_t oldest = (summaryHead + SUMMARY_QUEUE_CAPACITY - summaryTotal) % SUMMARY_QUEUE_CAPACITY;
+  for (size_t i = 0; i < count; i++) {
+    out[i] = summaries[(oldest + i) % SUMMARY_QUEUE_CAPACITY];
+  }
+  return count;
+}
+
+void summaryConsume(size_t count) {
+  summaryTotal -= min(count, summaryTotal);
+}
+
+size_t summaryCount() {
+  return summaryTotal;
+}
+
+void printWindowStatsStatus() {
+  Serial.println("=== Window Statistics ===");
+  Serial.printf("Window: %lu ms (%u samples so far)\n", windowMs, windowSamples);
+  if (humidityStats.count > 0) {
+    FieldSummary h = runningStatsSummary(humidityStats);
+    Serial.printf("Humidity: %.1f-%.1f %% (mean %.1f, sd %.2f)\n", h.min, h.max, h.mean, h.stddev);
+  }
+  Serial.printf("Queued summaries: %u/%u\n", (unsigned)summaryTotal, SUMMARY_QUEUE_CAPACITY);
+  Serial.printf("Dropped summaries: %lu\n", droppedSummaries);
+  Serial.println("=========================");
+}
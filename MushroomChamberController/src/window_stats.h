@@ -0,0 +1,60 @@
+#ifndef WINDOW_STATS_H
+#define WINDOW_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sensors.h"
+
+// --- Window Sizing ---
+#define SUMMARY_WINDOW_MS      60000   // One summary per minute
+#define SUMMARY_QUEUE_CAPACITY 4       // Closed windows waiting for the comms task to spool them
+#define SUMMARY_BATCH_SIZE     2       // Summaries per upload request
+
+// Welford running moments; numerically stable in float over long windows
+struct RunningStats {
+  uint32_t count;
+  float mean;
+  float m2;       // Sum of squared distances from the mean
+  float min;
+  float max;
+};
+
+struct FieldSummary {
+  float min;
+  float max;
+  float mean;
+  float stddev;   // NaN for every field when the window had no valid samples
+};
+
+// One closed window
+struct WindowSummary {
+  uint32_t epoch;          // Unix time at window start, 0 if the clock was not synced
+  uint32_t uptimeMs;       // millis() at window start
+  uint32_t durationMs;
+  uint16_t samples;
+  FieldSummary humidity;
+  FieldSummary temperature;
+  FieldSummary pressure;
+  uint8_t humidifierDutyPct;   // Share of samples with the actuator on, 0-100
+  uint8_t fanDutyPct;
+  uint8_t ventilationDutyPct;
+};
+
+// --- Running Statistics ---
+void runningStatsReset(RunningStats& stats);
+void runningStatsAdd(RunningStats& stats, float value);   // NaN is ignored
+FieldSummary runningStatsSummary(const RunningStats& stats);
+
+// --- Window Functions ---
+void setSummaryWindow(unsigned long windowMs);
+void windowStatsAdd(const SensorReading& reading, uint8_t actuatorFlags);  // Queues a summary when a window closes
+
+// --- Summary Queue (oldest first) ---
+size_t summaryPeek(WindowSummary* summaries, size_t maxSummaries);
+void summaryConsume(size_t count);
+size_t summaryCount();
+
+// --- Status Functions ---
+void printWindowStatsStatus();
+
+#endif
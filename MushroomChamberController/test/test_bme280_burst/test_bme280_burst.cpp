@@ -0,0 +1,111 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <math.h>
+#include "bme280_burst.h"
+
+// Trimming values from the BME280 datasheet compensation example
+static const uint16_t T[] = { 27504, (uint16_t)26435, (uint16_t)-1000 };
+static const uint16_t P[] = { 36477, (uint16_t)-10685, 3024, 2855, 140, (uint16_t)-7, 15500, (uint16_t)-14600, 6000 };
+
+static Bme280Calibration calibration;
+
+static void putLe16(uint8_t* bytes, uint16_t value) {
+    bytes[0] = value & 0xFF;
+    bytes[1] = value >> 8;
+}
+
+static void encodeData(uint8_t* data, int32_t adcP, int32_t adcT, int32_t adcH) {
+    data[0] = adcP >> 12;
+    data[1] = (adcP >> 4) & 0xFF;
+    data[2] = (adcP & 0x0F) << 4;
+    data[3] = adcT >> 12;
+    data[4] = (adcT >> 4) & 0xFF;
+    data[5] = (adcT & 0x0F) << 4;
+    data[6] = adcH >> 8;
+    data[7] = adcH & 0xFF;
+}
+
+void setUp(void) {
+    uint8_t tpBlock[BME280_CALIB_TP_SIZE] = {};
+    for (int i = 0; i < 3; i++) putLe16(tpBlock + i * 2, T[i]);
+    for (int i = 0; i < 9; i++) putLe16(tpBlock + 6 + i * 2, P[i]);
+    tpBlock[25] = 75;                       // H1
+
+    // H2 = 362, H3 = 0, H4 = 313, H5 = 50, H6 = 30
+    const uint8_t hBlock[BME280_CALIB_H_SIZE] = { 0x6A, 0x01, 0x00, 0x13, 0x29, 0x03, 30 };
+    bme280ParseCalibration(tpBlock, hBlock, calibration);
+}
+
+void tearDown(void) {
+}
+
+void test_calibration_nibbles_are_unpacked() {
+    TEST_ASSERT_EQUAL_INT16(-1000, calibration.T3);
+    TEST_ASSERT_EQUAL_INT16(-14600, calibration.P8);
+    TEST_ASSERT_EQUAL_UINT8(75, calibration.H1);
+    TEST_ASSERT_EQUAL_INT16(362, calibration.H2);
+    TEST_ASSERT_EQUAL_INT16(313, calibration.H4);
+    TEST_ASSERT_EQUAL_INT16(50, calibration.H5);
+    TEST_ASSERT_EQUAL_INT8(30, calibration.H6);
+}
+
+void test_burst_compensates_all_values() {
+    uint8_t data[BME280_DATA_SIZE];
+    encodeData(data, 415148, 519888, 30000);
+
+    Bme280Sample sample = bme280Compensate(calibration, data);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 25.08f, sample.temperature);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1006.53f, sample.pressure);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 55.0f, sample.humidity);
+}
+
+void test_skipped_measurements_are_nan() {
+    uint8_t data[BME280_DATA_SIZE];
+    encodeData(data, 0x80000, 519888, 0x8000);
+
+    Bme280Sample sample = bme280Compensate(calibration, data);
+    TEST_ASSERT_FALSE(isnan(sample.temperature));
+    TEST_ASSERT_TRUE(isnan(sample.pressure));
+    TEST_ASSERT_TRUE(isnan(sample.humidity));
+
+    encodeData(data, 415148, 0x80000, 30000);
+    TEST_ASSERT_TRUE(isnan(bme280Compensate(calibration, data).humidity));
+}
+
+void test_humidity_is_clamped() {
+    uint8_t data[BME280_DATA_SIZE];
+    encodeData(data, 415148, 519888, 0xFFFF);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 100.0f, bme280Compensate(calibration, data).humidity);
+
+    encodeData(data, 415148, 519888, 0);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, bme280Compensate(calibration, data).humidity);
+}
+
+void test_measurement_time_follows_oversampling() {
+    Bme280Settings settings = bme280DefaultSettings();
+    // 1.25 + 2.3 * 2 + (2.3 * 16 + 0.575) + (2.3 * 1 + 0.575) ms
+    TEST_ASSERT_EQUAL_UINT32(46100, bme280MeasurementTimeUs(settings));
+
+    settings.pressureOversampling = Bme280Oversampling::SKIP;
+    settings.humidityOversampling = Bme280Oversampling::SKIP;
+    TEST_ASSERT_EQUAL_UINT32(5850, bme280MeasurementTimeUs(settings));
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== BME280 Burst Read Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_calibration_nibbles_are_unpacked);
+    RUN_TEST(test_burst_compensates_all_values);
+    RUN_TEST(test_skipped_measurements_are_nan);
+    RUN_TEST(test_humidity_is_clamped);
+    RUN_TEST(test_measurement_time_follows_oversampling);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
@@ -0,0 +1,97 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <chrono>
+#include "hal/hal.h"
+#include "actuators.h"
+#include "sim/chamber_sim.h"
+
+#define DAY_SEC 86400UL
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_plant_humidifier_and_fans() {
+    ChamberPlant plant = chamberDefaultPlant();
+    ChamberState state = { 20.0f, 45.0f };
+
+    for (int i = 0; i < 300; i++) chamberStep(plant, state, true, 0.0f, 1.0f);
+    TEST_ASSERT_GREATER_THAN(80.0f, state.humidity);
+    TEST_ASSERT_LESS_OR_EQUAL(100.0f, state.humidity);
+    TEST_ASSERT_LESS_THAN(20.0f, state.temperature);   // Evaporative cooling
+
+    float before = state.humidity;
+    for (int i = 0; i < 30; i++) chamberStep(plant, state, false, 1.0f, 1.0f);
+    TEST_ASSERT_FLOAT_WITHIN(3.0f, 10.0f, before - state.humidity);
+}
+
+void test_plant_relaxes_to_ambient() {
+    ChamberPlant plant = chamberDefaultPlant();
+    plant.heatGain = 0.0f;
+    ChamberState state = { 25.0f, 90.0f };
+
+    for (unsigned long i = 0; i < DAY_SEC; i++) chamberStep(plant, state, false, 0.0f, 1.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, plant.ambientHumidity, state.humidity);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, plant.ambientTemperature, state.temperature);
+}
+
+void test_fruiting_day_holds_target() {
+    ChamberSimPhase phases[] = { { FRUITING, DAY_SEC } };
+    ChamberSimKpis kpis = chamberSimulate(chamberDefaultPlant(), OYSTER, phases, 1);
+    printChamberKpis(kpis);
+
+    TEST_ASSERT_EQUAL_UINT32(DAY_SEC, kpis.simulatedSec);
+    TEST_ASSERT_GREATER_THAN(0.8f, kpis.timeInTolerance);
+    TEST_ASSERT_GREATER_THAN(0UL, kpis.fanCycles);         // Scheduled ventilation ran
+    TEST_ASSERT_GREATER_THAN(0.0f, kpis.energyWh);
+}
+
+void test_runs_are_repeatable() {
+    ChamberSimPhase phases[] = { { FRUITING, 6 * 3600UL } };
+    ChamberSimKpis first = chamberSimulate(chamberDefaultPlant(), OYSTER, phases, 1);
+    ChamberSimKpis second = chamberSimulate(chamberDefaultPlant(), OYSTER, phases, 1);
+
+    TEST_ASSERT_EQUAL_UINT32(first.humidifierCycles, second.humidifierCycles);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, first.timeInTolerance, second.timeInTolerance);
+}
+
+void test_whole_grow_faster_than_real_time() {
+    // Two weeks of colonisation, five days pinning, ten days fruiting
+    ChamberSimPhase phases[] = {
+        { INCUBATION, 14 * DAY_SEC },
+        { PRIMORDIA_FORMATION, 5 * DAY_SEC },
+        { FRUITING, 10 * DAY_SEC }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    ChamberSimKpis kpis = chamberSimulate(chamberDefaultPlant(), OYSTER, phases, 3);
+    double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printChamberKpis(kpis);
+    Serial.printf("Host time: %.2f s (%.0fx real time)\n", wallSec, kpis.simulatedSec / wallSec);
+
+    TEST_ASSERT_EQUAL_UINT32(29 * DAY_SEC, kpis.simulatedSec);
+    TEST_ASSERT_GREATER_THAN(0.5f, kpis.timeInTolerance);
+    TEST_ASSERT_LESS_THAN(60.0, wallSec);
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Chamber Simulator Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_plant_humidifier_and_fans);
+    RUN_TEST(test_plant_relaxes_to_ambient);
+    RUN_TEST(test_fruiting_day_holds_target);
+    RUN_TEST(test_runs_are_repeatable);
+    RUN_TEST(test_whole_grow_faster_than_real_time);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
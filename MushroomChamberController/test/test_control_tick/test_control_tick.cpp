@@ -0,0 +1,137 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <string.h>
+#include "control_tick.h"
+#include "telemetry_format.h"
+
+#define PERIOD_US 1000000
+#define START_US  5000000LL
+
+// Start of the step for deadline n, that many microseconds late
+static ControlTick stepAt(int deadline, uint32_t lateUs) {
+    return controlTickBegin(START_US + (int64_t)deadline * PERIOD_US + lateUs);
+}
+
+void setUp(void) {
+    controlTickStart(PERIOD_US, START_US);
+}
+
+void tearDown(void) {
+}
+
+void test_steps_on_time() {
+    for (int n = 1; n <= 5; n++) {
+        ControlTick tick = stepAt(n, 0);
+        TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.0f, tick.dtSec);
+        TEST_ASSERT_EQUAL_UINT32(0, tick.latenessUs);
+        TEST_ASSERT_EQUAL_UINT32(0, tick.missed);
+    }
+    ControlTickStats stats = getControlTickStats();
+    TEST_ASSERT_EQUAL_UINT32(5, stats.ticks);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.maxLatenessUs);
+}
+
+void test_late_step_keeps_the_grid() {
+    stepAt(1, 0);
+    ControlTick late = stepAt(2, 200000);
+    TEST_ASSERT_EQUAL_UINT32(200000, late.latenessUs);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.2f, late.dtSec);
+
+    // The next deadline did not move, so the real dt is shorter
+    ControlTick next = stepAt(3, 0);
+    TEST_ASSERT_EQUAL_UINT32(0, next.latenessUs);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.8f, next.dtSec);
+}
+
+void test_overrun_counts_missed_periods() {
+    stepAt(1, 0);
+    // Deadline 2 served 1.5 periods late; deadline 3 passed without a step
+    ControlTick tick = stepAt(3, 500000);
+    TEST_ASSERT_EQUAL_UINT32(1500000, tick.latenessUs);
+    TEST_ASSERT_EQUAL_UINT32(1, tick.missed);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 2.5f, tick.dtSec);
+
+    TEST_ASSERT_EQUAL_UINT32(0, stepAt(4, 0).latenessUs);
+    TEST_ASSERT_EQUAL_UINT32(1, getControlTickStats().missed);
+}
+
+void test_p99_ignores_rare_outliers() {
+    // 6 of 600 steps, exactly 1 %, may be as late as they like
+    for (int n = 1; n <= CONTROL_TICK_WINDOW; n++) {
+        stepAt(n, n % 100 == 0 ? 50000 : 100);
+    }
+    ControlTickStats stats = getControlTickStats();
+    TEST_ASSERT_EQUAL_UINT32(CONTROL_TICK_WINDOW, stats.windowTicks);
+    TEST_ASSERT_EQUAL_UINT32(50000, stats.maxLatenessUs);
+    TEST_ASSERT_UINT32_WITHIN(25, 100, stats.p99LatenessUs);
+}
+
+void test_p99_reports_frequent_lateness() {
+    for (int n = 1; n <= CONTROL_TICK_WINDOW; n++) {
+        stepAt(n, n % 50 == 0 ? 50000 : 100);
+    }
+    ControlTickStats stats = getControlTickStats();
+    TEST_ASSERT_GREATER_OR_EQUAL(50000, stats.p99LatenessUs);
+    TEST_ASSERT_LESS_OR_EQUAL(stats.maxLatenessUs, stats.p99LatenessUs);
+}
+
+void test_closed_window_is_reported_until_the_next() {
+    for (int n = 1; n <= CONTROL_TICK_WINDOW; n++) {
+        stepAt(n, n == 10 ? 300000 : 0);
+    }
+    // A quiet start to the next window does not hide the last one's spike
+    for (int n = CONTROL_TICK_WINDOW + 1; n <= CONTROL_TICK_WINDOW + 100; n++) {
+        stepAt(n, 0);
+    }
+    ControlTickStats stats = getControlTickStats();
+    TEST_ASSERT_EQUAL_UINT32(CONTROL_TICK_WINDOW + 100, stats.ticks);
+    TEST_ASSERT_EQUAL_UINT32(CONTROL_TICK_WINDOW, stats.windowTicks);
+    TEST_ASSERT_EQUAL_UINT32(300000, stats.maxLatenessUs);
+}
+
+void test_jitter_goes_out_in_telemetry() {
+    stepAt(1, 1500);
+    stepAt(2, 2500);
+
+    TelemetryContext context = { "AA:BB:CC:DD:EE:FF", -55, NULL, NULL };
+    ControlTickStats stats = getControlTickStats();
+    context.controlTick = &stats;
+
+    char json[512];
+    TEST_ASSERT_GREATER_THAN(0, writeBatchJson(json, sizeof(json), context, NULL, 0));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"control_tick\":{\"period_ms\":1000,\"ticks\":2,\"missed\":0"));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"max_lateness_us\":2500"));
+
+    // {"v", "id", "rssi", "r", "t"}, t = [1000, 2, 0, 2, 2500, p99]
+    uint8_t cbor[128];
+    size_t length = writeBatchCbor(cbor, sizeof(cbor), context, NULL, 0);
+    TEST_ASSERT_GREATER_THAN(0, length);
+    TEST_ASSERT_EQUAL_UINT8(0xA5, cbor[0]);
+    const uint8_t tick[] = { 0x61, 't', 0x86, 0x19, 0x03, 0xE8, 0x02, 0x00, 0x02, 0x19, 0x09, 0xC4 };
+    bool found = false;
+    for (size_t i = 0; i + sizeof(tick) <= length; i++) {
+        found = found || memcmp(cbor + i, tick, sizeof(tick)) == 0;
+    }
+    TEST_ASSERT_TRUE(found);
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Control Tick Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_steps_on_time);
+    RUN_TEST(test_late_step_keeps_the_grid);
+    RUN_TEST(test_overrun_counts_missed_periods);
+    RUN_TEST(test_p99_ignores_rare_outliers);
+    RUN_TEST(test_p99_reports_frequent_lateness);
+    RUN_TEST(test_closed_window_is_reported_until_the_next);
+    RUN_TEST(test_jitter_goes_out_in_telemetry);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
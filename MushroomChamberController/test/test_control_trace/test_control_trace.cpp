@@ -0,0 +1,196 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <string>
+#include "hal/hal.h"
+#include "actuators.h"
+#include "config.h"
+#include "control_trace.h"
+#include "controller_store.h"
+#include "relay_autotune.h"
+#include "sensor_fusion.h"
+#include "sim/chamber_sim.h"
+#include "sim/trace_replay.h"
+
+#define TRACE_CAPACITY (3 * 3600 * TRACE_RECORD_SIZE)
+
+static uint8_t recorded[TRACE_CAPACITY];
+static size_t recordedLength = 0;
+static std::string serialCapture;
+
+static void memoryWriter(const uint8_t* data, size_t length) {
+  size_t room = sizeof(recorded) - recordedLength;
+  length = min(length, room);
+  memcpy(recorded + recordedLength, data, length);
+  recordedLength += length;
+}
+
+static void captureWriter(const uint8_t* data, size_t length) {
+  char line[64];
+  for (size_t offset = 0; offset < length; offset += TRACE_RECORD_SIZE) {
+    traceFormatLine(data + offset, line, sizeof(line));
+    serialCapture += "[12:00:01] ";
+    serialCapture += line;
+    serialCapture += "\n";
+  }
+}
+
+// Two hours of fruiting on the chamber model, recorded like on the board
+static void recordRun() {
+  recordedLength = 0;
+  halNativeClearNvs();   // chamberSimulate() starts untuned
+  halNativeSetMillis(1000);
+  traceSetup(memoryWriter);
+  ChamberSimPhase phases[] = { { FRUITING, 2 * 3600UL } };
+  chamberSimulate(chamberDefaultPlant(), OYSTER, phases, 1);
+  traceFlush();
+  traceSetup(NULL);
+}
+
+// A board that reboots with a tuned checkpoint in NVS, driven through the
+// same steps as the control task for an hour
+static void recordRunFromCheckpoint() {
+  currentConfig = getMushroomConfig(OYSTER);
+  currentPhase = FRUITING;
+  activePhaseConfig = getActivePhaseConfig();
+  halNativeClearNvs();
+  clearPhaseTunings();
+  setupActuators();
+  LearnedParameters learned = getLearnedParameters();
+  learned.humidityOvershoot = 6.0f;
+  learned.humidityBuildRate = 0.02f;
+  TEST_ASSERT_TRUE(saveControllerCheckpoint(learned, millis()));
+
+  recordedLength = 0;
+  halNativeSetMillis(1000);
+  traceSetup(memoryWriter);
+  fusionReset();
+  setupActuators();
+
+  ChamberPlant plant = chamberDefaultPlant();
+  ChamberState chamber = { plant.ambientTemperature, plant.ambientHumidity };
+  for (int sec = 0; sec < 3600; sec++) {
+    chamberStep(plant, chamber, isHumidifierOn(), getCurrentFanSpeed(), 1.0f);
+    halNativeAdvanceMillis(1000);
+    fusionUpdate(FUSION_SOURCE_BME280, chamber.temperature, chamber.humidity, millis());
+    FusedEstimate estimate = fusionEstimate(millis());
+    updateActuators(estimate.humidity, estimate.temperature, 1013.25f, 1.0f);
+    traceRecord(estimate.humidity, estimate.temperature, 1013.25f);
+  }
+  traceFlush();
+  traceSetup(NULL);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_record_round_trip() {
+  TraceRecord record = {};
+  record.timestampMs = 0xDEADBEEF;
+  record.temperature = -3.25f;
+  record.humidity = 88.12f;
+  record.pressure = NAN;
+  record.targetHumidity = 88.0f;
+  record.phase = PRIMORDIA_FORMATION;
+  record.health = SensorHealth::DEGRADED;
+  record.state = RECOVERING;
+  record.actuatorFlags = ACTUATOR_FLAG_HUMIDIFIER;
+
+  uint8_t bytes[TRACE_RECORD_SIZE];
+  traceEncode(record, bytes);
+  TraceRecord decoded;
+  traceDecode(bytes, decoded);
+
+  TEST_ASSERT_EQUAL_UINT32(0xDEADBEEF, decoded.timestampMs);
+  TEST_ASSERT_TRUE(decoded.temperature == -3.25f);
+  TEST_ASSERT_TRUE(decoded.humidity == 88.12f);
+  TEST_ASSERT_TRUE(isnan(decoded.pressure));
+  TEST_ASSERT_EQUAL(PRIMORDIA_FORMATION, decoded.phase);
+  TEST_ASSERT_EQUAL(SensorHealth::DEGRADED, decoded.health);
+  TEST_ASSERT_EQUAL(RECOVERING, decoded.state);
+  TEST_ASSERT_EQUAL_UINT8(ACTUATOR_FLAG_HUMIDIFIER, decoded.actuatorFlags);
+}
+
+void test_serial_lines_parse_back() {
+  serialCapture = "Humidifier: ON\n";
+  halNativeSetMillis(5000);
+  traceSetup(captureWriter);
+  traceRecord(87.5f, 18.0f, 1013.2f);
+  traceRecord(NAN, NAN, NAN);
+  traceFlush();
+  traceSetup(NULL);
+
+  uint8_t parsed[4 * TRACE_RECORD_SIZE];
+  size_t length = traceParseLog(serialCapture.c_str(), parsed, sizeof(parsed));
+  TEST_ASSERT_EQUAL(3 * TRACE_RECORD_SIZE, length);   // Boot marker + two decisions
+
+  TraceRecord record;
+  traceDecode(parsed, record);
+  TEST_ASSERT_EQUAL(TRACE_STATE_BOOT, record.state);
+  traceDecode(parsed + TRACE_RECORD_SIZE, record);
+  TEST_ASSERT_FLOAT_WITHIN(0.005f, 87.5f, record.humidity);
+  traceDecode(parsed + 2 * TRACE_RECORD_SIZE, record);
+  TEST_ASSERT_TRUE(isnan(record.humidity));
+}
+
+void test_replay_matches_recording() {
+  recordRun();
+  TEST_ASSERT_GREATER_THAN(7000, (int)(recordedLength / TRACE_RECORD_SIZE));
+
+  TraceReplayResult result = traceReplay(recorded, recordedLength, OYSTER);
+  printTraceReplayResult(result);
+
+  TEST_ASSERT_EQUAL(1, result.boots);
+  TEST_ASSERT_EQUAL(0, result.mismatches);
+  TEST_ASSERT_EQUAL(-1, result.firstMismatch);
+  TEST_ASSERT_EQUAL_UINT32(result.recorded.humidifierCycles, result.replayed.humidifierCycles);
+  TEST_ASSERT_GREATER_THAN(0UL, result.recorded.fanCycles);
+}
+
+void test_replay_flags_changed_decisions() {
+  recordRun();
+
+  // Pretend the recorded build kept the humidifier off at decision 100
+  size_t index = 101;   // After the boot marker
+  recorded[index * TRACE_RECORD_SIZE + 17] ^= ACTUATOR_FLAG_HUMIDIFIER;
+
+  TraceReplayResult result = traceReplay(recorded, recordedLength, OYSTER);
+  TEST_ASSERT_EQUAL(1, result.mismatches);
+  TEST_ASSERT_EQUAL(101, result.firstMismatch);
+}
+
+void test_replay_resumes_the_recorded_checkpoint() {
+  recordRunFromCheckpoint();
+
+  // The blob follows the boot marker, and replay restores it before any decision
+  TraceRecord record;
+  traceDecode(recorded + TRACE_RECORD_SIZE, record);
+  TEST_ASSERT_EQUAL(TRACE_STATE_CHECKPOINT, record.state);
+
+  halNativeClearNvs();
+  TraceReplayResult result = traceReplay(recorded, recordedLength, OYSTER);
+  TEST_ASSERT_EQUAL(1, result.boots);
+  TEST_ASSERT_EQUAL(3600, result.records);
+  TEST_ASSERT_EQUAL(0, result.mismatches);
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+
+  Serial.println("\n=== Control Trace Test Suite ===");
+
+  UNITY_BEGIN();
+  RUN_TEST(test_record_round_trip);
+  RUN_TEST(test_serial_lines_parse_back);
+  RUN_TEST(test_replay_matches_recording);
+  RUN_TEST(test_replay_flags_changed_decisions);
+  RUN_TEST(test_replay_resumes_the_recorded_checkpoint);
+  UNITY_END();
+}
+
+void loop() {
+  delay(1000);
+}
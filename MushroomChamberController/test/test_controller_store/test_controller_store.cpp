@@ -0,0 +1,153 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "hal/hal.h"
+#include "actuators.h"
+#include "controller_store.h"
+#include "relay_autotune.h"
+#include "sim/chamber_sim.h"
+
+static LearnedParameters sampleParameters() {
+    LearnedParameters learned = {};
+    learned.humidityOvershoot = 1.5f;
+    learned.humidifyDuration = 72000;
+    learned.ventilationDuration = 24000;
+    learned.humidityBuildRate = 0.08f;
+    learned.humidityDecayRate = 0.02f;
+    learned.humidityBeforeVentilation = 90.0f;
+    learned.humidityAfterVentilation = 80.0f;
+    learned.pidIntegral = 0.37f;
+    learned.humidificationCycles = 42;
+    learned.ventilationCycles = 17;
+    learned.totalHumidifyTime = 3600000;
+    return learned;
+}
+
+void setUp(void) {
+    halNativeClearNvs();
+    clearPhaseTunings();
+}
+
+void tearDown(void) {
+}
+
+void test_crc32_reference_value() {
+    const char* check = "123456789";
+    TEST_ASSERT_EQUAL_UINT32(0xCBF43926, crc32((const uint8_t*)check, 9));
+}
+
+void test_round_trip_with_tunings() {
+    AutotuneResult tuning = {};
+    tuning.valid = true;
+    tuning.ultimatePeriodSec = 150.0f;
+    tuning.ventilationDuration = 33000;
+    setPhaseTuning(FRUITING, tuning);
+
+    TEST_ASSERT_TRUE(saveControllerCheckpoint(sampleParameters(), 0));
+    clearPhaseTunings();
+
+    LearnedParameters loaded;
+    TEST_ASSERT_TRUE(loadControllerCheckpoint(loaded));
+    TEST_ASSERT_EQUAL_UINT32(24000, loaded.ventilationDuration);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.37f, loaded.pidIntegral);
+    TEST_ASSERT_EQUAL(17, loaded.ventilationCycles);
+    TEST_ASSERT_NOT_NULL(getPhaseTuning(FRUITING));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 150.0f, getPhaseTuning(FRUITING)->ultimatePeriodSec);
+    TEST_ASSERT_NULL(getPhaseTuning(INCUBATION));
+}
+
+void test_corrupt_blob_is_rejected() {
+    saveControllerCheckpoint(sampleParameters(), 0);
+
+    uint8_t blob[512];
+    size_t length = halNvsRead(CONTROLLER_STORE_KEY, blob, sizeof(blob));
+    TEST_ASSERT_GREATER_THAN(0, (int)length);
+    blob[10] ^= 0x01;   // Bit flip inside the learned parameters
+    halNvsWrite(CONTROLLER_STORE_KEY, blob, length);
+
+    unsigned long rejectedBefore = getControllerStoreStats().rejected;
+    LearnedParameters loaded;
+    TEST_ASSERT_FALSE(loadControllerCheckpoint(loaded));
+    TEST_ASSERT_EQUAL_UINT32(rejectedBefore + 1, getControllerStoreStats().rejected);
+    TEST_ASSERT_EQUAL(0, (int)halNvsRead(CONTROLLER_STORE_KEY, blob, sizeof(blob)));   // Erased
+}
+
+void test_other_version_is_rejected() {
+    saveControllerCheckpoint(sampleParameters(), 0);
+
+    uint8_t blob[512];
+    size_t length = halNvsRead(CONTROLLER_STORE_KEY, blob, sizeof(blob));
+    blob[0] = CONTROLLER_STORE_VERSION + 1;   // Version is the first field
+    halNvsWrite(CONTROLLER_STORE_KEY, blob, length);
+
+    LearnedParameters loaded;
+    TEST_ASSERT_FALSE(loadControllerCheckpoint(loaded));
+}
+
+void test_checkpoints_are_throttled() {
+    unsigned long writesBefore = getControllerStoreStats().writes;
+    unsigned long nvsWritesBefore = halNativeNvsWrites();
+
+    // Six hours of steady control: at most one write per interval, and one
+    // more per interval for the actuator wear counters
+    ChamberSimPhase phases[] = { { FRUITING, 6 * 3600UL, false } };
+    chamberSimulate(chamberDefaultPlant(), OYSTER, phases, 1);
+
+    unsigned long writes = getControllerStoreStats().writes - writesBefore;
+    TEST_ASSERT_GREATER_THAN(0UL, writes);
+    TEST_ASSERT_LESS_OR_EQUAL(6 * 3600000UL / CONTROLLER_STORE_INTERVAL_MS + 1, writes);
+    TEST_ASSERT_LESS_OR_EQUAL(2 * (6 * 3600000UL / CONTROLLER_STORE_INTERVAL_MS + 1),
+                              halNativeNvsWrites() - nvsWritesBefore);
+}
+
+void test_reboot_resumes_learned_state() {
+    ChamberSimPhase phases[] = { { FRUITING, 6 * 3600UL, false } };
+    chamberSimulate(chamberDefaultPlant(), OYSTER, phases, 1);
+    halNativeAdvanceMillis(CONTROLLER_STORE_INTERVAL_MS);
+    saveControllerCheckpoint(getLearnedParameters(), millis());
+    LearnedParameters before = getLearnedParameters();
+    TEST_ASSERT_GREATER_THAN(0, before.ventilationCycles);
+
+    // Power blip
+    setupActuators();
+    LearnedParameters after = getLearnedParameters();
+    TEST_ASSERT_EQUAL(before.ventilationCycles, after.ventilationCycles);
+    TEST_ASSERT_EQUAL_UINT32(before.ventilationDuration, after.ventilationDuration);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, before.humidityBuildRate, after.humidityBuildRate);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, before.pidIntegral, after.pidIntegral);
+}
+
+void test_control_step_only_stages_the_write() {
+    setupActuators();
+    halNativeAdvanceMillis(CONTROLLER_STORE_INTERVAL_MS);
+    unsigned long nvsWritesBefore = halNativeNvsWrites();
+
+    // Both stores are due, but the NVS writes wait for the comms task
+    updateActuators(85.0f, 22.0f, 1013.0f, 1.0f);
+    TEST_ASSERT_EQUAL_UINT32(nvsWritesBefore, halNativeNvsWrites());
+
+    writeStagedCheckpoints();
+    TEST_ASSERT_EQUAL_UINT32(nvsWritesBefore + 2, halNativeNvsWrites());
+    LearnedParameters loaded;
+    TEST_ASSERT_TRUE(loadControllerCheckpoint(loaded));
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Controller Store Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_crc32_reference_value);
+    RUN_TEST(test_round_trip_with_tunings);
+    RUN_TEST(test_corrupt_blob_is_rejected);
+    RUN_TEST(test_other_version_is_rejected);
+    RUN_TEST(test_checkpoints_are_throttled);
+    RUN_TEST(test_reboot_resumes_learned_state);
+    RUN_TEST(test_control_step_only_stages_the_write);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
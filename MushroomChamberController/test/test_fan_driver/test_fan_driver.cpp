@@ -0,0 +1,135 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "hal/hal.h"
+#include "config.h"
+#include "actuators.h"
+#include "fan_driver.h"
+#include "controller_store.h"
+#include "sim/chamber_sim.h"
+
+// Pins from fan_driver.cpp
+#define EXHAUST_FAN1_PIN 13
+#define INLET_FAN_PIN 14
+
+#define DAY_SEC 86400UL
+
+void setUp(void) {
+    halNativeSetMillis(100000);
+    setupFanDriver();
+}
+
+void tearDown(void) {
+    setVentilationStyle(VentilationStyle::BURST);
+    setControlMode(ControlMode::BANG_BANG);
+}
+
+void test_start_ramps_up_from_minimum_duty() {
+    setFanTarget(FAN_EXHAUST_1, 1.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, FAN_MIN_RUNNING_DUTY, halNativePwm(EXHAUST_FAN1_PIN));
+
+    halNativeAdvanceMillis(1000);
+    updateFanDriver(millis());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, FAN_MIN_RUNNING_DUTY + FAN_RAMP_PER_SEC, getFanDuty(FAN_EXHAUST_1));
+
+    halNativeAdvanceMillis(5000);
+    updateFanDriver(millis());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, halNativePwm(EXHAUST_FAN1_PIN));
+}
+
+void test_stop_is_immediate() {
+    setFanTarget(FAN_INLET, 1.0f);
+    halNativeAdvanceMillis(5000);
+    updateFanDriver(millis());
+
+    setFanTarget(FAN_INLET, 0.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, halNativePwm(INLET_FAN_PIN));
+    TEST_ASSERT_FALSE(halNativeOutput(INLET_FAN_PIN));
+}
+
+void test_low_targets_are_raised_to_running_duty() {
+    setFanTarget(FAN_EXHAUST_2, 0.05f);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, FAN_MIN_RUNNING_DUTY, getFanTarget(FAN_EXHAUST_2));
+}
+
+void test_fans_have_independent_duties() {
+    setFanTarget(FAN_EXHAUST_1, 0.5f);
+    setFanTarget(FAN_INLET, 0.3f);
+    halNativeAdvanceMillis(5000);
+    updateFanDriver(millis());
+
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.5f, getFanDuty(FAN_EXHAUST_1));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, getFanDuty(FAN_EXHAUST_2));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.3f, halNativePwm(INLET_FAN_PIN));
+}
+
+void test_continuous_exchange_softens_ventilation() {
+    ChamberSimPhase phases[] = { { FRUITING, DAY_SEC } };
+    ChamberSimKpis burst = chamberSimulate(chamberDefaultPlant(), OYSTER, phases, 1);
+    setVentilationStyle(VentilationStyle::CONTINUOUS);
+    ChamberSimKpis continuous = chamberSimulate(chamberDefaultPlant(), OYSTER, phases, 1);
+    printChamberKpis(burst);
+    printChamberKpis(continuous);
+
+    TEST_ASSERT_LESS_THAN(burst.maxUndershoot, continuous.maxUndershoot);
+    TEST_ASSERT_GREATER_OR_EQUAL(burst.timeInTolerance, continuous.timeInTolerance);
+    TEST_ASSERT_GREATER_THAN(0UL, continuous.fanCycles);   // Air is still exchanged
+}
+
+void test_continuous_exchange_with_pid() {
+    ChamberSimPhase phases[] = { { FRUITING, DAY_SEC } };
+    setControlMode(ControlMode::PID);
+    ChamberSimKpis burst = chamberSimulate(chamberDefaultPlant(), OYSTER, phases, 1);
+    setVentilationStyle(VentilationStyle::CONTINUOUS);
+    ChamberSimKpis continuous = chamberSimulate(chamberDefaultPlant(), OYSTER, phases, 1);
+    printChamberKpis(burst);
+    printChamberKpis(continuous);
+
+    TEST_ASSERT_LESS_THAN(burst.maxUndershoot, continuous.maxUndershoot);
+    TEST_ASSERT_LESS_THAN(burst.meanAbsError, continuous.meanAbsError);
+}
+
+void test_continuous_exchange_at_the_shortest_ventilation() {
+    // 15 s is the floor of the duration adaptation, and a reboot restores it
+    halNativeClearNvs();
+    currentConfig = getMushroomConfig(OYSTER);
+    currentPhase = FRUITING;
+    activePhaseConfig = getActivePhaseConfig();
+    setupActuators();
+    LearnedParameters learned = getLearnedParameters();
+    learned.ventilationDuration = 15000;
+    TEST_ASSERT_TRUE(saveControllerCheckpoint(learned, millis()));
+    setupActuators();
+    setVentilationStyle(VentilationStyle::CONTINUOUS);
+
+    // 15 s of full airflow every 15 min is 50 s at 30 % speed, each 5 min
+    // window owing 16.7 s: less than the minimum pulse, so it is carried
+    unsigned long fansOnSec = 0;
+    for (unsigned long sec = 0; sec < 2 * 3600; sec++) {
+        halNativeAdvanceMillis(1000);
+        updateActuators(activePhaseConfig.targetHumidity, activePhaseConfig.targetTemperature, 1013.25f, 1.0f);
+        if (areFansOn()) fansOnSec++;
+    }
+    TEST_ASSERT_UINT32_WITHIN(40, 400, fansOnSec);
+    halNativeClearNvs();
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Fan Driver Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_start_ramps_up_from_minimum_duty);
+    RUN_TEST(test_stop_is_immediate);
+    RUN_TEST(test_low_targets_are_raised_to_running_duty);
+    RUN_TEST(test_fans_have_independent_duties);
+    RUN_TEST(test_continuous_exchange_softens_ventilation);
+    RUN_TEST(test_continuous_exchange_with_pid);
+    RUN_TEST(test_continuous_exchange_at_the_shortest_ventilation);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
@@ -0,0 +1,172 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <lwip/sockets.h>
+#include "hal/hal.h"
+#include "http_async.h"
+
+// A loopback server stands in for the backend; the HTTP engine's clock is
+// the virtual one, so the tests decide when time moves
+
+static int listener = -1;
+static int sharedPeer = -1;      // Server side of the keep-alive connection
+static int watchPeer = -1;       // Server side of the long-poll connection
+static char lastRequest[512];
+static unsigned listenerPort = 0;
+
+static void openListener() {
+    listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    bind(listener, (struct sockaddr*)&address, sizeof(address));
+    listen(listener, 4);
+    fcntl(listener, F_SETFL, fcntl(listener, F_GETFL, 0) | O_NONBLOCK);
+
+    socklen_t length = sizeof(address);
+    getsockname(listener, (struct sockaddr*)&address, &length);
+    listenerPort = ntohs(address.sin_port);
+    char url[48];
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u", listenerPort);
+    httpAsyncSetup(url);
+}
+
+// Polls the engine until it has connected and written a whole request;
+// -1 if it never did
+static int acceptRequest() {
+    int peer = -1;
+    for (int i = 0; i < 1000 && peer < 0; i++) {
+        httpAsyncPoll();
+        peer = accept(listener, NULL, NULL);
+    }
+    if (peer < 0) {
+        return -1;
+    }
+
+    char* request = lastRequest;
+    size_t length = 0;
+    for (int i = 0; i < 1000; i++) {
+        httpAsyncPoll();
+        ssize_t received = recv(peer, request + length, sizeof(lastRequest) - 1 - length, MSG_DONTWAIT);
+        if (received > 0) {
+            length += received;
+            request[length] = '\0';
+            if (strstr(request, "\r\n\r\n") != NULL) {
+                return peer;
+            }
+        }
+    }
+    close(peer);
+    return -1;
+}
+
+static void respond(int peer, const char* body) {
+    char response[128];
+    int length = snprintf(response, sizeof(response), "HTTP/1.1 200 OK\r\nContent-Length: %u\r\n\r\n%s",
+                          (unsigned)strlen(body), body);
+    send(peer, response, length, 0);
+}
+
+static bool peerClosed(int peer) {
+    char byte;
+    return recv(peer, &byte, 1, MSG_DONTWAIT) == 0;
+}
+
+// Long-poll request started from the sync reply, after its handling took a while
+static void startWatchLate(HttpEndpoint endpoint, bool success, int statusCode, const char* body, void* context) {
+    halNativeAdvanceMillis(100);
+    httpAsyncStart(ENDPOINT_PHASE_WATCH, "GET", "/api/watch", NULL, NULL, 0, NULL, NULL);
+}
+
+static void takeTime(HttpEndpoint endpoint, bool success, int statusCode, const char* body, void* context) {
+    halNativeAdvanceMillis(100);
+}
+
+void setUp(void) {
+    halNativeSetMillis(1000000);
+    openListener();
+}
+
+void tearDown(void) {
+    for (int i = 0; i < ENDPOINT_COUNT; i++) {
+        httpAsyncCancel((HttpEndpoint)i);
+    }
+    for (int* fd : { &listener, &sharedPeer, &watchPeer }) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+void test_request_started_in_a_callback_does_not_time_out() {
+    TEST_ASSERT_TRUE(httpAsyncStart(ENDPOINT_SYNC, "GET", "/api/sync", NULL, NULL, 0, startWatchLate, NULL));
+    sharedPeer = acceptRequest();
+    TEST_ASSERT_TRUE(sharedPeer >= 0);
+    respond(sharedPeer, "{}");
+
+    // The watch starts inside this poll, 100 ms after it read the clock
+    for (int i = 0; i < 100 && getHttpAsyncState(ENDPOINT_SYNC) != HttpRequestState::COMPLETE; i++) {
+        httpAsyncPoll();
+    }
+    TEST_ASSERT_EQUAL(HttpRequestState::COMPLETE, getHttpAsyncState(ENDPOINT_SYNC));
+    TEST_ASSERT_TRUE(getHttpAsyncState(ENDPOINT_PHASE_WATCH) != HttpRequestState::FAILED);
+
+    watchPeer = acceptRequest();
+    TEST_ASSERT_TRUE(watchPeer >= 0);
+    TEST_ASSERT_TRUE(isHttpAsyncBusy(ENDPOINT_PHASE_WATCH));
+}
+
+void test_connection_kept_alive_after_a_late_response() {
+    TEST_ASSERT_TRUE(httpAsyncStart(ENDPOINT_SYNC, "GET", "/api/sync", NULL, NULL, 0, takeTime, NULL));
+    TEST_ASSERT_TRUE(httpAsyncStart(ENDPOINT_PHASE_WATCH, "GET", "/api/watch", NULL, NULL, 0, NULL, NULL));
+    sharedPeer = acceptRequest();
+    bool watchFirst = strstr(lastRequest, "/api/watch") != NULL;
+    watchPeer = acceptRequest();
+    if (watchFirst) {
+        std::swap(sharedPeer, watchPeer);
+    }
+    TEST_ASSERT_TRUE(sharedPeer >= 0 && watchPeer >= 0);
+
+    // Both answers land in one poll; the sync callback moves the clock
+    // before the watch connection reads its response
+    respond(sharedPeer, "{}");
+    respond(watchPeer, "{}");
+    for (int i = 0; i < 100 && getHttpAsyncState(ENDPOINT_PHASE_WATCH) != HttpRequestState::COMPLETE; i++) {
+        usleep(1000);
+        httpAsyncPoll();
+    }
+    TEST_ASSERT_EQUAL(HttpRequestState::COMPLETE, getHttpAsyncState(ENDPOINT_PHASE_WATCH));
+
+    httpAsyncPoll();
+    TEST_ASSERT_FALSE(peerClosed(watchPeer));
+    TEST_ASSERT_FALSE(peerClosed(sharedPeer));
+}
+
+void test_host_name_is_looked_up() {
+    char url[48];
+    snprintf(url, sizeof(url), "http://localhost:%u", listenerPort);
+    httpAsyncSetup(url);
+
+    TEST_ASSERT_TRUE(httpAsyncStart(ENDPOINT_SYNC, "GET", "/api/sync", NULL, NULL, 0, NULL, NULL));
+    sharedPeer = acceptRequest();
+    TEST_ASSERT_TRUE(sharedPeer >= 0);
+    TEST_ASSERT_NOT_NULL(strstr(lastRequest, "Host: localhost"));
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== HTTP Async Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_request_started_in_a_callback_does_not_time_out);
+    RUN_TEST(test_connection_kept_alive_after_a_late_response);
+    RUN_TEST(test_host_name_is_looked_up);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
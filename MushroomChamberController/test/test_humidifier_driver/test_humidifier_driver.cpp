@@ -0,0 +1,149 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <string.h>
+#include "hal/hal.h"
+#include "humidifier_driver.h"
+#include "actuator_wear.h"
+#include "fan_driver.h"
+#include "telemetry_format.h"
+
+// Pin from humidifier_driver.cpp
+#define HUMIDIFIER_PIN 15
+
+static void advance(unsigned long ms) {
+    halNativeAdvanceMillis(ms);
+    updateHumidifierDriver(millis());
+}
+
+void setUp(void) {
+    halNativeClearNvs();
+    halNativeSetMillis(100000);
+    clearActuatorWear();
+    setupHumidifierDriver(humidifierDefaultLimits());
+}
+
+void tearDown(void) {
+}
+
+void test_minimum_on_time_holds_the_output() {
+    requestHumidifier(true, millis());
+    TEST_ASSERT_TRUE(halNativeOutput(HUMIDIFIER_PIN));
+
+    advance(1000);
+    requestHumidifier(false, millis());
+    TEST_ASSERT_TRUE(halNativeOutput(HUMIDIFIER_PIN));
+    TEST_ASSERT_TRUE(isHumidifierRequestHeld());
+
+    advance(HUMIDIFIER_MIN_ON_MS);
+    TEST_ASSERT_FALSE(halNativeOutput(HUMIDIFIER_PIN));
+    TEST_ASSERT_FALSE(isHumidifierRequestHeld());
+}
+
+void test_threshold_flicker_does_not_chatter() {
+    // An emergency path flipping its request every second
+    for (int i = 0; i < 60; i++) {
+        requestHumidifier(i % 2 == 0, millis());
+        advance(1000);
+    }
+    ActuatorWear wear = getActuatorWear(ACTUATOR_HUMIDIFIER, millis());
+    TEST_ASSERT_LESS_OR_EQUAL(60000 / (HUMIDIFIER_MIN_ON_MS + HUMIDIFIER_MIN_OFF_MS) + 1, wear.cycles);
+}
+
+void test_start_rate_is_limited() {
+    SwitchLimits limits = humidifierDefaultLimits();
+    limits.minOnMs = 0;
+    limits.minOffMs = 0;
+    setupHumidifierDriver(limits);
+
+    for (int i = 0; i < 20; i++) {
+        requestHumidifier(true, millis());
+        advance(1000);
+        requestHumidifier(false, millis());
+        advance(1000);
+    }
+    // The burst plus what 40 s of refill allows
+    TEST_ASSERT_EQUAL_UINT32(HUMIDIFIER_START_BURST + 1, getActuatorWear(ACTUATOR_HUMIDIFIER, millis()).cycles);
+    TEST_ASSERT_GREATER_THAN(0UL, getHumidifierDriverStats().rateLimitedStarts);
+}
+
+void test_duty_is_time_proportioned() {
+    // The duty latches at window starts; the first window still has none
+    unsigned long onMs = 0;
+    for (int i = 0; i < 660; i++) {
+        requestHumidifierDuty(0.25f, 60000, millis());
+        if (isHumidifierOutputOn()) onMs += 1000;
+        advance(1000);
+    }
+    TEST_ASSERT_UINT32_WITHIN(10000, 150000, onMs);
+    TEST_ASSERT_UINT32_WITHIN(1, 10, getActuatorWear(ACTUATOR_HUMIDIFIER, millis()).cycles);
+}
+
+void test_wear_counts_on_time_and_survives_reboot() {
+    requestHumidifier(true, millis());
+    advance(90500);
+    requestHumidifier(false, millis());
+
+    ActuatorWear wear = getActuatorWear(ACTUATOR_HUMIDIFIER, millis());
+    TEST_ASSERT_EQUAL_UINT32(1, wear.cycles);
+    TEST_ASSERT_EQUAL_UINT32(90, wear.onSeconds);
+
+    TEST_ASSERT_TRUE(saveActuatorWear(millis()));
+    TEST_ASSERT_TRUE(loadActuatorWear());
+    TEST_ASSERT_EQUAL_UINT32(90, getActuatorWear(ACTUATOR_HUMIDIFIER, millis()).onSeconds);
+}
+
+void test_fans_are_counted() {
+    setupFanDriver();
+    setFanTarget(FAN_INLET, 0.5f);
+    halNativeAdvanceMillis(30000);
+    setFanTarget(FAN_INLET, 0.0f);
+
+    ActuatorWear wear = getActuatorWear(ACTUATOR_INLET_FAN, millis());
+    TEST_ASSERT_EQUAL_UINT32(1, wear.cycles);
+    TEST_ASSERT_EQUAL_UINT32(30, wear.onSeconds);
+    TEST_ASSERT_EQUAL_UINT32(0, getActuatorWear(ACTUATOR_EXHAUST_FAN_1, millis()).cycles);
+}
+
+void test_wear_goes_out_in_telemetry() {
+    requestHumidifier(true, millis());
+    advance(5000);
+
+    TelemetryContext context = deviceTelemetryContext();
+    char json[512];
+    TEST_ASSERT_GREATER_THAN(0, writeBatchJson(json, sizeof(json), context, NULL, 0));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"humidifier\":{\"cycles\":1,\"on_seconds\":5}"));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"inlet_fan\":{\"cycles\":0"));
+
+    // {"v", "id", "rssi", "r", "w", "t"}: six keys, wear as [cycles, onSeconds] pairs
+    uint8_t cbor[256];
+    size_t length = writeBatchCbor(cbor, sizeof(cbor), context, NULL, 0);
+    TEST_ASSERT_GREATER_THAN(0, length);
+    TEST_ASSERT_EQUAL_UINT8(0xA6, cbor[0]);
+    const uint8_t wear[] = { 0x61, 'w', 0x80 + ACTUATOR_COUNT, 0x82, 0x01, 0x05 };
+    bool found = false;
+    for (size_t i = 0; i + sizeof(wear) <= length; i++) {
+        found = found || memcmp(cbor + i, wear, sizeof(wear)) == 0;
+    }
+    TEST_ASSERT_TRUE(found);
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Humidifier Driver Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_minimum_on_time_holds_the_output);
+    RUN_TEST(test_threshold_flicker_does_not_chatter);
+    RUN_TEST(test_start_rate_is_limited);
+    RUN_TEST(test_duty_is_time_proportioned);
+    RUN_TEST(test_wear_counts_on_time_and_survives_reboot);
+    RUN_TEST(test_fans_are_counted);
+    RUN_TEST(test_wear_goes_out_in_telemetry);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
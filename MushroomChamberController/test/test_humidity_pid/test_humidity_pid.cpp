@@ -0,0 +1,95 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "humidity_pid.h"
+#include "actuators.h"
+#include "sim/chamber_sim.h"
+
+static PhaseConfig phaseWithTolerance(float tolerance) {
+  PhaseConfig config = {};
+  config.targetHumidity = 88.0f;
+  config.humidityTolerance = tolerance;
+  return config;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_gains_follow_tolerance() {
+  PidGains wide = pidGainsForPhase(phaseWithTolerance(5.0f));
+  PidGains tight = pidGainsForPhase(phaseWithTolerance(2.5f));
+
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.1f, wide.kp);       // Full duty at 2 tolerances of error
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 2.0f * wide.kp, tight.kp);
+  TEST_ASSERT_FLOAT_WITHIN(0.00001f, wide.kp / HUMIDITY_PID_INTEGRAL_TIME_S, wide.ki);
+}
+
+void test_output_saturates_without_windup() {
+  PidController pid;
+  pidReset(pid, pidGainsForPhase(phaseWithTolerance(5.0f)), 0.0f);
+
+  // Half an hour far below target: output pinned at 100 %
+  for (int i = 0; i < 1800; i++) {
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.0f, pidUpdate(pid, 88.0f, 60.0f, 1.0f));
+  }
+  TEST_ASSERT_LESS_OR_EQUAL(1.0f, pid.integral);
+
+  // A wound-up integrator would keep the humidifier on above target
+  pidUpdate(pid, 88.0f, 95.0f, 1.0f);
+  float duty = pidUpdate(pid, 88.0f, 95.0f, 1.0f);
+  TEST_ASSERT_LESS_THAN(0.5f, duty);
+}
+
+void test_time_proportioned_output() {
+  TimeProportioner window;
+  timeProportionReset(window, 60000, 2000, 0);
+
+  int onSeconds = 0;
+  for (unsigned long t = 60000; t < 120000; t += 1000) {
+    if (timeProportion(window, 0.25f, t)) onSeconds++;
+  }
+  TEST_ASSERT_EQUAL(15, onSeconds);
+
+  // Pulses shorter than the minimum are dropped, nearly-full windows run solid
+  TEST_ASSERT_FALSE(timeProportion(window, 0.01f, 120000));
+  TEST_ASSERT_TRUE(timeProportion(window, 0.99f, 180000));
+  TEST_ASSERT_TRUE(timeProportion(window, 0.99f, 239000));
+}
+
+void test_pid_tracks_better_than_bang_bang() {
+  ChamberSimPhase phases[] = {
+    { INCUBATION, 3 * 86400UL },
+    { FRUITING, 3 * 86400UL }
+  };
+
+  setControlMode(ControlMode::BANG_BANG);
+  ChamberSimKpis bangBang = chamberSimulate(chamberDefaultPlant(), OYSTER, phases, 2);
+  setControlMode(ControlMode::PID);
+  ChamberSimKpis pid = chamberSimulate(chamberDefaultPlant(), OYSTER, phases, 2);
+  printChamberKpis(bangBang);
+  printChamberKpis(pid);
+
+  TEST_ASSERT_LESS_THAN(bangBang.meanAbsError, pid.meanAbsError);
+  TEST_ASSERT_GREATER_OR_EQUAL(bangBang.timeInTolerance, pid.timeInTolerance);
+  TEST_ASSERT_LESS_THAN(bangBang.maxOvershoot + 1.0f, pid.maxOvershoot);
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+
+  Serial.println("\n=== Humidity PID Test Suite ===");
+
+  UNITY_BEGIN();
+  RUN_TEST(test_gains_follow_tolerance);
+  RUN_TEST(test_output_saturates_without_windup);
+  RUN_TEST(test_time_proportioned_output);
+  RUN_TEST(test_pid_tracks_better_than_bang_bang);
+  UNITY_END();
+}
+
+void loop() {
+  delay(1000);
+}
@@ -0,0 +1,204 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "hal/hal.h"
+#include "config.h"
+#include "actuators.h"
+#include "led.h"
+#include "sensor_fusion.h"
+#include "relay_autotune.h"
+#include "temperature_control.h"
+#include "telemetry_format.h"
+
+// Pins from actuators.cpp
+#define HUMIDIFIER_PIN 15
+#define EXHAUST_FAN1_PIN 13
+
+static void keepSensorFresh(float temperature, float humidity) {
+    fusionUpdate(FUSION_SOURCE_BME280, temperature, humidity, millis());
+    fusionEstimate(millis());
+}
+
+static void controlFor(unsigned long ms, float temperature, float humidity) {
+    for (unsigned long t = 0; t < ms; t += 1000) {
+        halNativeAdvanceMillis(1000);
+        keepSensorFresh(temperature, humidity);
+        updateActuators(humidity, temperature, 1013.0f, 1.0f);
+    }
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_config_selects_active_phase() {
+    currentConfig = getMushroomConfig(OYSTER);
+    currentPhase = FRUITING;
+    activePhaseConfig = getActivePhaseConfig();
+
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 88.0f, activePhaseConfig.targetHumidity);
+    TEST_ASSERT_EQUAL(8, activePhaseConfig.lightStartHour);
+}
+
+void test_dry_chamber_is_humidified() {
+    halNativeSetMillis(100000);
+    fusionReset();
+    setupActuators();
+
+    controlFor(3000, 18.0f, 80.0f);
+    TEST_ASSERT_EQUAL(HUMIDIFYING, getControllerState());
+    TEST_ASSERT_TRUE(halNativeOutput(HUMIDIFIER_PIN));
+    TEST_ASSERT_FALSE(halNativeOutput(EXHAUST_FAN1_PIN));
+
+    controlFor(5000, 18.0f, 95.0f);
+    TEST_ASSERT_EQUAL(STABILIZING, getControllerState());
+    TEST_ASSERT_FALSE(halNativeOutput(HUMIDIFIER_PIN));
+}
+
+void test_failed_sensor_runs_fallback_duty() {
+    halNativeAdvanceMillis(SENSOR_STALE_MS + 1000);
+    fusionEstimate(millis());
+    TEST_ASSERT_EQUAL(SensorHealth::FAILED, getFusedHealth());
+
+    updateActuators(NAN, NAN, NAN, 1.0f);
+    TEST_ASSERT_EQUAL(SENSOR_FAULT, getControllerState());
+    TEST_ASSERT_TRUE(halNativeOutput(HUMIDIFIER_PIN));
+
+    controlFor(3000, 18.0f, 88.0f);
+    TEST_ASSERT_EQUAL(STABILIZING, getControllerState());
+}
+
+void test_missing_sensor_from_boot_runs_fallback_duty() {
+    halNativeSetMillis(100000);
+    fusionReset();
+    setupActuators();
+
+    // No estimate was ever made, so nothing reports the sensor as FAILED
+    for (unsigned long t = 0; t < SENSOR_STALE_MS; t += 1000) {
+        halNativeAdvanceMillis(1000);
+        updateActuators(NAN, NAN, NAN, 1.0f);
+    }
+    TEST_ASSERT_EQUAL(SENSOR_FAULT, getControllerState());
+    TEST_ASSERT_TRUE(halNativeOutput(HUMIDIFIER_PIN));
+
+    controlFor(3000, 18.0f, 88.0f);
+    TEST_ASSERT_EQUAL(STABILIZING, getControllerState());
+}
+
+void test_drift_rate_follows_the_step_time() {
+    halNativeSetMillis(100000);
+    fusionReset();
+    setupActuators();
+    controlFor(5000, 18.0f, 95.0f);
+    TEST_ASSERT_EQUAL(STABILIZING, getControllerState());
+
+    // Half-second steps, 0.04 %RH apart: a drift of 0.08 %RH/s
+    float humidity = 95.0f;
+    for (int i = 0; i < 120; i++) {
+        halNativeAdvanceMillis(500);
+        humidity -= 0.04f;
+        keepSensorFresh(18.0f, humidity);
+        updateActuators(humidity, 18.0f, 1013.0f, 0.5f);
+    }
+    TEST_ASSERT_EQUAL(STABILIZING, getControllerState());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.08f, getLearnedParameters().humidityDecayRate);
+
+    // A stalled step's delta is not a rate
+    halNativeAdvanceMillis(30000);
+    updateActuators(humidity - 1.0f, 18.0f, 1013.0f, 30.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.08f, getLearnedParameters().humidityDecayRate);
+}
+
+void test_drift_under_thermal_fans_is_not_learned() {
+    halNativeClearNvs();
+    halNativeSetMillis(100000);
+    fusionReset();
+    setupActuators();
+    controlFor(5000, 18.0f, 95.0f);
+    TEST_ASSERT_EQUAL(STABILIZING, getControllerState());
+
+    // Too warm, so the temperature loop runs the fans and humidity falls faster
+    float humidity = 95.0f;
+    for (int i = 0; i < 60; i++) {
+        halNativeAdvanceMillis(1000);
+        humidity -= 0.1f;
+        keepSensorFresh(22.0f, humidity);
+        updateActuators(humidity, 22.0f, 1013.0f, 1.0f);
+    }
+    TEST_ASSERT_EQUAL(STABILIZING, getControllerState());
+    TEST_ASSERT_TRUE(getTemperatureControlStatus().ventilating);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f, getLearnedParameters().humidityDecayRate);
+}
+
+void test_untuned_phase_drops_the_last_tuning() {
+    AutotuneResult tuning = {};
+    tuning.valid = true;
+    tuning.humidityOvershoot = 1.0f;
+    tuning.ventilationDuration = 45000;
+    setPhaseTuning(FRUITING, tuning);
+
+    halNativeClearNvs();
+    halNativeSetMillis(100000);
+    currentPhase = FRUITING;
+    activePhaseConfig = getActivePhaseConfig();
+    fusionReset();
+    setupActuators();
+    LearnedParameters untuned = getLearnedParameters();
+    controlFor(3000, 18.0f, 88.0f);
+
+    // The next phase was never tuned
+    currentPhase = INCUBATION;
+    activePhaseConfig = getActivePhaseConfig();
+    controlFor(3000, 18.0f, 90.0f);
+    LearnedParameters learned = getLearnedParameters();
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, untuned.humidityOvershoot, learned.humidityOvershoot);
+    TEST_ASSERT_EQUAL_UINT32(untuned.ventilationDuration, learned.ventilationDuration);
+
+    clearPhaseTunings();
+    currentPhase = FRUITING;
+    activePhaseConfig = getActivePhaseConfig();
+}
+
+void test_lighting_follows_schedule() {
+    setupLeds();
+    setManualTime(2025, 3, 1, 9, 0, 0);
+    controlLighting(activePhaseConfig);
+    TEST_ASSERT_TRUE(halNativeShownLed(0) == CRGB(100, 150, 255));
+
+    halNativeAdvanceMillis(4UL * 3600 * 1000);
+    controlLighting(activePhaseConfig);
+    TEST_ASSERT_TRUE(halNativeShownLed(NUM_LEDS - 1) == CRGB(CRGB::Black));
+}
+
+void test_sensor_json_on_host() {
+    halNativeSetNetwork(true, -61);
+    String json = createSensorJson(85.5f, 18.25f, 1013.2f);
+
+    TEST_ASSERT_TRUE(json.indexOf("\"humidity\":85.5") >= 0);
+    TEST_ASSERT_TRUE(json.indexOf("-61") >= 0);
+    TEST_ASSERT_TRUE(json.indexOf(halDeviceId()) >= 0);
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Native Control Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_config_selects_active_phase);
+    RUN_TEST(test_dry_chamber_is_humidified);
+    RUN_TEST(test_failed_sensor_runs_fallback_duty);
+    RUN_TEST(test_missing_sensor_from_boot_runs_fallback_duty);
+    RUN_TEST(test_drift_rate_follows_the_step_time);
+    RUN_TEST(test_drift_under_thermal_fans_is_not_learned);
+    RUN_TEST(test_untuned_phase_drops_the_last_tuning);
+    RUN_TEST(test_lighting_follows_schedule);
+    RUN_TEST(test_sensor_json_on_host);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
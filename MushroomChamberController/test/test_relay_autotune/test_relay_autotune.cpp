@@ -0,0 +1,116 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "hal/hal.h"
+#include "actuators.h"
+#include "relay_autotune.h"
+#include "sim/chamber_sim.h"
+
+#define HOUR_SEC 3600UL
+
+static PhaseConfig fruitingConfig() {
+    PhaseConfig config = {};
+    config.targetHumidity = 88.0f;
+    config.humidityTolerance = 5.0f;
+    return config;
+}
+
+void setUp(void) {
+    clearPhaseTunings();
+}
+
+void tearDown(void) {
+}
+
+// Ideal relay on a pure integrator with dead time gives a triangle wave
+// whose amplitude and period follow from the slopes
+void test_relay_on_synthetic_process() {
+    unsigned long now = 1000;
+    autotuneStart(fruitingConfig(), FRUITING, 13.2f, now);
+
+    float humidity = 88.0f;
+    bool pending[5] = { false, false, false, false, false };   // 5 s dead time
+    while (getAutotuneStage() != AutotuneStage::DONE && now < 4 * HOUR_SEC * 1000) {
+        AutotuneOutput output = autotuneUpdate(humidity, now);
+        bool humidifierOn = pending[0];
+        for (int i = 0; i < 4; i++) pending[i] = pending[i + 1];
+        pending[4] = output.humidifier;
+
+        humidity += humidifierOn ? 0.05f : -0.05f;
+        if (output.fans) humidity -= 0.4f;
+        now += 1000;
+    }
+    TEST_ASSERT_EQUAL(AutotuneStage::DONE, getAutotuneStage());
+
+    // Switching at ±1 %RH overshoots by 5 s × 0.05 %RH/s on each side
+    const AutotuneResult* tuning = getPhaseTuning(FRUITING);
+    TEST_ASSERT_NOT_NULL(tuning);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 1.25f, tuning->amplitude);
+    TEST_ASSERT_FLOAT_WITHIN(4.0f, 100.0f, tuning->ultimatePeriodSec);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 0.25f, tuning->coastOvershoot);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 4.0f * 0.5f / (PI * 0.75f), tuning->ultimateGain);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, tuning->ultimateGain / 3.2f, tuning->pidGains.kp);
+    TEST_ASSERT_EQUAL_UINT32(25000, tuning->outputWindowMs);   // Tu / 4
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 2.25f, tuning->humidityOvershoot);
+    TEST_ASSERT_NULL(getPhaseTuning(INCUBATION));   // Stored per phase
+}
+
+void test_autotune_times_out_without_oscillation() {
+    autotuneStart(fruitingConfig(), FRUITING, 13.2f, 0);
+
+    // A dead humidifier: humidity never reaches the upper switch point
+    for (unsigned long t = 0; t <= AUTOTUNE_MAX_DURATION_MS + 1000; t += 1000) {
+        autotuneUpdate(70.0f, t);
+    }
+    TEST_ASSERT_EQUAL(AutotuneStage::FAILED, getAutotuneStage());
+    TEST_ASSERT_NULL(getPhaseTuning(FRUITING));
+}
+
+void test_autotune_on_chamber_model() {
+    ChamberSimPhase phases[] = { { FRUITING, 6 * HOUR_SEC, true } };
+    chamberSimulate(chamberDefaultPlant(), OYSTER, phases, 1);
+
+    const AutotuneResult* tuning = getPhaseTuning(FRUITING);
+    TEST_ASSERT_NOT_NULL(tuning);
+    printAutotuneStatus();
+
+    TEST_ASSERT_GREATER_THAN(0.0f, tuning->ultimateGain);
+    TEST_ASSERT_GREATER_THAN(10.0f, tuning->ultimatePeriodSec);
+    TEST_ASSERT_GREATER_THAN(0.0f, tuning->pidGains.kp);
+    TEST_ASSERT_LESS_OR_EQUAL(5.0f, tuning->humidityOvershoot);
+
+    // The model loses ~0.4 %RH/s with the fans on at 88 %: 13.2 %RH takes ~30 s
+    TEST_ASSERT_FLOAT_WITHIN(0.15f, 0.4f, tuning->ventilationDropRate);
+    TEST_ASSERT_TRUE(tuning->ventilationDuration >= 15000 && tuning->ventilationDuration <= 60000);
+}
+
+void test_tuned_pid_holds_target() {
+    ChamberSimPhase untuned[] = { { FRUITING, 2 * 86400UL, false } };
+    ChamberSimPhase tuned[] = { { FRUITING, 2 * 86400UL, true } };
+
+    setControlMode(ControlMode::PID);
+    ChamberSimKpis before = chamberSimulate(chamberDefaultPlant(), OYSTER, untuned, 1, 3 * HOUR_SEC);
+    ChamberSimKpis after = chamberSimulate(chamberDefaultPlant(), OYSTER, tuned, 1, 3 * HOUR_SEC);
+    printChamberKpis(before);
+    printChamberKpis(after);
+
+    TEST_ASSERT_GREATER_THAN(0.8f, after.timeInTolerance);
+    TEST_ASSERT_LESS_THAN(before.meanAbsError, after.meanAbsError);
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Relay Autotune Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_relay_on_synthetic_process);
+    RUN_TEST(test_autotune_times_out_without_oscillation);
+    RUN_TEST(test_autotune_on_chamber_model);
+    RUN_TEST(test_tuned_pid_holds_target);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
@@ -0,0 +1,93 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <math.h>
+#include "report_policy.h"
+
+// Tolerances: 2 °C, 5 %RH, 8 hPa -> deadbands 0.5 °C, 1.25 %RH, 2 hPa
+static const PhaseConfig PHASE = { 25.0, 2.0, 70.0, 5.0, 1013.0, 8.0, 0, 0, CRGB::Black, VentilationMode::BALANCED };
+static const PhaseConfig TIGHT_PHASE = { 25.0, 1.0, 70.0, 2.0, 1013.0, 8.0, 0, 0, CRGB::Black, VentilationMode::BALANCED };
+
+static SensorReading reading(float temperature, float humidity, float pressure, unsigned long time) {
+    SensorReading r = { temperature, humidity, pressure, time };
+    return r;
+}
+
+void setUp(void) {
+    resetReportPolicy();
+    setReportDeadbandFraction(REPORT_DEADBAND_FRACTION);
+    setReportHeartbeat(REPORT_HEARTBEAT_MS);
+    setReportThresholds(PHASE);
+}
+
+void tearDown(void) {
+}
+
+void test_first_reading_is_reported() {
+    TEST_ASSERT_EQUAL(ReportReason::FIRST, evaluateReport(reading(25.0, 70.0, 1013.0, 0), STABILIZING));
+}
+
+void test_stable_readings_are_suppressed() {
+    evaluateReport(reading(25.0, 70.0, 1013.0, 0), STABILIZING);
+
+    for (unsigned long t = 2000; t < REPORT_HEARTBEAT_MS; t += 2000) {
+        TEST_ASSERT_EQUAL(ReportReason::NONE, evaluateReport(reading(25.2, 70.5, 1013.5, t), STABILIZING));
+    }
+    TEST_ASSERT_EQUAL_UINT32(29, getReportPolicyStats().suppressed);
+}
+
+void test_heartbeat_after_interval() {
+    evaluateReport(reading(25.0, 70.0, 1013.0, 0), STABILIZING);
+    TEST_ASSERT_EQUAL(ReportReason::HEARTBEAT,
+                      evaluateReport(reading(25.0, 70.0, 1013.0, REPORT_HEARTBEAT_MS), STABILIZING));
+}
+
+void test_value_outside_deadband_is_reported() {
+    evaluateReport(reading(25.0, 70.0, 1013.0, 0), STABILIZING);
+    TEST_ASSERT_EQUAL(ReportReason::CHANGE, evaluateReport(reading(25.0, 71.5, 1013.0, 2000), STABILIZING));
+    TEST_ASSERT_TRUE(isUrgentReport(ReportReason::CHANGE));
+}
+
+void test_slow_drift_is_reported_once_it_adds_up() {
+    evaluateReport(reading(25.0, 70.0, 1013.0, 0), STABILIZING);
+    TEST_ASSERT_EQUAL(ReportReason::NONE, evaluateReport(reading(25.3, 70.0, 1013.0, 2000), STABILIZING));
+    TEST_ASSERT_EQUAL(ReportReason::CHANGE, evaluateReport(reading(25.6, 70.0, 1013.0, 4000), STABILIZING));
+}
+
+void test_state_change_is_reported() {
+    evaluateReport(reading(25.0, 70.0, 1013.0, 0), STABILIZING);
+    TEST_ASSERT_EQUAL(ReportReason::STATE_CHANGE, evaluateReport(reading(25.0, 70.0, 1013.0, 2000), VENTILATING));
+}
+
+void test_tight_phase_has_smaller_deadband() {
+    setReportThresholds(TIGHT_PHASE);
+    evaluateReport(reading(25.0, 70.0, 1013.0, 0), STABILIZING);
+    TEST_ASSERT_EQUAL(ReportReason::CHANGE, evaluateReport(reading(25.0, 70.6, 1013.0, 2000), STABILIZING));
+}
+
+void test_sensor_dropout_is_reported() {
+    evaluateReport(reading(25.0, 70.0, 1013.0, 0), STABILIZING);
+    TEST_ASSERT_EQUAL(ReportReason::CHANGE, evaluateReport(reading(25.0, NAN, 1013.0, 2000), STABILIZING));
+    TEST_ASSERT_EQUAL(ReportReason::NONE, evaluateReport(reading(25.0, NAN, 1013.0, 4000), STABILIZING));
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Report Policy Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_first_reading_is_reported);
+    RUN_TEST(test_stable_readings_are_suppressed);
+    RUN_TEST(test_heartbeat_after_interval);
+    RUN_TEST(test_value_outside_deadband_is_reported);
+    RUN_TEST(test_slow_drift_is_reported_once_it_adds_up);
+    RUN_TEST(test_state_change_is_reported);
+    RUN_TEST(test_tight_phase_has_smaller_deadband);
+    RUN_TEST(test_sensor_dropout_is_reported);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
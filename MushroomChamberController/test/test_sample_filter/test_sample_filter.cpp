@@ -0,0 +1,87 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <math.h>
+#include "sample_filter.h"
+
+static DecimationFilter filter;
+
+void setUp(void) {
+    decimationReset(filter);
+    setDecimationMode(DecimationMode::TRIMMED_MEAN);
+    SensorReading discarded;
+    sampleFilterTake(discarded);
+}
+
+void tearDown(void) {
+}
+
+void test_empty_block_is_nan() {
+    TEST_ASSERT_TRUE(isnan(decimationOutput(filter, DecimationMode::MEAN)));
+    TEST_ASSERT_TRUE(isnan(decimationOutput(filter, DecimationMode::MEDIAN)));
+}
+
+void test_median_rejects_spike() {
+    const float values[] = { 85.0f, 85.2f, 99.9f, 84.8f, 85.1f };
+    for (float value : values) decimationAdd(filter, value);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 85.1f, decimationOutput(filter, DecimationMode::MEDIAN));
+    TEST_ASSERT_TRUE(decimationOutput(filter, DecimationMode::MEAN) > 87.0f);
+}
+
+void test_trimmed_mean_averages_inner_half() {
+    // Ten samples at 10 Hz with one glitch at each end of the range
+    const float values[] = { 70.0f, 85.0f, 85.4f, 84.6f, 85.2f, 84.8f, 85.0f, 85.0f, 100.0f, 85.0f };
+    for (float value : values) decimationAdd(filter, value);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 85.0f, decimationOutput(filter, DecimationMode::TRIMMED_MEAN));
+}
+
+void test_even_median_averages_middle_pair() {
+    const float values[] = { 1.0f, 4.0f, 2.0f, 3.0f };
+    for (float value : values) decimationAdd(filter, value);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 2.5f, decimationOutput(filter, DecimationMode::MEDIAN));
+}
+
+void test_overflow_keeps_newest_samples() {
+    for (int i = 0; i < SAMPLE_FILTER_CAPACITY; i++) decimationAdd(filter, 0.0f);
+    for (int i = 0; i < SAMPLE_FILTER_CAPACITY; i++) decimationAdd(filter, 10.0f);
+
+    TEST_ASSERT_EQUAL(SAMPLE_FILTER_CAPACITY, filter.count);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 10.0f, decimationOutput(filter, DecimationMode::MEAN));
+}
+
+void test_sensor_channels_are_decimated_independently() {
+    for (unsigned long t = 0; t < 10; t++) {
+        SensorReading sample = { 22.0f, t == 5 ? NAN : 80.0f + (t % 2), 1013.0f, 1000 + t * 100 };
+        sampleFilterAdd(sample);
+    }
+    SensorReading failed = { NAN, NAN, NAN, 2000 };
+    sampleFilterAdd(failed);
+
+    SensorReading reading;
+    TEST_ASSERT_TRUE(sampleFilterTake(reading));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 22.0f, reading.temperature);
+    TEST_ASSERT_TRUE(reading.humidity > 80.0f && reading.humidity < 81.0f);
+    TEST_ASSERT_EQUAL_UINT32(1900, reading.timestamp);
+    TEST_ASSERT_FALSE(sampleFilterTake(reading));
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Sample Filter Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_block_is_nan);
+    RUN_TEST(test_median_rejects_spike);
+    RUN_TEST(test_trimmed_mean_averages_inner_half);
+    RUN_TEST(test_even_median_averages_middle_pair);
+    RUN_TEST(test_overflow_keeps_newest_samples);
+    RUN_TEST(test_sensor_channels_are_decimated_independently);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
@@ -0,0 +1,95 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <math.h>
+#include "sensor_fusion.h"
+
+void setUp(void) {
+    fusionReset();
+}
+
+void tearDown(void) {
+}
+
+void test_single_source_is_passed_through() {
+    fusionUpdate(FUSION_SOURCE_BME280, 22.0f, 85.0f, 1000);
+    FusedEstimate fused = fusionEstimate(1000);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 85.0f, fused.humidity);
+    TEST_ASSERT_EQUAL(1, fused.freshSources);
+    // No DHT22 fitted must not count as a failover
+    TEST_ASSERT_EQUAL(SensorHealth::OK, getFusedHealth());
+}
+
+void test_fusion_lowers_variance() {
+    for (unsigned long t = 0; t < 60000; t += 1000) {
+        float noise = (t / 1000) % 2 ? 0.2f : -0.2f;
+        fusionUpdate(FUSION_SOURCE_BME280, 22.0f, 85.0f + noise, t);
+        if (t % 2000 == 0) {
+            fusionUpdate(FUSION_SOURCE_DHT22, 22.0f, 85.0f - noise, t);
+        }
+    }
+
+    FusedEstimate fused = fusionEstimate(59000);
+    TEST_ASSERT_FLOAT_WITHIN(0.15f, 85.0f, fused.humidity);
+    TEST_ASSERT_TRUE(fused.humidityStddev < 0.2f);
+    TEST_ASSERT_EQUAL(2, fused.freshSources);
+}
+
+void test_failover_keeps_level() {
+    // The DHT22 reads 3 %RH high; the bias is learned while both report
+    for (unsigned long t = 0; t <= 60000; t += 2000) {
+        fusionUpdate(FUSION_SOURCE_BME280, 22.0f, 85.0f, t);
+        fusionUpdate(FUSION_SOURCE_DHT22, 22.5f, 88.0f, t);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 3.0f, getFusionBias(FUSION_SOURCE_DHT22, true));
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 85.0f, fusionEstimate(60000).humidity);
+
+    // BME280 drops out; the estimate carries on from the DHT22 without a step
+    for (unsigned long t = 62000; t <= 80000; t += 2000) {
+        fusionUpdate(FUSION_SOURCE_DHT22, 22.5f, 88.0f, t);
+    }
+    FusedEstimate fused = fusionEstimate(80000);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 85.0f, fused.humidity);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 22.0f, fused.temperature);
+    TEST_ASSERT_EQUAL(1, fused.freshSources);
+    TEST_ASSERT_FALSE(isFusionSourceFresh(FUSION_SOURCE_BME280, 80000));
+    TEST_ASSERT_EQUAL(SensorHealth::DEGRADED, getFusedHealth());
+}
+
+void test_no_fresh_source_fails() {
+    fusionUpdate(FUSION_SOURCE_BME280, 22.0f, 85.0f, 0);
+    FusedEstimate fused = fusionEstimate(SENSOR_STALE_MS);
+
+    TEST_ASSERT_TRUE(isnan(fused.humidity));
+    TEST_ASSERT_EQUAL(0, fused.freshSources);
+    TEST_ASSERT_EQUAL(SensorHealth::FAILED, getFusedHealth());
+}
+
+void test_nan_channel_is_skipped() {
+    fusionUpdate(FUSION_SOURCE_BME280, 22.0f, 85.0f, 0);
+    fusionUpdate(FUSION_SOURCE_BME280, 22.0f, NAN, 4000);
+
+    FusedEstimate fused = fusionEstimate(6000);
+    TEST_ASSERT_FALSE(isnan(fused.temperature));
+    TEST_ASSERT_TRUE(isnan(fused.humidity));
+    TEST_ASSERT_EQUAL(SensorHealth::FAILED, getFusedHealth());
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Sensor Fusion Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_single_source_is_passed_through);
+    RUN_TEST(test_fusion_lowers_variance);
+    RUN_TEST(test_failover_keeps_level);
+    RUN_TEST(test_no_fresh_source_fails);
+    RUN_TEST(test_nan_channel_is_skipped);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
@@ -0,0 +1,125 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <math.h>
+#include "hal/hal.h"
+#include "sensors.h"
+
+static SensorReading validated(float temperature, float humidity, float pressure, unsigned long time) {
+    SensorReading sample = { temperature, humidity, pressure, time };
+    validateSample(sample);
+    return sample;
+}
+
+void setUp(void) {
+    resetSensorValidation();
+}
+
+void tearDown(void) {
+}
+
+void test_plausible_samples_are_ok() {
+    for (unsigned long t = 0; t < 1000; t += 100) {
+        SensorReading sample = validated(22.0f, 85.0f, 1013.0f, t);
+        TEST_ASSERT_FLOAT_WITHIN(0.0001f, 85.0f, sample.humidity);
+    }
+    TEST_ASSERT_EQUAL(SensorHealth::OK, getSensorHealth());
+}
+
+void test_out_of_range_is_rejected() {
+    validated(22.0f, 85.0f, 1013.0f, 0);
+    SensorReading sample = validated(150.0f, 85.0f, 1013.0f, 100);
+    TEST_ASSERT_TRUE(isnan(sample.temperature));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 85.0f, sample.humidity);
+    TEST_ASSERT_EQUAL(SensorHealth::DEGRADED, getSensorHealth());
+}
+
+void test_spike_is_rate_limited() {
+    validated(22.0f, 85.0f, 1013.0f, 0);
+    SensorReading sample = validated(22.0f, 40.0f, 1013.0f, 100);
+    TEST_ASSERT_TRUE(isnan(sample.humidity));
+
+    sample = validated(22.0f, 85.5f, 1013.0f, 200);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 85.5f, sample.humidity);
+}
+
+void test_persistent_step_is_accepted() {
+    validated(22.0f, 85.0f, 1013.0f, 0);
+
+    SensorReading sample;
+    for (unsigned long i = 1; i < SENSOR_STEP_ACCEPT; i++) {
+        sample = validated(22.0f, 60.0f, 1013.0f, i * 100);
+        TEST_ASSERT_TRUE(isnan(sample.humidity));
+    }
+    sample = validated(22.0f, 60.0f, 1013.0f, SENSOR_STEP_ACCEPT * 100);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 60.0f, sample.humidity);
+}
+
+void test_scattered_glitches_are_not_a_step() {
+    validated(22.0f, 85.0f, 1013.0f, 0);
+
+    // Far off the last good value, but never twice at the same level
+    const float glitches[] = { 40.0f, 60.0f, 20.0f, 55.0f, 30.0f, 65.0f, 45.0f };
+    for (unsigned long i = 0; i < sizeof(glitches) / sizeof(glitches[0]); i++) {
+        SensorReading sample = validated(22.0f, glitches[i], 1013.0f, (i + 1) * 100);
+        TEST_ASSERT_TRUE(isnan(sample.humidity));
+    }
+}
+
+void test_missing_data_fails_sensor() {
+    validated(22.0f, 85.0f, 1013.0f, 0);
+    for (unsigned long t = 100; t < SENSOR_STALE_MS; t += 100) {
+        validated(NAN, NAN, NAN, t);
+    }
+    TEST_ASSERT_EQUAL(SensorHealth::DEGRADED, getSensorHealth());
+
+    validated(NAN, NAN, NAN, SENSOR_STALE_MS);
+    TEST_ASSERT_EQUAL(SensorHealth::FAILED, getSensorHealth());
+
+    validated(22.0f, 85.0f, 1013.0f, SENSOR_STALE_MS + 100);
+    TEST_ASSERT_EQUAL(SensorHealth::DEGRADED, getSensorHealth());
+    validated(22.0f, 85.0f, 1013.0f, 2 * SENSOR_STALE_MS + 100);
+    TEST_ASSERT_EQUAL(SensorHealth::OK, getSensorHealth());
+}
+
+void test_never_valid_sensor_fails_after_grace() {
+    validated(NAN, NAN, NAN, 10000);
+    TEST_ASSERT_EQUAL(SensorHealth::DEGRADED, getSensorHealth());
+    validated(NAN, NAN, NAN, 10000 + SENSOR_STALE_MS);
+    TEST_ASSERT_EQUAL(SensorHealth::FAILED, getSensorHealth());
+}
+
+void test_backup_rejections_are_counted_separately() {
+    SensorValidationStats before = getSensorValidationStats();
+    SensorValidationStats backupBefore = getBackupSensorValidationStats();
+
+    halNativeSetDhtReading(22.0f, 150.0f);
+    halNativeAdvanceMillis(3000);   // Past the DHT22 conversion interval
+    SensorReading backup;
+    TEST_ASSERT_TRUE(readBackupSensor(backup));
+    TEST_ASSERT_TRUE(isnan(backup.humidity));
+
+    TEST_ASSERT_EQUAL_UINT32(before.outOfRange, getSensorValidationStats().outOfRange);
+    TEST_ASSERT_EQUAL_UINT32(backupBefore.outOfRange + 1, getBackupSensorValidationStats().outOfRange);
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Sensor Validation Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_plausible_samples_are_ok);
+    RUN_TEST(test_out_of_range_is_rejected);
+    RUN_TEST(test_spike_is_rate_limited);
+    RUN_TEST(test_persistent_step_is_accepted);
+    RUN_TEST(test_scattered_glitches_are_not_a_step);
+    RUN_TEST(test_missing_data_fails_sensor);
+    RUN_TEST(test_never_valid_sensor_fails_after_grace);
+    RUN_TEST(test_backup_rejections_are_counted_separately);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
@@ -0,0 +1,134 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <string.h>
+#include "heap_counter.h"
+#include "telemetry_format.h"
+#include "telemetry_spool.h"
+#include "wifi_comm.h"
+
+// Run with the esp32_telemetry_alloc_test environment so malloc is wrapped
+
+const int ITERATIONS = 100;
+
+static char buffer[2048];
+static const TelemetryContext CONTEXT = { "AA:BB:CC:DD:EE:FF", -55 };
+
+void setUp(void) {
+    resetHeapAllocCount();
+}
+
+void tearDown(void) {
+}
+
+void test_counter_is_enabled() {
+    TEST_ASSERT_TRUE_MESSAGE(heapAllocCounterEnabled(),
+                             "Build with -DHEAP_ALLOC_COUNTER and the --wrap linker flags");
+
+    // Sanity check that the wrap actually catches allocations
+    resetHeapAllocCount();
+    void* block = malloc(16);
+    free(block);
+    TEST_ASSERT_EQUAL_UINT32(1, getHeapAllocCount());
+}
+
+void test_sensor_json_output() {
+    size_t length = writeSensorJson(buffer, sizeof(buffer), CONTEXT, 1234, 85.5f, 21.25f, 1013.0f);
+
+    TEST_ASSERT_EQUAL(strlen(buffer), length);
+    TEST_ASSERT_EQUAL_STRING("{\"timestamp\":1234,\"device_id\":\"AA:BB:CC:DD:EE:FF\","
+                             "\"humidity\":85.50,\"temperature\":21.25,\"pressure\":1013.00,"
+                             "\"wifi_rssi\":-55}", buffer);
+}
+
+void test_nan_becomes_null() {
+    writeSensorJson(buffer, sizeof(buffer), CONTEXT, 0, NAN, 21.0f, 1013.0f);
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "\"humidity\":null"));
+}
+
+void test_small_buffer_returns_zero() {
+    char tiny[32];
+    TEST_ASSERT_EQUAL(0, writeSensorJson(tiny, sizeof(tiny), CONTEXT, 0, 85.0f, 21.0f, 1013.0f));
+    TEST_ASSERT_EQUAL_STRING("", tiny);
+}
+
+void test_serialization_does_not_allocate() {
+    SpoolRecord records[SPOOL_BATCH_SIZE];
+    for (int i = 0; i < SPOOL_BATCH_SIZE; i++) {
+        records[i] = { 1700000000u + i, (uint32_t)(i * 2000), 85.0f, 21.0f, 1013.0f };
+    }
+
+    resetHeapAllocCount();
+    for (int i = 0; i < ITERATIONS; i++) {
+        writeSensorJson(buffer, sizeof(buffer), CONTEXT, millis(), 85.0f + i, 21.0f, 1013.0f);
+        writeBatchJson(buffer, sizeof(buffer), CONTEXT, records, SPOOL_BATCH_SIZE);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, getHeapAllocCount());
+}
+
+void test_spool_does_not_allocate() {
+    SensorReading reading = { 21.0f, 85.0f, 1013.0f, 0 };
+    SpoolRecord batch[SPOOL_BATCH_SIZE];
+
+    // Stay inside the RAM ring so LittleFS is not involved
+    resetHeapAllocCount();
+    for (int i = 0; i < ITERATIONS; i++) {
+        reading.timestamp = millis();
+        spoolPush(reading, 0, 0.0f);
+        size_t count = spoolPeek(batch, SPOOL_BATCH_SIZE);
+        spoolConsume(count);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, getHeapAllocCount());
+}
+
+void test_response_parsing_does_not_allocate() {
+    const char* reply = "{\"accepted\":10,\"phase\":\"Fruiting\",\"config_version\":7,"
+                        "\"report_interval_ms\":20000,\"autotune\":true,"
+                        "\"control_mode\":\"PID\",\"ventilation_style\":\"CONTINUOUS\","
+                        "\"ventilation_mode\":\"AUTO\"}";
+    SyncResult result;
+
+    resetHeapAllocCount();
+    for (int i = 0; i < ITERATIONS; i++) {
+        TEST_ASSERT_TRUE(parseSyncResponse(reply, result));
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, getHeapAllocCount());
+
+    TEST_ASSERT_EQUAL(FRUITING, result.phase);
+    TEST_ASSERT_EQUAL_UINT32(7, result.configVersion);
+    TEST_ASSERT_EQUAL_UINT32(20000, result.reportIntervalMs);
+    TEST_ASSERT_TRUE(result.autotune);
+    TEST_ASSERT_TRUE(result.controlMode == ControlMode::PID);
+    TEST_ASSERT_TRUE(result.ventilationStyle == VentilationStyle::CONTINUOUS);
+    TEST_ASSERT_TRUE(result.ventilationMode == VentilationMode::AUTO);
+}
+
+void test_invalid_response_rejected() {
+    SyncResult result;
+    GrowthPhase phase = PRIMORDIA_FORMATION;
+
+    TEST_ASSERT_FALSE(parseSyncResponse("not json", result));
+    TEST_ASSERT_FALSE(parsePhaseResponse("{\"other\":1}", phase));
+    TEST_ASSERT_EQUAL(PRIMORDIA_FORMATION, phase);
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Telemetry Allocation Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_counter_is_enabled);
+    RUN_TEST(test_sensor_json_output);
+    RUN_TEST(test_nan_becomes_null);
+    RUN_TEST(test_small_buffer_returns_zero);
+    RUN_TEST(test_serialization_does_not_allocate);
+    RUN_TEST(test_spool_does_not_allocate);
+    RUN_TEST(test_response_parsing_does_not_allocate);
+    RUN_TEST(test_invalid_response_rejected);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
@@ -0,0 +1,99 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <string.h>
+#include "telemetry_format.h"
+
+// The same batch is decoded by backend/cbor.test.js; keep the two in step
+static const uint8_t EXPECTED_BATCH[] = {
+    0xA5,                                           // map(5)
+    0x61, 'v', 0x01,
+    0x62, 'i', 'd', 0x64, 'd', 'e', 'v', '1',
+    0x64, 'r', 's', 's', 'i', 0x38, 0x3B,           // -60
+    0x61, 'r', 0x81, 0x87,                          // one reading of 7 fields
+    0x1A, 0x65, 0x53, 0xF1, 0x00,                   // epoch 1700000000
+    0x1A, 0x00, 0x01, 0xE2, 0x40,                   // uptime 123456 ms
+    0xFA, 0x42, 0xAA, 0x80, 0x00,                   // humidity 85.25
+    0xFA, 0x41, 0xAA, 0x66, 0x66,                   // temperature 21.3 as float32
+    0xF6,                                           // pressure NaN -> null
+    0x05, 0x18, 0x28,                               // flags, fan 40 %
+    0x61, 's', 0x81, 0x93,                          // one summary of 19 fields
+    0x1A, 0x65, 0x53, 0xF1, 0x00,
+    0x19, 0xEA, 0x60,                               // uptime 60000 ms
+    0x19, 0xEA, 0x60,                               // duration 60000 ms
+    0x18, 0x3C,                                     // 60 samples
+    0xFA, 0x42, 0xA9, 0x00, 0x00, 0xFA, 0x42, 0xAC, 0x00, 0x00,   // humidity 84.5..86
+    0xFA, 0x42, 0xAA, 0x80, 0x00, 0xFA, 0x3F, 0x00, 0x00, 0x00,   // mean 85.25, stddev 0.5
+    0xFA, 0x41, 0xAA, 0x66, 0x66, 0xFA, 0x41, 0xAA, 0x66, 0x66,   // temperature 21.3
+    0xFA, 0x41, 0xAA, 0x66, 0x66, 0xFA, 0x00, 0x00, 0x00, 0x00,
+    0xF6, 0xF6, 0xF6, 0xF6,                         // no pressure samples
+    0x18, 0x19, 0x18, 0x32, 0x0A                    // duty 25/50/10 %
+};
+
+static SpoolRecord sampleRecord() {
+    SpoolRecord record = {};
+    record.epoch = 1700000000;
+    record.uptimeMs = 123456;
+    record.humidity = 85.25f;
+    record.temperature = 21.3f;
+    record.pressure = NAN;
+    record.actuatorFlags = 0x05;
+    record.fanSpeedPct = 40;
+    return record;
+}
+
+static WindowSummary sampleSummary() {
+    WindowSummary summary = {};
+    summary.epoch = 1700000000;
+    summary.uptimeMs = 60000;
+    summary.durationMs = 60000;
+    summary.samples = 60;
+    summary.humidity = { 84.5f, 86.0f, 85.25f, 0.5f };
+    summary.temperature = { 21.3f, 21.3f, 21.3f, 0.0f };
+    summary.pressure = { NAN, NAN, NAN, NAN };
+    summary.humidifierDutyPct = 25;
+    summary.fanDutyPct = 50;
+    summary.ventilationDutyPct = 10;
+    return summary;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_batch_byte_layout() {
+    TelemetryContext context = { "dev1", -60, NULL, NULL };
+    SpoolRecord record = sampleRecord();
+    WindowSummary summary = sampleSummary();
+
+    uint8_t cbor[256];
+    size_t length = writeBatchCbor(cbor, sizeof(cbor), context, &record, 1, &summary, 1);
+    TEST_ASSERT_EQUAL(sizeof(EXPECTED_BATCH), length);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(EXPECTED_BATCH, cbor, sizeof(EXPECTED_BATCH));
+}
+
+void test_short_buffer_writes_nothing() {
+    TelemetryContext context = { "dev1", -60, NULL, NULL };
+    SpoolRecord record = sampleRecord();
+    WindowSummary summary = sampleSummary();
+
+    uint8_t cbor[sizeof(EXPECTED_BATCH) - 1];
+    TEST_ASSERT_EQUAL(0, writeBatchCbor(cbor, sizeof(cbor), context, &record, 1, &summary, 1));
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Telemetry Format Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_batch_byte_layout);
+    RUN_TEST(test_short_buffer_writes_nothing);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
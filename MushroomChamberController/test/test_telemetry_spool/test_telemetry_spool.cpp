@@ -0,0 +1,146 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "telemetry_spool.h"
+
+// Readings carry their push order in the humidity field, summaries in
+// their sample count
+static unsigned long pushed = 0;
+static uint16_t summariesPushed = 0;
+
+static void push(size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        SensorReading reading = { 20.0f, (float)pushed, 1013.0f, 1000 + pushed * 2000 };
+        spoolPush(reading, 0, 0.0f);
+        pushed++;
+    }
+}
+
+static void pushSummaries(size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        WindowSummary summary = {};
+        summary.samples = summariesPushed++;
+        spoolPushSummary(summary);
+    }
+}
+
+// Uploads everything left, checking that each reading arrives once and in order
+static void assertDrainsInOrder(unsigned long first) {
+    SpoolRecord batch[SPOOL_BATCH_SIZE];
+    unsigned long expected = first;
+    size_t count;
+    while ((count = spoolPeek(batch, SPOOL_BATCH_SIZE)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            TEST_ASSERT_FLOAT_WITHIN(0.001f, (float)expected, batch[i].humidity);
+            expected++;
+        }
+        spoolConsume(count);
+    }
+    TEST_ASSERT_EQUAL_UINT32(pushed, expected);
+    TEST_ASSERT_EQUAL(0, spoolSize());
+}
+
+void setUp(void) {
+    SpoolRecord batch[SPOOL_BATCH_SIZE];
+    size_t count;
+    while ((count = spoolPeek(batch, SPOOL_BATCH_SIZE)) > 0) {
+        spoolConsume(count);
+    }
+    WindowSummary summaries[SUMMARY_BATCH_SIZE];
+    while ((count = spoolPeekSummaries(summaries, SUMMARY_BATCH_SIZE)) > 0) {
+        spoolConsumeSummaries(count);
+    }
+    LittleFS.format();
+    setupSpool();
+    pushed = 0;
+    summariesPushed = 0;
+}
+
+void tearDown(void) {
+}
+
+void test_overflow_moves_the_oldest_to_flash() {
+    push(SPOOL_RAM_CAPACITY + 1);
+    SpoolStats stats = getSpoolStats();
+    TEST_ASSERT_EQUAL(SPOOL_OVERFLOW_CHUNK, stats.flashRecords);
+    TEST_ASSERT_EQUAL(SPOOL_RAM_CAPACITY + 1 - SPOOL_OVERFLOW_CHUNK, stats.ramRecords);
+    assertDrainsInOrder(0);
+}
+
+void test_overflow_between_peek_and_consume() {
+    push(SPOOL_RAM_CAPACITY);
+    SpoolRecord batch[SPOOL_BATCH_SIZE];
+    TEST_ASSERT_EQUAL(SPOOL_BATCH_SIZE, spoolPeek(batch, SPOOL_BATCH_SIZE));
+
+    // The ring fills up while the batch is being uploaded
+    push(1);
+    TEST_ASSERT_EQUAL(SPOOL_OVERFLOW_CHUNK, getSpoolStats().flashRecords);
+    spoolConsume(SPOOL_BATCH_SIZE);
+
+    assertDrainsInOrder(SPOOL_BATCH_SIZE);
+}
+
+void test_failed_upload_is_retried_first() {
+    push(SPOOL_RAM_CAPACITY);
+    SpoolRecord batch[SPOOL_BATCH_SIZE];
+    spoolPeek(batch, SPOOL_BATCH_SIZE);
+    push(1);
+
+    // No consume: the pinned readings are still the oldest
+    TEST_ASSERT_EQUAL(SPOOL_BATCH_SIZE, spoolPeek(batch, SPOOL_BATCH_SIZE));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, batch[0].humidity);
+    assertDrainsInOrder(0);
+}
+
+void test_flash_batch_in_flight_during_overflow() {
+    push(SPOOL_RAM_CAPACITY + 1);
+    SpoolRecord batch[SPOOL_BATCH_SIZE];
+    TEST_ASSERT_EQUAL(SPOOL_BATCH_SIZE, spoolPeek(batch, SPOOL_BATCH_SIZE));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, batch[0].humidity);
+
+    push(SPOOL_OVERFLOW_CHUNK);
+    spoolConsume(SPOOL_BATCH_SIZE);
+    assertDrainsInOrder(SPOOL_BATCH_SIZE);
+}
+
+void test_summaries_spill_to_flash_and_keep_their_order() {
+    pushSummaries(9);
+    SpoolStats stats = getSpoolStats();
+    TEST_ASSERT_EQUAL(9, stats.ramSummaries + stats.flashSummaries);
+    TEST_ASSERT_GREATER_OR_EQUAL(9 - SPOOL_SUMMARY_RAM_CAPACITY, stats.flashSummaries);
+
+    // A window closes while a batch from RAM is in flight
+    WindowSummary batch[SUMMARY_BATCH_SIZE];
+    uint16_t expected = 0;
+    size_t count;
+    while ((count = spoolPeekSummaries(batch, SUMMARY_BATCH_SIZE)) > 0) {
+        if (summariesPushed < 20) {
+            pushSummaries(1);
+        }
+        for (size_t i = 0; i < count; i++) {
+            TEST_ASSERT_EQUAL_UINT32(expected++, batch[i].samples);
+        }
+        spoolConsumeSummaries(count);
+    }
+    TEST_ASSERT_EQUAL_UINT32(summariesPushed, expected);
+    TEST_ASSERT_EQUAL(0, getSpoolStats().droppedSummaries);
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Telemetry Spool Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_overflow_moves_the_oldest_to_flash);
+    RUN_TEST(test_overflow_between_peek_and_consume);
+    RUN_TEST(test_failed_upload_is_retried_first);
+    RUN_TEST(test_flash_batch_in_flight_during_overflow);
+    RUN_TEST(test_summaries_spill_to_flash_and_keep_their_order);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
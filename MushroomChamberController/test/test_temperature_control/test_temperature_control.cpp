@@ -0,0 +1,217 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "hal/hal.h"
+#include "config.h"
+#include "actuator_wear.h"
+#include "controller_store.h"
+#include "temperature_control.h"
+#include "thermal_outputs.h"
+#include "sim/chamber_sim.h"
+
+#define DAY_SEC 86400UL
+
+// Shiitake primordia: 15 ± 2 °C, 92 ± 5 %RH
+static PhaseConfig primordia;
+static unsigned long now;
+
+static ThermalDemand step(float temperature, float humidity, bool canHeat = false, bool canCool = false) {
+    now += 1000;
+    return temperatureControlUpdate(primordia, temperature, humidity, canHeat, canCool, true, now, 1.0f);
+}
+
+void setUp(void) {
+    primordia = getMushroomConfig(SHIITAKE).primordiaFormation;
+    now = 1000000;
+    temperatureControlReset();
+    halNativeClearNvs();
+}
+
+void tearDown(void) {
+    setThermalOutputs(false, false);
+}
+
+void test_demand_splits_between_heater_and_cooler() {
+    ThermalDemand demand = step(11.0f, 92.0f, true, true);
+    TEST_ASSERT_GREATER_THAN(0.5f, demand.heating);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, demand.cooling);
+
+    temperatureControlReset();
+    demand = step(19.0f, 92.0f, true, true);
+    TEST_ASSERT_GREATER_THAN(0.5f, demand.cooling);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, demand.heating);
+
+    // Inside the deadband only the integral is left
+    temperatureControlReset();
+    demand = step(15.2f, 92.0f, true, true);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, demand.heating + demand.cooling);
+}
+
+void test_integral_does_not_wind_up_without_a_stage() {
+    // A cold chamber with only a cooler fitted, for hours
+    for (int i = 0; i < 4 * 3600; i++) {
+        step(12.0f, 92.0f, false, true);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, getTemperatureControlStatus().integral);
+
+    // So the cooler reacts as soon as the chamber turns warm
+    ThermalDemand demand = step(19.0f, 92.0f, false, true);
+    TEST_ASSERT_GREATER_THAN(0.5f, demand.cooling);
+}
+
+void test_ventilation_waits_for_the_band_and_for_humidity() {
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, step(16.5f, 92.0f).ventilation);   // Warm, but in band
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, step(19.0f, 92.0f).ventilation);
+
+    // Two tolerances short of humidity outweigh two of temperature
+    temperatureControlReset();
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, step(19.0f, 82.0f).ventilation);
+    TEST_ASSERT_GREATER_THAN(getTemperatureControlStatus().temperatureScore,
+                             getTemperatureControlStatus().humidityScore);
+}
+
+void test_trial_that_reaches_the_band_succeeds() {
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, step(19.0f, 92.0f).ventilation);
+    for (int i = 0; i < 60; i++) {
+        step(19.0f - i * 0.06f, 92.0f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, step(15.3f, 92.0f).ventilation);
+    TEST_ASSERT_FALSE(getTemperatureControlStatus().ambientKnown);
+    TEST_ASSERT_EQUAL_UINT8(0, getTemperatureControlStatus().uselessInRow);
+}
+
+void test_useless_trial_learns_the_outside_air() {
+    // The fans run but the chamber stays at 19.8 °C: that is the outside air
+    step(20.0f, 92.0f);
+    for (int i = 0; i < 400; i++) {
+        step(19.8f, 92.0f);
+    }
+    TemperatureControlStatus status = getTemperatureControlStatus();
+    TEST_ASSERT_FALSE(status.ventilating);
+    TEST_ASSERT_TRUE(status.ambientKnown);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 19.8f, status.ambientEstimate);
+    TEST_ASSERT_EQUAL_UINT8(1, status.uselessInRow);
+
+    // Nothing to win within a tolerance of it
+    for (int i = 0; i < 3600; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, step(21.0f, 92.0f).ventilation);
+    }
+    // Once the chamber is well clear of it, the fans are worth it again
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, step(23.0f, 92.0f).ventilation);
+}
+
+void test_useless_trials_back_off() {
+    for (int trial = 0; trial < 3; trial++) {
+        unsigned long start = now;
+        while (!getTemperatureControlStatus().ventilating && now - start < 2 * DAY_SEC * 1000UL) {
+            step(20.0f, 92.0f);
+        }
+        TEST_ASSERT_TRUE(getTemperatureControlStatus().ventilating);
+        for (int i = 0; i < 400; i++) {
+            step(20.0f, 92.0f);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT8(3, getTemperatureControlStatus().uselessInRow);
+
+    // The third estimate is trusted for 8 h
+    for (unsigned long i = 0; i < 7 * 3600UL; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, step(20.0f, 92.0f).ventilation);
+    }
+}
+
+void test_wear_from_older_firmware_still_loads() {
+    // Layout before the heater and cooler were added: four counters
+    struct {
+        uint16_t version;
+        uint16_t payloadSize;
+        ActuatorWear wear[4];
+        uint32_t crc;
+    } old = {};
+    old.version = ACTUATOR_WEAR_VERSION;
+    old.payloadSize = offsetof(decltype(old), crc);
+    old.wear[0].cycles = 1234;
+    old.wear[3].onSeconds = 5678;
+    old.crc = crc32((const uint8_t*)&old, old.payloadSize);
+
+    clearActuatorWear();
+    halNvsWrite(ACTUATOR_WEAR_KEY, &old, sizeof(old));
+    TEST_ASSERT_TRUE(loadActuatorWear());
+    TEST_ASSERT_EQUAL_UINT32(1234, getActuatorWear(ACTUATOR_HUMIDIFIER, millis()).cycles);
+    TEST_ASSERT_EQUAL_UINT32(5678, getActuatorWear(ACTUATOR_INLET_FAN, millis()).onSeconds);
+    TEST_ASSERT_EQUAL_UINT32(0, getActuatorWear(ACTUATOR_COOLER, millis()).cycles);
+}
+
+void test_thermal_outputs_need_installing() {
+    setThermalOutputs(false, true);
+    setupThermalOutputs();
+
+    // Duties latch at the start of the next window
+    unsigned long t = millis() + max(HEATER_WINDOW_MS, COOLER_WINDOW_MS);
+    requestHeaterDuty(1.0f, t);
+    requestCoolerDuty(1.0f, t);
+    TEST_ASSERT_FALSE(isHeaterOn());
+    TEST_ASSERT_TRUE(isCoolerOn());
+}
+
+void test_cool_outside_air_holds_shiitake_primordia() {
+    // LEDs and metabolism hold the chamber 12 °C above a 10 °C garage
+    ChamberPlant plant = chamberDefaultPlant();
+    plant.ambientTemperature = 10.0f;
+    plant.heatGain = 0.006f;
+
+    ChamberSimPhase phases[] = { { PRIMORDIA_FORMATION, 2 * DAY_SEC } };
+    ChamberSimKpis kpis = chamberSimulate(plant, SHIITAKE, phases, 1);
+    printChamberKpis(kpis);
+
+    TEST_ASSERT_GREATER_THAN(0.9f, kpis.temperatureInTolerance);   // 22 °C uncontrolled
+    TEST_ASSERT_GREATER_THAN(0.75f, kpis.timeInTolerance);
+}
+
+void test_cooler_gives_temperature_shock_in_a_warm_room() {
+    // Fresh air from a 20 °C room cannot reach 15 °C; a cooler can
+    ChamberPlant plant = chamberDefaultPlant();
+    plant.coolerGain = 0.005f;
+
+    ChamberSimPhase phases[] = { { PRIMORDIA_FORMATION, 2 * DAY_SEC } };
+    ChamberSimKpis kpis = chamberSimulate(plant, SHIITAKE, phases, 1);
+    printChamberKpis(kpis);
+
+    TEST_ASSERT_GREATER_THAN(0.9f, kpis.temperatureInTolerance);
+    TEST_ASSERT_GREATER_THAN(0.8f, kpis.timeInTolerance);
+    TEST_ASSERT_GREATER_THAN(0UL, kpis.coolerOnSec);
+    TEST_ASSERT_EQUAL_UINT32(0, kpis.heaterOnSec);
+}
+
+void test_warm_room_without_stages_leaves_humidity_alone() {
+    ChamberSimPhase phases[] = { { PRIMORDIA_FORMATION, 2 * DAY_SEC } };
+    ChamberSimKpis kpis = chamberSimulate(chamberDefaultPlant(), SHIITAKE, phases, 1);
+    printChamberKpis(kpis);
+
+    TEST_ASSERT_LESS_THAN(0.1f, kpis.temperatureInTolerance);     // Nothing can cool it
+    TEST_ASSERT_GREATER_THAN(0.8f, kpis.timeInTolerance);
+    TEST_ASSERT_GREATER_THAN(0UL, getTemperatureControlStatus().uselessInRow);
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Temperature Control Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_demand_splits_between_heater_and_cooler);
+    RUN_TEST(test_integral_does_not_wind_up_without_a_stage);
+    RUN_TEST(test_ventilation_waits_for_the_band_and_for_humidity);
+    RUN_TEST(test_trial_that_reaches_the_band_succeeds);
+    RUN_TEST(test_useless_trial_learns_the_outside_air);
+    RUN_TEST(test_useless_trials_back_off);
+    RUN_TEST(test_wear_from_older_firmware_still_loads);
+    RUN_TEST(test_thermal_outputs_need_installing);
+    RUN_TEST(test_cool_outside_air_holds_shiitake_primordia);
+    RUN_TEST(test_cooler_gives_temperature_shock_in_a_warm_room);
+    RUN_TEST(test_warm_room_without_stages_leaves_humidity_alone);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
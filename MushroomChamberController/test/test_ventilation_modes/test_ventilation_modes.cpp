@@ -0,0 +1,151 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "hal/hal.h"
+#include "actuators.h"
+#include "config.h"
+#include "controller_store.h"
+#include "relay_autotune.h"
+#include "ventilation_modes.h"
+#include "sim/chamber_sim.h"
+
+#define DAY_SEC 86400UL
+
+void setUp(void) {
+    halNativeClearNvs();
+    clearPhaseTunings();
+    clearVentilationModeStats();
+}
+
+void tearDown(void) {
+}
+
+void test_modes_drive_their_fans() {
+    float duties[FAN_COUNT];
+
+    ventilationFanDuties(VentilationMode::EXHAUST_ONLY, 1.0f, duties);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, duties[FAN_EXHAUST_1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, duties[FAN_EXHAUST_2]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, duties[FAN_INLET]);
+
+    ventilationFanDuties(VentilationMode::INLET_ONLY, 0.5f, duties);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, duties[FAN_EXHAUST_1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.5f, duties[FAN_INLET]);
+
+    ventilationFanDuties(VentilationMode::CIRCULATION, 1.0f, duties);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, FAN_MIN_RUNNING_DUTY, duties[FAN_EXHAUST_2]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, FAN_MIN_RUNNING_DUTY, duties[FAN_INLET]);
+}
+
+void test_durations_move_the_same_volume() {
+    TEST_ASSERT_EQUAL_UINT32(30000, ventilationDurationFor(VentilationMode::BALANCED, 30000));
+    TEST_ASSERT_EQUAL_UINT32(45000, ventilationDurationFor(VentilationMode::EXHAUST_ONLY, 30000));
+    TEST_ASSERT_EQUAL_UINT32(90000, ventilationDurationFor(VentilationMode::INLET_ONLY, 30000));
+    TEST_ASSERT_EQUAL_UINT32(30000, ventilationDurationFor(VentilationMode::CIRCULATION, 30000));
+}
+
+void test_configured_mode_wins_over_learning() {
+    TEST_ASSERT_EQUAL(VentilationMode::CIRCULATION, selectVentilationMode(INCUBATION, VentilationMode::CIRCULATION));
+    TEST_ASSERT_EQUAL(VentilationMode::BALANCED, selectVentilationMode(INCUBATION, VentilationMode::AUTO));
+}
+
+void test_auto_explores_then_picks_the_most_exchange() {
+    // Same rated volume each time: EXHAUST_ONLY dries the chamber the most,
+    // so its fans move the most real air
+    for (int i = 0; i < 2 * VENTILATION_EXCHANGE_MODES; i++) {
+        VentilationMode mode = selectVentilationMode(FRUITING, VentilationMode::AUTO);
+        unsigned long durationMs = ventilationDurationFor(mode, 30000);
+        float drop = mode == VentilationMode::INLET_ONLY ? 6.0f : mode == VentilationMode::EXHAUST_ONLY ? 10.0f : 9.0f;
+        recordVentilation(FRUITING, mode, drop, 12.0f, durationMs);
+    }
+
+    VentilationModeStats stats = getVentilationModeStats(FRUITING);
+    TEST_ASSERT_EQUAL(6, stats.ventilations);
+    TEST_ASSERT_EQUAL(VentilationMode::EXHAUST_ONLY, selectVentilationMode(FRUITING, VentilationMode::AUTO));
+    TEST_ASSERT_EQUAL(VentilationMode::BALANCED, selectVentilationMode(INCUBATION, VentilationMode::AUTO));
+
+    // BALANCED would have dropped 9 where EXHAUST_ONLY dropped 10
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 9.0f, balancedEquivalentDrop(FRUITING, VentilationMode::EXHAUST_ONLY, 10.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 9.0f, balancedEquivalentDrop(FRUITING, VentilationMode::BALANCED, 9.0f));
+}
+
+void test_mode_that_barely_dries_scores_badly() {
+    // A sealed-off inlet: no humidity lost, and no air changed either
+    recordVentilation(FRUITING, VentilationMode::INLET_ONLY, 0.0f, 12.0f, 90000);
+    recordVentilation(FRUITING, VentilationMode::BALANCED, 12.0f, 12.0f, 30000);
+
+    VentilationModeStats stats = getVentilationModeStats(FRUITING);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 30.0f, stats.volumePerExchange[2]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 30.0f / VENTILATION_MIN_DROP_SHARE, stats.volumePerExchange[1]);
+}
+
+void test_scores_survive_a_reboot() {
+    recordVentilation(PRIMORDIA_FORMATION, VentilationMode::EXHAUST_ONLY, 8.0f, 16.0f, 45000);
+    TEST_ASSERT_TRUE(saveControllerCheckpoint(getLearnedParameters(), 0));
+    clearVentilationModeStats();
+
+    LearnedParameters loaded;
+    TEST_ASSERT_TRUE(loadControllerCheckpoint(loaded));
+    VentilationModeStats stats = getVentilationModeStats(PRIMORDIA_FORMATION);
+    TEST_ASSERT_EQUAL(1, stats.ventilations);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 60.0f, stats.volumePerExchange[0]);
+}
+
+void test_phases_ventilate_balanced_unless_they_opt_in() {
+    MushroomConfig config = getMushroomConfig(OYSTER);
+    TEST_ASSERT_EQUAL(VentilationMode::BALANCED, config.incubation.ventilationMode);
+    TEST_ASSERT_EQUAL(VentilationMode::BALANCED, config.primordiaFormation.ventilationMode);
+    TEST_ASSERT_EQUAL(VentilationMode::BALANCED, config.fruiting.ventilationMode);
+}
+
+void test_server_mode_names() {
+    TEST_ASSERT_TRUE(stringToVentilationMode("AUTO") == VentilationMode::AUTO);
+    TEST_ASSERT_TRUE(stringToVentilationMode("EXHAUST_ONLY") == VentilationMode::EXHAUST_ONLY);
+    TEST_ASSERT_TRUE(stringToVentilationMode("INLET_ONLY") == VentilationMode::INLET_ONLY);
+    // Not an exchange mode, so not something a phase can ventilate with
+    TEST_ASSERT_TRUE(stringToVentilationMode("CIRCULATION") == VentilationMode::BALANCED);
+    TEST_ASSERT_TRUE(stringToVentilationMode("bogus") == VentilationMode::BALANCED);
+}
+
+void test_chamber_learns_its_best_mode() {
+    // The inlet duct is restricted: per rated volume the inlet fan moves far
+    // less air than the exhaust fans, so it changes the air far slower
+    ChamberPlant plant = chamberDefaultPlant();
+    plant.fanAirflow[FAN_EXHAUST_1] = 0.4f;
+    plant.fanAirflow[FAN_EXHAUST_2] = 0.4f;
+    plant.fanAirflow[FAN_INLET] = 0.1f;
+
+    ChamberSimPhase phases[] = { { FRUITING, DAY_SEC, false, true } };
+    ChamberSimKpis kpis = chamberSimulate(plant, OYSTER, phases, 1);
+    printChamberKpis(kpis);
+    printVentilationModeStatus();
+
+    VentilationModeStats stats = getVentilationModeStats(FRUITING);
+    TEST_ASSERT_GREATER_THAN(50, stats.ventilations);
+    TEST_ASSERT_EQUAL(VentilationMode::EXHAUST_ONLY, selectVentilationMode(FRUITING, VentilationMode::AUTO));
+    TEST_ASSERT_GREATER_THAN(stats.samples[1], stats.samples[0]);   // EXHAUST_ONLY ran the most
+    TEST_ASSERT_GREATER_THAN(stats.samples[2], stats.samples[0]);
+    TEST_ASSERT_GREATER_THAN(0.7f, kpis.timeInTolerance);
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Ventilation Mode Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_modes_drive_their_fans);
+    RUN_TEST(test_durations_move_the_same_volume);
+    RUN_TEST(test_configured_mode_wins_over_learning);
+    RUN_TEST(test_auto_explores_then_picks_the_most_exchange);
+    RUN_TEST(test_mode_that_barely_dries_scores_badly);
+    RUN_TEST(test_scores_survive_a_reboot);
+    RUN_TEST(test_phases_ventilate_balanced_unless_they_opt_in);
+    RUN_TEST(test_server_mode_names);
+    RUN_TEST(test_chamber_learns_its_best_mode);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
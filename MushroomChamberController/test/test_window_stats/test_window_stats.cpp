@@ -0,0 +1,98 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <math.h>
+#include "window_stats.h"
+#include "actuators.h"
+
+void setUp(void) {
+    summaryConsume(summaryCount());
+    setSummaryWindow(SUMMARY_WINDOW_MS);
+}
+
+void tearDown(void) {
+}
+
+void test_running_stats_moments() {
+    RunningStats stats;
+    runningStatsReset(stats);
+
+    const float values[] = { 2, 4, 4, 4, 5, 5, 7, 9 };
+    for (float value : values) {
+        runningStatsAdd(stats, value);
+    }
+
+    FieldSummary summary = runningStatsSummary(stats);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 2.0f, summary.min);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 9.0f, summary.max);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 5.0f, summary.mean);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 2.0f, summary.stddev);
+}
+
+void test_running_stats_ignore_nan() {
+    RunningStats stats;
+    runningStatsReset(stats);
+    runningStatsAdd(stats, NAN);
+    TEST_ASSERT_TRUE(isnan(runningStatsSummary(stats).mean));
+
+    runningStatsAdd(stats, 80.0f);
+    runningStatsAdd(stats, NAN);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.count);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 80.0f, runningStatsSummary(stats).mean);
+}
+
+void test_large_offset_stays_accurate() {
+    // Pressure sits around 1013 hPa with tiny variation
+    RunningStats stats;
+    runningStatsReset(stats);
+    for (int i = 0; i < 1000; i++) {
+        runningStatsAdd(stats, 1013.0f + ((i % 2) ? 0.1f : -0.1f));
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.1f, runningStatsSummary(stats).stddev);
+}
+
+void test_window_keeps_extremes_and_duty() {
+    // 2 s samples, one brief dip, humidifier on for the first half
+    for (unsigned long t = 0; t <= SUMMARY_WINDOW_MS; t += 2000) {
+        SensorReading reading = { 20.0f, t == 30000 ? 60.0f : 85.0f, 1013.0f, 1000000 + t };
+        windowStatsAdd(reading, t < 30000 ? ACTUATOR_FLAG_HUMIDIFIER : 0);
+    }
+
+    WindowSummary summary;
+    TEST_ASSERT_EQUAL(1, summaryPeek(&summary, 1));
+    TEST_ASSERT_EQUAL(30, summary.samples);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 60.0f, summary.humidity.min);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 85.0f, summary.humidity.max);
+    TEST_ASSERT_EQUAL(50, summary.humidifierDutyPct);
+    TEST_ASSERT_EQUAL(0, summary.fanDutyPct);
+}
+
+void test_summary_queue_drops_oldest() {
+    setSummaryWindow(1000);
+    for (unsigned long i = 0; i <= SUMMARY_QUEUE_CAPACITY + 5; i++) {
+        SensorReading reading = { 20.0f, 85.0f, 1013.0f, 2000000 + i * 1000 };
+        windowStatsAdd(reading, 0);
+    }
+    TEST_ASSERT_EQUAL(SUMMARY_QUEUE_CAPACITY, summaryCount());
+
+    summaryConsume(SUMMARY_QUEUE_CAPACITY - 1);
+    TEST_ASSERT_EQUAL(1, summaryCount());
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Serial.println("\n=== Window Statistics Test Suite ===");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_running_stats_moments);
+    RUN_TEST(test_running_stats_ignore_nan);
+    RUN_TEST(test_large_offset_stays_accurate);
+    RUN_TEST(test_window_keeps_extremes_and_duty);
+    RUN_TEST(test_summary_queue_drops_oldest);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
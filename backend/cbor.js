@@ -0,0 +1,182 @@
+// Minimal CBOR (RFC 8949) decoder for the ESP32 telemetry format.
+// Handles the definite-length types the firmware emits plus the rest of
+// the basic set so a malformed body fails with a clear error.
+
+class CborDecoder {
+  constructor(buffer) {
+    this.view = new DataView(buffer.buffer, buffer.byteOffset, buffer.byteLength);
+    this.bytes = buffer;
+    this.offset = 0;
+  }
+
+  need(length) {
+    if (this.offset + length > this.bytes.length) {
+      throw new Error('Unexpected end of CBOR data');
+    }
+  }
+
+  readArgument(info) {
+    if (info < 24) return info;
+
+    let value;
+    switch (info) {
+      case 24: this.need(1); value = this.view.getUint8(this.offset); this.offset += 1; return value;
+      case 25: this.need(2); value = this.view.getUint16(this.offset); this.offset += 2; return value;
+      case 26: this.need(4); value = this.view.getUint32(this.offset); this.offset += 4; return value;
+      case 27: this.need(8); value = Number(this.view.getBigUint64(this.offset)); this.offset += 8; return value;
+      default: throw new Error(`Unsupported CBOR length encoding ${info}`);
+    }
+  }
+
+  decodeHalf(bits) {
+    const exponent = (bits >> 10) & 0x1f;
+    const mantissa = bits & 0x3ff;
+    const sign = bits & 0x8000 ? -1 : 1;
+    if (exponent === 0) return sign * 2 ** -14 * (mantissa / 1024);
+    if (exponent === 31) return mantissa ? NaN : sign * Infinity;
+    return sign * 2 ** (exponent - 15) * (1 + mantissa / 1024);
+  }
+
+  decodeItem() {
+    this.need(1);
+    const initial = this.bytes[this.offset++];
+    const major = initial >> 5;
+    const info = initial & 0x1f;
+
+    switch (major) {
+      case 0: return this.readArgument(info);
+      case 1: return -1 - this.readArgument(info);
+      case 2: {
+        const length = this.readArgument(info);
+        this.need(length);
+        const value = this.bytes.subarray(this.offset, this.offset + length);
+        this.offset += length;
+        return Buffer.from(value);
+      }
+      case 3: {
+        const length = this.readArgument(info);
+        this.need(length);
+        const value = this.bytes.toString('utf8', this.offset, this.offset + length);
+        this.offset += length;
+        return value;
+      }
+      case 4: {
+        const length = this.readArgument(info);
+        const items = [];
+        for (let i = 0; i < length; i++) items.push(this.decodeItem());
+        return items;
+      }
+      case 5: {
+        const length = this.readArgument(info);
+        const map = {};
+        for (let i = 0; i < length; i++) {
+          const key = this.decodeItem();
+          map[key] = this.decodeItem();
+        }
+        return map;
+      }
+      case 6:
+        // Tags carry no meaning for telemetry; return the tagged value
+        this.readArgument(info);
+        return this.decodeItem();
+      case 7: {
+        let value;
+        switch (info) {
+          case 20: return false;
+          case 21: return true;
+          case 22: return null;
+          case 23: return undefined;
+          case 25: this.need(2); value = this.decodeHalf(this.view.getUint16(this.offset)); this.offset += 2; return value;
+          case 26: this.need(4); value = this.view.getFloat32(this.offset); this.offset += 4; return value;
+          case 27: this.need(8); value = this.view.getFloat64(this.offset); this.offset += 8; return value;
+          default: throw new Error(`Unsupported CBOR simple value ${info}`);
+        }
+      }
+    }
+    throw new Error(`Unsupported CBOR major type ${major}`);
+  }
+}
+
+export function decodeCbor(buffer) {
+  const decoder = new CborDecoder(buffer);
+  const value = decoder.decodeItem();
+  if (decoder.offset !== buffer.length) {
+    throw new Error('Trailing bytes after CBOR item');
+  }
+  return value;
+}
+
+// Actuator flag bits, see ACTUATOR_FLAG_* in actuators.h
+const ACTUATOR_FLAG_HUMIDIFIER = 0x01;
+const ACTUATOR_FLAG_FANS = 0x02;
+const ACTUATOR_FLAG_VENTILATING = 0x04;
+const ACTUATOR_FLAG_HEATER = 0x08;
+const ACTUATOR_FLAG_COOLER = 0x10;
+
+// Order of the wear counters under "w", see ActuatorId in actuator_wear.h
+const ACTUATOR_NAMES = ['humidifier', 'exhaust_fan_1', 'exhaust_fan_2', 'inlet_fan', 'heater', 'cooler'];
+
+// float32 values (21.3 → 21.299999) are rounded like the JSON path's %.2f
+const round2 = (value) => (typeof value === 'number' ? Math.round(value * 100) / 100 : value);
+
+// Expands the compact firmware batch ({ v, id, rssi, r: [[...], ...], s: [[...], ...], w: [[...], ...], t: [...] }) into
+// the same shape as the JSON batch so the rest of the server is format agnostic
+export function expandTelemetry(payload) {
+  if (payload?.v !== 1 || !Array.isArray(payload.r)) {
+    throw new Error(`Unsupported telemetry payload version ${payload?.v}`);
+  }
+
+  const fieldSummary = (values) => ({
+    min: round2(values[0]),
+    max: round2(values[1]),
+    mean: round2(values[2]),
+    stddev: round2(values[3])
+  });
+
+  return {
+    device_id: payload.id,
+    wifi_rssi: payload.rssi,
+    actuators: Array.isArray(payload.w)
+      ? Object.fromEntries(payload.w.map(([cycles, onSeconds], i) => [
+          ACTUATOR_NAMES[i] ?? `actuator_${i}`, { cycles, on_seconds: onSeconds }
+        ]))
+      : undefined,
+    control_tick: Array.isArray(payload.t)
+      ? {
+          period_ms: payload.t[0],
+          ticks: payload.t[1],
+          missed: payload.t[2],
+          window_ticks: payload.t[3],
+          max_lateness_us: payload.t[4],
+          p99_lateness_us: payload.t[5]
+        }
+      : undefined,
+    summaries: (payload.s || []).map((summary) => ({
+      epoch: summary[0],
+      timestamp: summary[1],
+      duration_ms: summary[2],
+      samples: summary[3],
+      humidity: fieldSummary(summary.slice(4, 8)),
+      temperature: fieldSummary(summary.slice(8, 12)),
+      pressure: fieldSummary(summary.slice(12, 16)),
+      duty: {
+        humidifier: summary[16] / 100,
+        fans: summary[17] / 100,
+        ventilation: summary[18] / 100
+      }
+    })),
+    readings: payload.r.map(([epoch, timestamp, humidity, temperature, pressure, flags, fanSpeedPct]) => ({
+      timestamp,
+      epoch,
+      humidity: round2(humidity),
+      temperature: round2(temperature),
+      pressure: round2(pressure),
+      humidifier_on: Boolean(flags & ACTUATOR_FLAG_HUMIDIFIER),
+      fans_on: Boolean(flags & ACTUATOR_FLAG_FANS),
+      ventilating: Boolean(flags & ACTUATOR_FLAG_VENTILATING),
+      heater_on: Boolean(flags & ACTUATOR_FLAG_HEATER),
+      cooler_on: Boolean(flags & ACTUATOR_FLAG_COOLER),
+      fan_speed: fanSpeedPct / 100
+    }))
+  };
+}
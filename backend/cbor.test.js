@@ -0,0 +1,57 @@
+import { test } from 'node:test';
+import assert from 'node:assert/strict';
+import { decodeCbor, expandTelemetry } from './cbor.js';
+
+// Byte for byte what the firmware writes for this batch, see
+// test_batch_byte_layout in MushroomChamberController/test/test_telemetry_format
+const FIRMWARE_BATCH = Buffer.from(
+  'a561760162696464646576316472737369383b617281871a6553f1001a0001e240' +
+  'fa42aa8000fa41aa6666f6051828617381931a6553f10019ea6019ea60183c' +
+  'fa42a90000fa42ac0000fa42aa8000fa3f000000fa41aa6666fa41aa6666' +
+  'fa41aa6666fa00000000f6f6f6f6181918320a',
+  'hex'
+);
+
+test('firmware batch expands to the JSON batch shape', () => {
+  const batch = expandTelemetry(decodeCbor(FIRMWARE_BATCH));
+
+  assert.equal(batch.device_id, 'dev1');
+  assert.equal(batch.wifi_rssi, -60);
+  assert.equal(batch.actuators, undefined);
+  assert.equal(batch.control_tick, undefined);
+
+  assert.deepEqual(batch.readings, [{
+    timestamp: 123456,
+    epoch: 1700000000,
+    humidity: 85.25,
+    temperature: 21.3,         // float32 21.299999 rounded back
+    pressure: null,            // NaN on the device
+    humidifier_on: true,
+    fans_on: false,
+    ventilating: true,
+    heater_on: false,
+    cooler_on: false,
+    fan_speed: 0.4
+  }]);
+
+  assert.deepEqual(batch.summaries, [{
+    epoch: 1700000000,
+    timestamp: 60000,
+    duration_ms: 60000,
+    samples: 60,
+    humidity: { min: 84.5, max: 86, mean: 85.25, stddev: 0.5 },
+    temperature: { min: 21.3, max: 21.3, mean: 21.3, stddev: 0 },
+    pressure: { min: null, max: null, mean: null, stddev: null },
+    duty: { humidifier: 0.25, fans: 0.5, ventilation: 0.1 }
+  }]);
+});
+
+test('truncated batch is rejected', () => {
+  assert.throws(() => decodeCbor(FIRMWARE_BATCH.subarray(0, FIRMWARE_BATCH.length - 1)),
+                /Unexpected end of CBOR data/);
+});
+
+test('unknown payload version is rejected', () => {
+  const batch = decodeCbor(FIRMWARE_BATCH);
+  assert.throws(() => expandTelemetry({ ...batch, v: 2 }), /Unsupported telemetry payload version 2/);
+});
@@ -2,6 +2,7 @@ import express from "express";
 import cors from "cors";
 import path from "path";
 import { fileURLToPath } from "url";
+import { decodeCbor, expandTelemetry } from "./cbor.js";
 
 const __filename = fileURLToPath(import.meta.url);
 const __dirname = path.dirname(__filename);
@@ -12,6 +13,20 @@ const PORT = 3001;
 // ====== Config ======
 const phaseConfigs = ["Incubation", "Primordia", "Fruiting"];
 let currentPhase = phaseConfigs[0]; // Default phase
+// Bumped on every phase/config change. Starts at the boot time in seconds,
+// so a restarted server never hands out a version older than a device has.
+let configVersion = Math.floor(Date.now() / 1000);
+let reportIntervalMs = 20000;        // How often the ESP32 should sync
+let rawSamplesUntil = 0;             // Raw readings wanted until this time (ms), summaries otherwise
+let autotunePending = false;         // Relay autotune asked for, not yet handed to a device
+const controlModes = ["BANG_BANG", "PID"];
+let controlMode = controlModes[0];   // Humidity control; PID switches the humidifier far more often
+const ventilationStyles = ["BURST", "CONTINUOUS"];
+let ventilationStyle = ventilationStyles[0];   // Full-speed bursts, or a gentle continuous exchange
+// Fan pattern per phase; AUTO lets the device learn the one that exchanges
+// the most air per fan-second
+const ventilationModeNames = ["BALANCED", "EXHAUST_ONLY", "INLET_ONLY", "AUTO"];
+const ventilationModes = Object.fromEntries(phaseConfigs.map((phase) => [phase, "BALANCED"]));
 
 // ====== Data Storage ======
 // In-memory storage for sensor data (consider using a database for production)
@@ -28,12 +43,37 @@ let latestSensorData = {
 let sensorHistory = [];
 const MAX_HISTORY_SIZE = 100;
 
+// Lifetime actuator counters ({ humidifier: { cycles, on_seconds }, ... }) from the last batch
+let actuatorWear = null;
+
+// Control step jitter ({ period_ms, ticks, missed, max_lateness_us, p99_lateness_us, ... }) from the last batch
+let controlTick = null;
+
+// Per-window summaries from the device (last 24 h at one per minute)
+let summaryHistory = [];
+const MAX_SUMMARY_HISTORY_SIZE = 1440;
+
 // ====== Middleware ======
 app.use(cors({
   origin: 'http://localhost:5173', // Only needed during local dev
   credentials: true,
 }));
 app.use(express.json());
+app.use(express.raw({ type: 'application/cbor', limit: '64kb' }));
+
+// Binary uploads are decoded to the JSON batch shape before any route sees them
+app.use((req, res, next) => {
+  if (req.method !== 'POST' || !req.is('application/cbor')) {
+    return next();
+  }
+  try {
+    req.body = expandTelemetry(decodeCbor(req.body));
+    next();
+  } catch (error) {
+    console.error('Invalid CBOR payload:', error.message);
+    res.status(400).json({ error: 'Invalid CBOR payload' });
+  }
+});
 
 // Log all requests (handy for debugging)
 app.use((req, res, next) => {
@@ -44,51 +84,179 @@ app.use((req, res, next) => {
   next();
 });
 
+// ====== Device Config Push ======
+// Devices keep GET /api/phase/watch open (long-poll). It is answered as soon as
+// configVersion moves past the version the device already has, or with 304
+// once wait_ms passes, so changes reach the chamber within a second.
+const phaseWatchers = new Set();
+const MAX_WATCH_WAIT_MS = 28000;   // Stay below server.keepAliveTimeout
+
+// Everything a device needs to follow the current grow
+function deviceConfig() {
+  return {
+    phase: currentPhase,
+    config_version: configVersion,
+    report_interval_ms: reportIntervalMs,
+    raw_samples: Date.now() < rawSamplesUntil,
+    autotune: autotunePending,
+    control_mode: controlMode,
+    ventilation_style: ventilationStyle,
+    ventilation_mode: ventilationModes[currentPhase]
+  };
+}
+
+// The config as sent to a device. An autotune request is a one-shot
+// command, so only the first reply carries it.
+function takeDeviceConfig() {
+  const config = deviceConfig();
+  autotunePending = false;
+  return config;
+}
+
+function configChanged() {
+  configVersion++;
+  if (phaseWatchers.size === 0) {
+    return;
+  }
+  const config = takeDeviceConfig();
+  for (const watcher of phaseWatchers) {
+    clearTimeout(watcher.timer);
+    watcher.res.set('ETag', `"${configVersion}"`).json(config);
+  }
+  console.log(`📨 Pushed config version ${configVersion} to ${phaseWatchers.size} device(s)`);
+  phaseWatchers.clear();
+}
+
 // ====== API Routes ======
 
-// POST endpoint to receive sensor data from ESP32
-app.post("/api/sensor-data", (req, res) => {
-  try {
-    const { timestamp, device_id, humidity, temperature, pressure, wifi_rssi } = req.body;
-    
-    // Validate required fields
-    if (humidity === undefined || temperature === undefined || pressure === undefined) {
-      return res.status(400).json({ 
-        error: 'Missing required sensor data (humidity, temperature, pressure)' 
+// Validate and store one reading; returns an error message or null
+function storeSensorReading(body) {
+  const { timestamp, epoch, device_id, humidity, temperature, pressure, wifi_rssi,
+          humidifier_on, fans_on, ventilating, heater_on, cooler_on, fan_speed } = body;
+
+  // Validate required fields
+  if (humidity === undefined || temperature === undefined || pressure === undefined) {
+    return 'Missing required sensor data (humidity, temperature, pressure)';
+  }
+
+  // Spooled readings carry the time they were taken; live ones are "now"
+  const takenAt = epoch > 0 ? new Date(epoch * 1000) : new Date();
+
+  const reading = {
+    humidity: parseFloat(humidity),
+    temperature: parseFloat(temperature),
+    pressure: parseFloat(pressure),
+    timestamp: takenAt.toISOString(),
+    device_id: device_id || 'unknown',
+    wifi_rssi: wifi_rssi || null
+  };
+
+  // Actuator state only arrives with binary uploads
+  if (humidifier_on !== undefined) {
+    reading.actuators = { humidifier_on, fans_on, ventilating, heater_on, cooler_on, fan_speed };
+  }
+
+  // Update latest sensor data, unless this is an older spooled reading
+  if (!latestSensorData.timestamp || takenAt >= new Date(latestSensorData.timestamp)) {
+    latestSensorData = reading;
+  }
+
+  // Add to history
+  sensorHistory.push({
+    ...reading,
+    received_at: new Date().toISOString()
+  });
+
+  // Keep only the last MAX_HISTORY_SIZE entries
+  if (sensorHistory.length > MAX_HISTORY_SIZE) {
+    sensorHistory = sensorHistory.slice(-MAX_HISTORY_SIZE);
+  }
+  return null;
+}
+
+// Store one window summary ({ epoch, duration_ms, samples, humidity: { min, max, mean, stddev }, ... })
+function storeSummary(summary, device_id) {
+  if (!summary || !Number.isFinite(summary.samples)) {
+    return false;
+  }
+
+  const startedAt = summary.epoch > 0 ? new Date(summary.epoch * 1000) : new Date(Date.now() - summary.duration_ms);
+  summaryHistory.push({
+    start: startedAt.toISOString(),
+    duration_ms: summary.duration_ms,
+    samples: summary.samples,
+    humidity: summary.humidity,
+    temperature: summary.temperature,
+    pressure: summary.pressure,
+    duty: summary.duty,
+    device_id: device_id || 'unknown',
+    received_at: new Date().toISOString()
+  });
+
+  if (summaryHistory.length > MAX_SUMMARY_HISTORY_SIZE) {
+    summaryHistory = summaryHistory.slice(-MAX_SUMMARY_HISTORY_SIZE);
+  }
+  return true;
+}
+
+// Accept either one reading or a batch ({ device_id, wifi_rssi, readings: [...], summaries: [...], actuators: {...},
+// control_tick: {...} }).
+// Returns { accepted, error }; invalid readings inside a batch are skipped so
+// one bad sample can never block the device's spool.
+function storeSensorPayload(body) {
+  if (body.actuators && typeof body.actuators === 'object') {
+    actuatorWear = body.actuators;
+  }
+  if (body.control_tick && typeof body.control_tick === 'object') {
+    controlTick = body.control_tick;
+  }
+
+  if (Array.isArray(body.summaries)) {
+    const stored = body.summaries.filter((summary) => storeSummary(summary, body.device_id)).length;
+    console.log(`📈 Received ${body.summaries.length} window summaries from ${body.device_id} (${stored} stored)`);
+  }
+
+  if (!Array.isArray(body.readings)) {
+    const error = storeSensorReading(body);
+    if (!error) {
+      console.log(`📊 Received sensor data from ${body.device_id}:`, {
+        humidity: `${body.humidity}%`,
+        temperature: `${body.temperature}°C`,
+        pressure: `${body.pressure} hPa`,
+        rssi: `${body.wifi_rssi} dBm`
       });
     }
-    
-    // Update latest sensor data
-    latestSensorData = {
-      humidity: parseFloat(humidity),
-      temperature: parseFloat(temperature),
-      pressure: parseFloat(pressure),
-      timestamp: new Date().toISOString(),
-      device_id: device_id || 'unknown',
-      wifi_rssi: wifi_rssi || null
-    };
-    
-    // Add to history
-    sensorHistory.push({
-      ...latestSensorData,
-      received_at: new Date().toISOString()
+    return { accepted: error ? 0 : 1, error };
+  }
+
+  let accepted = 0;
+  for (const reading of body.readings) {
+    const error = storeSensorReading({
+      ...reading,
+      device_id: body.device_id,
+      wifi_rssi: body.wifi_rssi
     });
-    
-    // Keep only the last MAX_HISTORY_SIZE entries
-    if (sensorHistory.length > MAX_HISTORY_SIZE) {
-      sensorHistory = sensorHistory.slice(-MAX_HISTORY_SIZE);
+    if (!error) {
+      accepted++;
+    }
+  }
+
+  console.log(`📦 Received batch of ${body.readings.length} readings from ${body.device_id} (${accepted} stored)`);
+  return { accepted, error: null };
+}
+
+// POST endpoint to receive sensor data from ESP32
+app.post("/api/sensor-data", (req, res) => {
+  try {
+    const { accepted, error } = storeSensorPayload(req.body);
+    if (error) {
+      return res.status(400).json({ error });
     }
-    
-    console.log(`📊 Received sensor data from ${device_id}:`, {
-      humidity: `${humidity}%`,
-      temperature: `${temperature}°C`,
-      pressure: `${pressure} hPa`,
-      rssi: `${wifi_rssi} dBm`
-    });
     
     res.json({ 
       success: true, 
       message: 'Sensor data received successfully',
+      accepted,
       timestamp: latestSensorData.timestamp
     });
     
@@ -98,6 +266,26 @@ app.post("/api/sensor-data", (req, res) => {
   }
 });
 
+// POST endpoint combining upload and phase poll in one round trip:
+// the ESP32 sends a reading and gets phase, config version and interval back
+app.post("/api/sync", (req, res) => {
+  try {
+    const { accepted, error } = storeSensorPayload(req.body);
+    if (error) {
+      return res.status(400).json({ error });
+    }
+
+    res.json({
+      accepted,
+      ...takeDeviceConfig()
+    });
+
+  } catch (error) {
+    console.error('Error processing sync:', error);
+    res.status(500).json({ error: 'Internal server error' });
+  }
+});
+
 // GET endpoint to retrieve latest sensor data for frontend
 app.get("/api/data", (req, res) => {
   if (!latestSensorData.timestamp) {
@@ -151,6 +339,8 @@ app.get("/api/status", (req, res) => {
     last_data_received: lastDataTime ? new Date(lastDataTime).toISOString() : null,
     device_id: latestSensorData.device_id,
     wifi_rssi: latestSensorData.wifi_rssi,
+    actuator_wear: actuatorWear,
+    control_tick: controlTick,
     data_points_stored: sensorHistory.length
   });
 });
@@ -163,16 +353,168 @@ app.get('/api/phase', (req, res) => {
   res.json({ phase: currentPhase });
 });
 
+// Long-poll: ?version=N (or If-None-Match: "N") and optional ?wait_ms=
+app.get('/api/phase/watch', (req, res) => {
+  const etag = (req.get('If-None-Match') || '').replace(/"/g, '');
+  const knownVersion = parseInt(req.query.version ?? etag);
+  const waitMs = Math.min(Math.max(parseInt(req.query.wait_ms) || 25000, 1000), MAX_WATCH_WAIT_MS);
+
+  if (knownVersion !== configVersion) {
+    return res.set('ETag', `"${configVersion}"`).json(takeDeviceConfig());
+  }
+
+  const watcher = { res };
+  watcher.timer = setTimeout(() => {
+    phaseWatchers.delete(watcher);
+    res.set('ETag', `"${configVersion}"`).status(304).end();
+  }, waitMs);
+  phaseWatchers.add(watcher);
+
+  // Device went away (WiFi drop, reboot) before anything changed
+  res.on('close', () => {
+    clearTimeout(watcher.timer);
+    phaseWatchers.delete(watcher);
+  });
+});
+
 app.post('/api/phase', (req, res) => {
   const { phase } = req.body;
   if (!phaseConfigs.includes(phase)) {
     return res.status(400).json({ error: 'Invalid phase name' });
   }
   currentPhase = phase;
+  configChanged();
   console.log(`🔄 Phase changed to: ${currentPhase}`);
   res.json({ success: true });
 });
 
+app.get('/api/report-interval', (req, res) => {
+  res.json({ interval_ms: reportIntervalMs });
+});
+
+app.post('/api/report-interval', (req, res) => {
+  const interval = parseInt(req.body.interval_ms);
+  if (!Number.isFinite(interval) || interval < 1000) {
+    return res.status(400).json({ error: 'interval_ms must be at least 1000' });
+  }
+  reportIntervalMs = interval;
+  configChanged();
+  console.log(`⏱️ Report interval changed to: ${reportIntervalMs} ms`);
+  res.json({ success: true });
+});
+
+app.get('/api/control-mode', (req, res) => {
+  res.json({ mode: controlMode, modes: controlModes });
+});
+
+app.post('/api/control-mode', (req, res) => {
+  const { mode } = req.body;
+  if (!controlModes.includes(mode)) {
+    return res.status(400).json({ error: `mode must be one of ${controlModes.join(', ')}` });
+  }
+  controlMode = mode;
+  configChanged();
+  console.log(`🎛️ Control mode changed to: ${controlMode}`);
+  res.json({ success: true });
+});
+
+app.get('/api/ventilation-style', (req, res) => {
+  res.json({ style: ventilationStyle, styles: ventilationStyles });
+});
+
+app.post('/api/ventilation-style', (req, res) => {
+  const { style } = req.body;
+  if (!ventilationStyles.includes(style)) {
+    return res.status(400).json({ error: `style must be one of ${ventilationStyles.join(', ')}` });
+  }
+  ventilationStyle = style;
+  configChanged();
+  console.log(`🌬️ Ventilation style changed to: ${ventilationStyle}`);
+  res.json({ success: true });
+});
+
+app.get('/api/ventilation-mode', (req, res) => {
+  res.json({ modes: ventilationModes, choices: ventilationModeNames });
+});
+
+// { mode, phase } sets one phase; without phase it sets the current one
+app.post('/api/ventilation-mode', (req, res) => {
+  const { mode, phase = currentPhase } = req.body;
+  if (!phaseConfigs.includes(phase)) {
+    return res.status(400).json({ error: 'Invalid phase name' });
+  }
+  if (!ventilationModeNames.includes(mode)) {
+    return res.status(400).json({ error: `mode must be one of ${ventilationModeNames.join(', ')}` });
+  }
+  ventilationModes[phase] = mode;
+  configChanged();
+  console.log(`🌬️ Ventilation mode for ${phase} changed to: ${mode}`);
+  res.json({ success: true });
+});
+
+// Run the relay autotune on the device for its current phase. It takes the
+// chamber through a few humidity cycles; the results are kept per phase.
+app.get('/api/autotune', (req, res) => {
+  res.json({ pending: autotunePending });
+});
+
+app.post('/api/autotune', (req, res) => {
+  autotunePending = true;
+  configChanged();
+  console.log('🎯 Autotune requested');
+  res.json({ success: true });
+});
+
+// GET window summaries (min/max/mean/stddev and duty cycle per window)
+app.get('/api/summaries', (req, res) => {
+  const limit = parseInt(req.query.limit) || 60;
+  res.json({
+    data: summaryHistory.slice(-limit),
+    total: summaryHistory.length
+  });
+});
+
+// Ask the device for raw readings for a while (e.g. while debugging a chamber);
+// it falls back to summaries only once the duration has passed
+app.get('/api/raw-samples', (req, res) => {
+  res.json({ enabled: Date.now() < rawSamplesUntil, until: rawSamplesUntil || null });
+});
+
+// The end of the window changes raw_samples too, so it is pushed like any
+// other config change. Long windows are re-armed in steps below the
+// setTimeout limit.
+const MAX_TIMER_MS = 2 ** 31 - 1;
+let rawSamplesTimer = null;
+
+function scheduleRawSamplesExpiry() {
+  clearTimeout(rawSamplesTimer);
+  rawSamplesTimer = null;
+  const remainingMs = rawSamplesUntil - Date.now();
+  if (remainingMs <= 0) {
+    return;
+  }
+  rawSamplesTimer = setTimeout(() => {
+    if (Date.now() < rawSamplesUntil) {
+      return scheduleRawSamplesExpiry();
+    }
+    rawSamplesTimer = null;
+    configChanged();
+    console.log('🔬 Raw samples window ended');
+  }, Math.min(remainingMs, MAX_TIMER_MS));
+}
+
+app.post('/api/raw-samples', (req, res) => {
+  const durationS = parseInt(req.body.duration_s);
+  if (!Number.isFinite(durationS) || durationS < 0) {
+    return res.status(400).json({ error: 'duration_s must be a non-negative number' });
+  }
+  rawSamplesUntil = durationS > 0 ? Date.now() + durationS * 1000 : 0;
+  scheduleRawSamplesExpiry();
+  configChanged();
+  console.log(durationS > 0 ? `🔬 Raw samples requested for ${durationS} s` : '🔬 Raw samples disabled');
+  res.json({ success: true, until: rawSamplesUntil || null });
+});
+
 // ====== Git Update Endpoint ======
 import { exec } from 'child_process';
 import { promisify } from 'util';
@@ -302,8 +644,13 @@ app.get(/^(?!\/api).*/, (req, res) => {
 });
 
 // ====== Start Server ======
-app.listen(PORT, "0.0.0.0", () => {
+const server = app.listen(PORT, "0.0.0.0", () => {
   console.log(`✅ Server running at http://localhost:${PORT}`);
   console.log(`📡 ESP32 should POST sensor data to: http://localhost:${PORT}/api/sensor-data`);
   console.log(`🌐 Frontend available at: http://localhost:${PORT}`);
-});
\ No newline at end of file
+});
+
+// The ESP32 keeps one connection open between uploads; hold it longer than
+// its 25 s idle close so the server never drops it mid-request
+server.keepAliveTimeout = 30000;
+server.headersTimeout = 31000;
\ No newline at end of file